@@ -0,0 +1,533 @@
+/*******************************************************************
+ * @file GUIBenchmark.cpp
+ * @brief Measures the cost of the interfaces with thousands of texts, sprites, sliders and MQBs.
+ *		  Also measures the first screen shown with a font, with and without the glyph cache, and a
+ *		  cold start loading 400 textures one by one, or preloaded in parallel, and sprites drawn
+ *		  downscaled, with and without mipmaps. The widget textures are rasterized on the CPU, and the
+ *		  textures generated from shapes are drawn one by one or batched into an atlas. The frames of
+ *		  several interfaces are prepared on 1 to 16 threads.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note Everything is rendered offscreen, into an sf::RenderTexture: no window is opened. On a
+ *		 headless Linux box, run it under a virtual display (software GL is fine):
+ *		 `xvfb-run ./GUIBenchmark`.
+ * @note Run it from the bin folder, as the game: the default font is loaded from ../assets/, and
+ *		 the textures of the cold start are written there, in __benchmark, then removed.
+ *		 The results are also written as JSON, in the file given as first argument
+ *		 (gui_benchmark.json by default), to be compared between two versions.
+ *********************************************************************/
+
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "GUI.hpp"
+
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr sf::Vector2u targetSize{ 1920, 1080 };
+constexpr size_t hoverPositions{ 1'024 }; // Cursor positions tried per hit-testing iteration.
+constexpr size_t dragSteps{ 512 }; // Cursor positions per slider drag.
+constexpr size_t typedCharacters{ 64 }; // Typed, then erased, per text entry.
+constexpr std::string_view textureName{ "__benchmark" };
+
+/// A scenario, as written in the JSON output.
+struct Result
+{
+	std::string name;
+	size_t elements;
+	size_t iterations;
+	size_t operations; // Per iteration.
+	double mean; // In microseconds, per iteration.
+	double median;
+	double percentile99;
+};
+
+std::vector<Result> results{};
+
+/// Runs a scenario, then prints its latency per iteration (mean, median, 99th percentile) and its
+/// mean cost per operation. Prepare is called before each iteration, and is not measured.
+template<typename Prepare, typename Scenario>
+void benchmark(std::string const& name, size_t elements, size_t operations, Prepare&& prepare, Scenario&& scenario)
+{
+	size_t const iterations{ std::clamp<size_t>(200'000 / std::max<size_t>(elements, 1), 10, 200) };
+	std::vector<double> latencies(iterations);
+
+	for (auto& latency : latencies)
+	{
+		prepare();
+		Clock::time_point const start{ Clock::now() };
+		scenario();
+		latency = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+	}
+
+	double total{ 0. };
+	for (double latency : latencies)
+		total += latency;
+
+	std::sort(latencies.begin(), latencies.end());
+	Result const result{ name, elements, iterations, operations, total / static_cast<double>(iterations), latencies[iterations / 2], latencies[std::min(iterations - 1, iterations * 99 / 100)] };
+	results.push_back(result);
+
+	std::cout << std::fixed << std::setprecision(2)
+			  << std::left << std::setw(30) << name << std::right
+			  << std::setw(10) << elements
+			  << std::setw(14) << result.mean
+			  << std::setw(14) << result.median
+			  << std::setw(14) << result.percentile99
+			  << std::setw(14) << result.mean * 1'000. / static_cast<double>(std::max<size_t>(operations, 1)) << '\n';
+}
+
+template<typename Scenario>
+void benchmark(std::string const& name, size_t elements, size_t operations, Scenario&& scenario)
+{
+	benchmark(name, elements, operations, []() {}, std::forward<Scenario>(scenario));
+}
+
+/// Writes the results for regression tracking.
+bool writeJson(std::string const& fileName)
+{
+	std::ofstream file{ fileName, std::ios::trunc };
+	file << std::fixed << std::setprecision(3) << "{\n\t\"benchmark\": \"GUIBenchmark\",\n\t\"results\": [";
+
+	for (size_t i{ 0 }; i < results.size(); ++i)
+	{
+		Result const& result{ results[i] };
+		file << ((i == 0) ? "\n" : ",\n")
+			 << "\t\t{ \"name\": \"" << result.name << "\", \"elements\": " << result.elements
+			 << ", \"iterations\": " << result.iterations << ", \"operations\": " << result.operations
+			 << ", \"mean_us\": " << result.mean << ", \"p50_us\": " << result.median << ", \"p99_us\": " << result.percentile99
+			 << ", \"ns_per_operation\": " << result.mean * 1'000. / static_cast<double>(std::max<size_t>(result.operations, 1)) << " }";
+	}
+
+	file << "\n\t]\n}\n";
+	return static_cast<bool>(file);
+}
+
+/// Spreads the elements over the whole target.
+sf::Vector2f positionOf(size_t index)
+{
+	return sf::Vector2f{ static_cast<float>(20 + index * 37 % (targetSize.x - 40)), static_cast<float>(20 + index * 91 % (targetSize.y - 40)) };
+}
+
+/// Adds texts and sprites, all interactive.
+void populate(AGUI& gui, std::vector<std::string> const& identifiers)
+{
+	for (size_t i{ 0 }; i < identifiers.size(); ++i)
+	{
+		gui.addDynamicText(identifiers[i], identifiers[i], positionOf(i), 20);
+		gui.addDynamicSprite(identifiers[i], textureName, positionOf(i * 7 + 3));
+		gui.addInteractive(identifiers[i]);
+	}
+}
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+	std::string const jsonName{ (argc > 1) ? argv[1] : "gui_benchmark.json" };
+
+	sf::RenderTexture target{};
+	if (!target.resize(targetSize))
+	{
+		std::cout << "The render texture could not be created: is there a display, even a virtual one?\n";
+		return 1;
+	}
+
+	try
+	{
+		sf::Texture texture{ sf::Image{ sf::Vector2u{ 32, 32 }, sf::Color{ 200, 80, 80 } } };
+		gui::SpriteWrapper::createTexture(std::string{ textureName }, std::move(texture), gui::SpriteWrapper::Reserved::No);
+
+		std::mt19937 random{ 42 }; // Same positions every run.
+		std::uniform_real_distribution<float> x{ 0.f, static_cast<float>(targetSize.x) }, y{ 0.f, static_cast<float>(targetSize.y) };
+		std::vector<sf::Vector2f> cursors(hoverPositions);
+		for (auto& cursor : cursors)
+			cursor = sf::Vector2f{ x(random), y(random) };
+
+		std::cout << std::left << std::setw(30) << "scenario" << std::right
+				  << std::setw(10) << "elements"
+				  << std::setw(14) << "mean us"
+				  << std::setw(14) << "p50 us"
+				  << std::setw(14) << "p99 us"
+				  << std::setw(14) << "ns / op" << '\n';
+
+		for (size_t const elements : { size_t{ 100 }, size_t{ 1'000 }, size_t{ 10'000 } })
+		{
+			std::vector<std::string> identifiers(elements);
+			for (size_t i{ 0 }; i < elements; ++i)
+				identifiers[i] = "element" + std::to_string(i);
+
+			std::vector<std::string> shuffled{ identifiers };
+			std::shuffle(shuffled.begin(), shuffled.end(), random);
+
+			std::optional<AGUI> gui{};
+
+			benchmark("addDynamicText", elements, elements, [&]() { gui.reset(); gui.emplace(&target); }, [&]()
+			{
+				for (size_t i{ 0 }; i < elements; ++i)
+					gui->addDynamicText(identifiers[i], identifiers[i], positionOf(i), 20);
+			});
+
+			benchmark("removeDynamicText", elements, elements, [&]()
+			{
+				gui.reset();
+				gui.emplace(&target);
+				for (size_t i{ 0 }; i < elements; ++i)
+					gui->addDynamicText(identifiers[i], identifiers[i], positionOf(i), 20);
+			}, [&]()
+			{
+				for (auto const& identifier : shuffled)
+					gui->removeDynamicText(identifier);
+			});
+
+			benchmark("addDynamicSprite", elements, elements, [&]() { gui.reset(); gui.emplace(&target); }, [&]()
+			{
+				for (size_t i{ 0 }; i < elements; ++i)
+					gui->addDynamicSprite(identifiers[i], textureName, positionOf(i));
+			});
+
+			benchmark("removeDynamicSprite", elements, elements, [&]()
+			{
+				gui.reset();
+				gui.emplace(&target);
+				for (size_t i{ 0 }; i < elements; ++i)
+					gui->addDynamicSprite(identifiers[i], textureName, positionOf(i));
+			}, [&]()
+			{
+				for (auto const& identifier : shuffled)
+					gui->removeDynamicSprite(identifier);
+			});
+
+			// The other scenarios share one interface: texts and sprites, all interactive.
+			gui.reset();
+			gui.emplace(&target);
+			populate(*gui, identifiers);
+
+			benchmark("getDynamicText", elements, elements, [&]()
+			{
+				size_t found{ 0 };
+				for (auto const& identifier : shuffled)
+					found += (gui->getDynamicText(identifier) != nullptr);
+
+				static_cast<void>(found);
+			});
+
+			benchmark("eventUpdateHovered", elements, hoverPositions, [&]()
+			{
+				for (sf::Vector2f const cursor : cursors)
+					static_cast<void>(IGUI::eventUpdateHovered(&*gui, cursor));
+			});
+
+			benchmark("textEntered", elements, 2 * typedCharacters, [&]() { gui->setWritingText(identifiers[0]); }, [&]()
+			{
+				for (size_t i{ 0 }; i < typedCharacters; ++i)
+					IGUI::textEntered(&*gui, U'a' + static_cast<char32_t>(i % 26));
+
+				for (size_t i{ 0 }; i < typedCharacters; ++i)
+					IGUI::textEntered(&*gui, U'\b');
+			});
+			gui->setWritingText("");
+
+			// Other threads update every text several times per frame: the frame applies the last updates.
+			constexpr size_t producers{ 4 };
+			benchmark("applyCommands", elements, producers * elements, [&]()
+			{
+				std::vector<std::jthread> threads{};
+				for (size_t producer{ 0 }; producer < producers; ++producer)
+					threads.emplace_back([&gui, &identifiers, producer]()
+					{
+						for (auto const& identifier : identifiers)
+							gui->getCommandQueue().setContent(identifier, producer);
+					});
+			}, [&]() { static_cast<void>(gui->applyCommands()); });
+
+			benchmark("targetResized", elements, 2, [&]()
+			{	// Shrinks then restores: the elements end as they began.
+				BGUI::targetResized(&target, targetSize, sf::Vector2u{ 1280, 720 });
+				BGUI::targetResized(&target, sf::Vector2u{ 1280, 720 }, targetSize);
+			});
+
+			benchmark("draw", elements, 2 * elements, [&]()
+			{
+				target.clear();
+				gui->draw();
+				target.display();
+			});
+
+			// Sliders (3 elements) and MQBs (5 boxes) are made of several elements: fewer of them.
+			size_t const widgets{ std::max<size_t>(elements / 10, 1) };
+
+			gui.reset();
+			gui.emplace(&target);
+			for (size_t i{ 0 }; i < widgets; ++i)
+			{
+				gui->addSlider(identifiers[i], positionOf(i * 13));
+				gui->addMQB(identifiers[i] + "mqb", positionOf(i * 13 + 5), sf::Vector2f{ 0, 30 }, 5);
+			}
+
+			benchmark("slider drag", widgets, dragSteps, [&]() { static_cast<void>(IGUI::eventUpdateHovered(&*gui, positionOf(0))); }, [&]()
+			{	// The cursor goes from the top to the bottom of the slider, and beyond.
+				for (size_t i{ 0 }; i < dragSteps; ++i)
+					static_cast<void>(AGUI::pressed(&*gui, sf::Vector2f{ positionOf(0).x, positionOf(0).y - 200.f + static_cast<float>(i) * 400.f / dragSteps }));
+			});
+
+			benchmark("MQB pressed", widgets, hoverPositions, [&]()
+			{
+				for (size_t i{ 0 }; i < hoverPositions; ++i)
+				{
+					static_cast<void>(IGUI::eventUpdateHovered(&*gui, positionOf((i % widgets) * 13 + 5)));
+					static_cast<void>(IGUI::eventPressed(&*gui));
+				}
+			});
+
+			benchmark("draw widgets", widgets, widgets * 8, [&]()
+			{
+				target.clear();
+				gui->draw();
+				target.display();
+			});
+		}
+
+		// Several interfaces full of sprites: their vertices are prepared on 1 to 16 threads, then
+		// submitted by this one.
+		{
+			constexpr size_t interfaceCount{ 8 };
+			constexpr size_t spritesPerInterface{ 4'000 };
+			std::vector<std::optional<BGUI>> interfaces(interfaceCount);
+			for (size_t i{ 0 }; i < interfaceCount; ++i)
+			{
+				interfaces[i].emplace(&target);
+				for (size_t j{ 0 }; j < spritesPerInterface; ++j)
+					interfaces[i]->addSprite(textureName, positionOf(i * spritesPerInterface + j), sf::Vector2f{ 1.f, 1.f }, sf::IntRect{}, sf::degrees(static_cast<float>(j % 90)));
+			}
+
+			for (unsigned int const threads : { 1u, 2u, 4u, 8u, 16u })
+			{
+				benchmark("prepareFrame, " + std::to_string(threads) + " threads", interfaceCount * spritesPerInterface, interfaceCount * spritesPerInterface, [&]()
+				{
+					BGUI::prepareFrame(&target, threads);
+				});
+			}
+
+			benchmark("draw, prepared", interfaceCount * spritesPerInterface, interfaceCount * spritesPerInterface, [&]() { BGUI::prepareFrame(&target); }, [&]()
+			{
+				target.clear();
+				for (auto const& curInterface : interfaces)
+					curInterface->draw();
+				target.display();
+			});
+
+			benchmark("draw, not prepared", interfaceCount * spritesPerInterface, interfaceCount * spritesPerInterface, [&]()
+			{
+				target.clear();
+				for (auto const& curInterface : interfaces)
+					curInterface->draw();
+				target.display();
+			});
+		}
+
+		// The widget textures, drawn on the CPU: a large rounded check box, and the default MQB box.
+		benchmark("WidgetRasterizer 256 rounded", 1, 256 * 256, []()
+		{
+			static_cast<void>(gui::WidgetRasterizer::rasterize(gui::WidgetRasterizer::Style{ .size{ 256, 256 }, .outlineThickness = 8, .cornerRadius = 32, .checkMark = true }));
+		});
+		benchmark("WidgetRasterizer 25 box", 1, 25 * 25, []()
+		{
+			static_cast<void>(gui::WidgetRasterizer::rasterize(gui::WidgetRasterizer::Style{ .size{ 25, 25 }, .outlineThickness = 3, .checkMark = true }));
+		});
+
+		// Textures generated from shapes of various sizes: a render texture and a texture each, or
+		// one atlas for them all.
+		constexpr size_t generatedTextures{ 100 };
+		std::vector<sf::RectangleShape> shapes{};
+		for (size_t i{ 0 }; i < generatedTextures; ++i)
+		{
+			shapes.emplace_back(sf::Vector2f{ static_cast<float>(20 + i % 13 * 7), static_cast<float>(20 + i % 7 * 11) });
+			shapes.back().setFillColor(sf::Color{ 80, 80, 200 });
+			shapes.back().setOutlineThickness(-2.f);
+		}
+
+		std::vector<sf::Texture> generated(generatedTextures);
+		benchmark("createTextureFromDrawables", generatedTextures, generatedTextures, [&]()
+		{
+			for (size_t i{ 0 }; i < generatedTextures; ++i)
+				generated[i] = gui::createTextureFromDrawables(sf::RectangleShape{ shapes[i] });
+		});
+		generated.clear();
+
+		benchmark("TextureBatch::build", generatedTextures, generatedTextures, []() { gui::SpriteWrapper::removeTexture("__batch"); }, [&]()
+		{
+			gui::TextureBatch batch{};
+			for (auto const& shape : shapes)
+				static_cast<void>(batch.add(shape));
+
+			static_cast<void>(batch.build("__batch"));
+		});
+		gui::SpriteWrapper::removeTexture("__batch");
+
+		// The first screen shown with a font: each glyph is rasterized when a content is set, unless
+		// the glyph cache did it before.
+		std::string printable{};
+		for (char character{ ' ' }; character <= '~'; ++character)
+			printable.push_back(character);
+
+		constexpr unsigned int sizes{ 16 }; // One text per size, from 16 to 46.
+		for (unsigned int i{ 0 }; i < sizes; ++i)
+			gui::GlyphCache::declare("glyphs", 16 + 2 * i, std::u32string(printable.begin(), printable.end()));
+
+		std::optional<AGUI> screen{};
+		auto const freshFont{ [&]()
+		{
+			screen.reset(); // Its texts use the font.
+			gui::TextWrapper::removeFont("glyphs");
+
+			// Opened on its own: from the file, it would share the glyphs of the default font.
+			std::ostringstream fontErrorMessage{};
+			auto font{ gui::loadFontFromFile(fontErrorMessage, "defaultFont.ttf") };
+			if (!font.has_value())
+				throw std::runtime_error{ fontErrorMessage.str() };
+
+			gui::TextWrapper::createFont("glyphs", std::move(*font));
+		} };
+
+		auto const firstScreen{ [&]()
+		{
+			screen.emplace(&target);
+			for (unsigned int i{ 0 }; i < sizes; ++i)
+				screen->addText(printable, positionOf(i), 16 + 2 * i, sf::Color::White, "glyphs");
+
+			target.clear();
+			screen->draw();
+			target.display();
+		} };
+
+		benchmark("first screen, cold glyphs", sizes, sizes, freshFont, firstScreen);
+		benchmark("GlyphCache::prewarm", sizes, sizes * printable.size(), freshFont, []() { gui::GlyphCache::prewarm(); });
+		benchmark("first screen, prewarmed", sizes, sizes, [&]() { freshFont(); gui::GlyphCache::prewarm(); }, firstScreen);
+
+		// The same font file under several names, e.g. one per language of the UI: opened each time,
+		// or opened once and shared.
+		constexpr size_t fontNames{ 8 };
+		auto const removeFonts{ []()
+		{
+			for (size_t i{ 0 }; i < fontNames; ++i)
+				gui::TextWrapper::removeFont("__font" + std::to_string(i));
+		} };
+
+		benchmark("fonts, each opened", fontNames, fontNames, removeFonts, []()
+		{
+			for (size_t i{ 0 }; i < fontNames; ++i)
+			{
+				std::ostringstream fontErrorMessage{};
+				if (auto font{ gui::loadFontFromFile(fontErrorMessage, "defaultFont.ttf") }; font.has_value())
+					gui::TextWrapper::createFont("__font" + std::to_string(i), std::move(*font));
+			}
+		});
+
+		benchmark("fonts, deduplicated", fontNames, fontNames, removeFonts, []()
+		{
+			for (size_t i{ 0 }; i < fontNames; ++i)
+				gui::TextWrapper::createFont("__font" + std::to_string(i), "defaultFont.ttf");
+		});
+		removeFonts();
+
+		// A cold start: the textures of the UI loaded one by one at first use, or all preloaded.
+		constexpr size_t coldTextures{ 400 };
+		constexpr sf::Vector2u coldTextureSize{ 128, 128 };
+		std::filesystem::create_directories("../assets/__benchmark");
+
+		gui::AssetManifest manifest{};
+		std::mt19937 generator{ 42 };
+		std::vector<std::uint8_t> pixels(coldTextureSize.x * coldTextureSize.y * 4);
+		for (size_t i{ 0 }; i < coldTextures; ++i)
+		{	// Noise, so the decoding costs as much as for a real image.
+			std::generate(pixels.begin(), pixels.end(), [&]() { return static_cast<std::uint8_t>(generator() % 8 * 32); });
+			manifest.textures.push_back({ "__benchmark/" + std::to_string(i), "__benchmark/" + std::to_string(i) + ".png", gui::SpriteWrapper::Reserved::No });
+
+			if (!sf::Image{ coldTextureSize, pixels.data() }.saveToFile("../assets/" + manifest.textures.back().fileName))
+				throw std::runtime_error{ "The textures could not be written in ../assets/__benchmark" };
+		}
+
+		auto const removeTextures{ [&]()
+		{
+			for (auto const& texture : manifest.textures)
+				gui::SpriteWrapper::removeTexture(texture.name);
+		} };
+
+		benchmark("cold start, one by one", coldTextures, coldTextures, removeTextures, [&]()
+		{
+			for (auto const& texture : manifest.textures)
+				gui::SpriteWrapper::createTexture(texture.name, texture.fileName, texture.shared, true);
+		});
+
+		std::ostringstream errorMessage{};
+		gui::AssetPreloader::Report report{};
+		benchmark("cold start, preloaded", coldTextures, coldTextures, removeTextures, [&]() { report = gui::AssetPreloader::preload(errorMessage, manifest); });
+		std::cout << report.summary();
+		removeTextures();
+
+		// Sprites drawn much smaller than their texture, as in a small window: with mipmaps, a smaller
+		// level is sampled.
+		constexpr sf::Vector2u largeTextureSize{ 1024, 1024 };
+		pixels.resize(largeTextureSize.x * largeTextureSize.y * 4);
+		std::generate(pixels.begin(), pixels.end(), [&]() { return static_cast<std::uint8_t>(generator() % 8 * 32); });
+		if (!sf::Image{ largeTextureSize, pixels.data() }.saveToFile("../assets/__benchmark/large.png"))
+			throw std::runtime_error{ "The textures could not be written in ../assets/__benchmark" };
+
+		gui::SpriteWrapper::createTexture("__benchmark/large", "__benchmark/large.png", gui::SpriteWrapper::Reserved::No, true);
+		gui::SpriteWrapper::createTexture("__benchmark/large mipmapped", "__benchmark/large.png", gui::SpriteWrapper::Reserved::No, true, gui::TextureOptions{ .mipmap = true });
+
+		for (std::string const name : { "__benchmark/large", "__benchmark/large mipmapped" })
+		{
+			constexpr size_t downscaledSprites{ 1'000 };
+			std::optional<BGUI> downscaled{ std::in_place, &target };
+			for (size_t i{ 0 }; i < downscaledSprites; ++i)
+				downscaled->addSprite(name, positionOf(i), sf::Vector2f{ 0.05f, 0.05f });
+
+			benchmark((name.ends_with("mipmapped")) ? "draw downscaled, mipmaps" : "draw downscaled", downscaledSprites, downscaledSprites, [&]()
+			{
+				target.clear();
+				downscaled->draw();
+				target.display();
+			});
+
+			downscaled.reset();
+			gui::SpriteWrapper::removeTexture(name);
+		}
+
+		std::filesystem::remove_all("../assets/__benchmark");
+	}
+	catch (std::exception const& error)
+	{	// The default font is missing, or the assets folder is read-only, most likely.
+		std::cout << error.what() << '\n';
+		return 1;
+	}
+
+	if (!writeJson(jsonName))
+	{
+		std::cout << "The results could not be written in " << jsonName << '\n';
+		return 1;
+	}
+
+	std::cout << "results written in " << jsonName << '\n';
+	return 0;
+}
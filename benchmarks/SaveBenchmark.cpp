@@ -0,0 +1,161 @@
+/*******************************************************************
+ * @file SaveBenchmark.cpp
+ * @brief Measures the throughput and the latency of Save across record counts and record sizes.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note Run it from the bin folder, as the game: the saves are written in ../saves/.
+ *		 This is the baseline any I/O optimization of Save must be compared with.
+ *		 The backend is chosen by the first argument: streams (default), posix or io_uring.
+ *********************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Save.hpp"
+#include "Save/IoBackend.hpp"
+#include "Save/RecordStream.hpp"
+
+using namespace SafeSaves;
+
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+std::string const savesPath{ "../saves/" }; // Same as Save.
+std::string const fileName{ "benchmark_save.sav" };
+constexpr size_t bytesPerScenario{ 64 * 1024 * 1024 }; // Fewer calls for bigger files.
+
+/// Runs a scenario, then prints its latency (mean, median, 99th percentile) and its throughput.
+template<typename Scenario>
+void benchmark(std::string const& name, size_t bytesPerCall, Scenario&& scenario)
+{
+	size_t const iterations{ std::clamp<size_t>(bytesPerScenario / std::max<size_t>(bytesPerCall, 1), 20, 2'000) };
+	std::vector<double> latencies(iterations);
+
+	for (auto& latency : latencies)
+	{
+		Clock::time_point const start{ Clock::now() };
+		scenario();
+		latency = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+	}
+
+	double total{ 0. };
+	for (double latency : latencies)
+		total += latency;
+
+	std::sort(latencies.begin(), latencies.end());
+	double const mean{ total / static_cast<double>(iterations) };
+	double const megabytesPerSecond{ (mean > 0.) ? static_cast<double>(bytesPerCall) / mean : 0. }; // Bytes per us is MB/s.
+
+	std::cout << std::fixed << std::setprecision(2)
+			  << std::left << std::setw(34) << name << std::right
+			  << std::setw(12) << mean
+			  << std::setw(12) << latencies[iterations / 2]
+			  << std::setw(12) << latencies[std::min(iterations - 1, iterations * 99 / 100)]
+			  << std::setw(10) << megabytesPerSecond << '\n';
+}
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+	std::filesystem::create_directories(savesPath);
+
+	std::string const backendName{ (argc > 1) ? argv[1] : "streams" };
+	IoBackendKind const kind{ (backendName == "posix") ? IoBackendKind::Posix : (backendName == "io_uring") ? IoBackendKind::IoUring : IoBackendKind::Streams };
+
+	std::unique_ptr<IoBackend> const backend{ makeIoBackend(kind) };
+	if (backend == nullptr)
+	{
+		std::cout << "The backend " << backendName << " is not supported by this system\n";
+		return 1;
+	}
+
+	Save::setIoBackend(backend.get());
+	std::cout << "backend: " << backendName << '\n';
+
+	std::cout << std::left << std::setw(34) << "scenario" << std::right
+			  << std::setw(12) << "mean us"
+			  << std::setw(12) << "p50 us"
+			  << std::setw(12) << "p99 us"
+			  << std::setw(10) << "MB/s" << '\n';
+
+	benchmark("createFile", 0, [&]()
+	{
+		static_cast<void>(Save::createFile(fileName));
+	});
+
+	for (size_t const recordCount : { size_t{ 16 }, size_t{ 1'024 }, size_t{ 65'536 } })
+	{
+		for (size_t const recordSize : { size_t{ 16 }, size_t{ 256 } })
+		{
+			std::vector<std::string> values(recordCount, std::string(recordSize, 'x'));
+			std::vector<std::string> loaded(recordCount);
+			size_t const bytes{ recordCount * (recordSize + 1) };
+			std::string const shape{ std::to_string(recordCount) + " x " + std::to_string(recordSize) + " B" };
+
+			static_cast<void>(Save::createFile(fileName));
+
+			for (bool const encrypt : { false, true })
+			{
+				std::string const suffix{ (encrypt) ? ", encrypted" : "" };
+
+				benchmark("writing " + shape + suffix, bytes, [&]()
+				{
+					static_cast<void>(Save::writing(fileName, values, encrypt));
+				});
+
+				benchmark("reading " + shape + suffix, bytes, [&]()
+				{
+					static_cast<void>(Save::reading(fileName, loaded, encrypt));
+				});
+
+				benchmark("streaming " + shape + suffix, bytes, [&]()
+				{
+					RecordStream records{};
+					static_cast<void>(Save::streaming(fileName, records, encrypt));
+
+					size_t size{ 0 };
+					for (std::string_view record : records)
+						size += record.size();
+
+					static_cast<void>(size);
+				});
+			}
+		}
+	}
+
+	for (size_t const blobSize : { size_t{ 4 * 1024 }, size_t{ 1024 * 1024 }, size_t{ 16 * 1024 * 1024 } })
+	{
+		std::string blob(blobSize, '\0');
+		for (size_t i{ 0 }; i < blobSize; ++i)
+			blob[i] = static_cast<char>((i * 31) ^ (i >> 7)); // Not trivially compressible.
+
+		std::string loaded{};
+		std::string const shape{ std::to_string(blobSize / 1024) + " KiB" };
+
+		benchmark("writingBlob " + shape, blobSize, [&]()
+		{
+			static_cast<void>(Save::writingBlob(fileName, blob));
+		});
+
+		benchmark("readingBlob " + shape, blobSize, [&]()
+		{
+			static_cast<void>(Save::readingBlob(fileName, loaded));
+		});
+	}
+
+	Save::setIoBackend(nullptr);
+	std::filesystem::remove(savesPath + fileName);
+	return 0;
+}
@@ -0,0 +1,215 @@
+/*******************************************************************
+ * @file SaveCompressionBenchmark.cpp
+ * @brief Measures the compression ratio and speed of the saves, on typical contents.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note Usage: SaveCompressionBenchmark [files...]. Each file given is added to the corpora.
+ *		 Run it from the bin folder, as the game: the saves are written in ../saves/.
+ *********************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "Save.hpp"
+#include "Save/Compression.hpp"
+#include "Save/KeyValueStore.hpp"
+
+using namespace SafeSaves;
+
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+std::string const savesPath{ "../saves/" }; // Same as Save.
+
+/// A save as Save::writing() produces it: short lines of numbers and settings.
+std::string makeLineSave(std::mt19937& random)
+{
+	std::string content{};
+	for (int i{ 0 }; i < 40'000; ++i)
+	{
+		content += "player" + std::to_string(i % 64) + ".score=" + std::to_string(random() % 100'000) + '\n';
+		content += "player" + std::to_string(i % 64) + ".position=" + std::to_string(random() % 1920) + ',' + std::to_string(random() % 1080) + '\n';
+	}
+
+	return content;
+}
+
+/// A snapshot of a KeyValueStore: keys, type tags and binary integers.
+std::string makeKeyValueSave(std::mt19937& random)
+{
+	std::string content{};
+	for (int i{ 0 }; i < 50'000; ++i)
+	{
+		std::string const key{ "entity/" + std::to_string(i) + "/health" };
+		uint64_t const value{ random() % 200 };
+
+		content.append(key);
+		content.push_back(static_cast<char>(KeyValueStore::ValueType::Integer));
+		for (int byte{ 0 }; byte < 8; ++byte)
+			content.push_back(static_cast<char>((value >> (8 * byte)) & 0xFF));
+	}
+
+	return content;
+}
+
+/// A tile map: few distinct values, long runs.
+std::string makeTileMapSave(std::mt19937& random)
+{
+	std::string content(4 * 1024 * 1024, '\0');
+	for (size_t i{ 0 }; i < content.size(); )
+	{
+		size_t const run{ 1 + random() % 32 };
+		char const tile{ static_cast<char>(random() % 8) };
+		for (size_t j{ 0 }; j < run && i < content.size(); ++j, ++i)
+			content[i] = tile;
+	}
+
+	return content;
+}
+
+/// Already compressed or encrypted data: the worst case.
+std::string makeRandomSave(std::mt19937& random)
+{
+	std::string content(4 * 1024 * 1024, '\0');
+	for (char& datum : content)
+		datum = static_cast<char>(random());
+
+	return content;
+}
+
+/// Runs a function enough times to last a while, returns the mean time of a run in seconds.
+template<typename Function>
+double measure(Function&& function)
+{
+	int runs{ 0 };
+	Clock::time_point const start{ Clock::now() };
+	Clock::duration elapsed{};
+
+	do
+	{
+		function();
+		++runs;
+		elapsed = Clock::now() - start;
+	} while (elapsed < std::chrono::milliseconds{ 300 } || runs < 3);
+
+	return std::chrono::duration<double>(elapsed).count() / runs;
+}
+
+void benchmark(std::string const& name, std::string const& content)
+{
+	double const megabytes{ static_cast<double>(content.size()) / (1024. * 1024.) };
+
+	// The codec alone, chunk by chunk as Save does.
+	std::string compressed{};
+	double const compressTime{ measure([&]()
+	{
+		compressed.clear();
+		for (size_t offset{ 0 }; offset < content.size(); offset += Compression::chunkSize)
+			Compression::compressBlock(std::string_view{ content }.substr(offset, Compression::chunkSize), compressed);
+	}) };
+
+	std::vector<std::string> blocks{};
+	for (size_t offset{ 0 }; offset < content.size(); offset += Compression::chunkSize)
+	{
+		blocks.emplace_back();
+		Compression::compressBlock(std::string_view{ content }.substr(offset, Compression::chunkSize), blocks.back());
+	}
+
+	std::string decompressed(content.size(), '\0');
+	double const decompressTime{ measure([&]()
+	{
+		for (size_t i{ 0 }; i < blocks.size(); ++i)
+		{
+			size_t const offset{ i * Compression::chunkSize };
+			if (!Compression::decompressBlock(blocks[i], decompressed.data() + offset, std::min(Compression::chunkSize, content.size() - offset)))
+				std::cerr << "Decompression failed: " << name << '\n';
+		}
+	}) };
+
+	if (decompressed != content)
+		std::cerr << "Round trip failed: " << name << '\n';
+
+	// The whole pipeline, files included.
+	std::string const fileName{ "benchmark_compression.sav" };
+	static_cast<void>(Save::createFile(fileName));
+
+	double const rawWriteTime{ measure([&]() { static_cast<void>(Save::writingBlob(fileName, content, true, false)); }) };
+	uintmax_t const rawFileSize{ std::filesystem::file_size(savesPath + fileName) };
+
+	double const compressedWriteTime{ measure([&]() { static_cast<void>(Save::writingBlob(fileName, content, true, true)); }) };
+	uintmax_t const compressedFileSize{ std::filesystem::file_size(savesPath + fileName) };
+
+	std::string loaded{};
+	double const compressedReadTime{ measure([&]() { static_cast<void>(Save::readingBlob(fileName, loaded, true, true)); }) };
+
+	if (loaded != content)
+		std::cerr << "Save round trip failed: " << name << '\n';
+
+	std::filesystem::remove(savesPath + fileName);
+
+	std::cout << std::fixed << std::setprecision(2)
+			  << std::left << std::setw(16) << name << std::right
+			  << std::setw(10) << megabytes
+			  << std::setw(10) << static_cast<double>(content.size()) / static_cast<double>(compressed.size())
+			  << std::setw(12) << megabytes / compressTime
+			  << std::setw(12) << megabytes / decompressTime
+			  << std::setw(12) << rawWriteTime * 1000.
+			  << std::setw(12) << compressedWriteTime * 1000.
+			  << std::setw(12) << compressedReadTime * 1000.
+			  << std::setw(10) << static_cast<double>(rawFileSize) / static_cast<double>(compressedFileSize) << '\n';
+}
+} // namespace
+
+
+int main(int argc, char* argv[])
+{
+	std::mt19937 random{ 42 };
+	std::vector<std::pair<std::string, std::string>> corpora{};
+	corpora.emplace_back("lines", makeLineSave(random));
+	corpora.emplace_back("key-value", makeKeyValueSave(random));
+	corpora.emplace_back("tile map", makeTileMapSave(random));
+	corpora.emplace_back("random", makeRandomSave(random));
+
+	for (int i{ 1 }; i < argc; ++i)
+	{
+		std::ifstream file{ argv[i], std::ios::binary };
+		if (!file.is_open())
+		{
+			std::cerr << "Unable to open " << argv[i] << '\n';
+			continue;
+		}
+
+		corpora.emplace_back(std::filesystem::path{ argv[i] }.filename().string(), std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} });
+	}
+
+	std::filesystem::create_directories(savesPath);
+
+	std::cout << std::left << std::setw(16) << "corpus" << std::right
+			  << std::setw(10) << "MB"
+			  << std::setw(10) << "ratio"
+			  << std::setw(12) << "comp MB/s"
+			  << std::setw(12) << "dec MB/s"
+			  << std::setw(12) << "write ms"
+			  << std::setw(12) << "write+c ms"
+			  << std::setw(12) << "read+c ms"
+			  << std::setw(10) << "file" << '\n';
+
+	for (auto const& [name, content] : corpora)
+		benchmark(name, content);
+
+	return 0;
+}
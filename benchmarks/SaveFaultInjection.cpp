@@ -0,0 +1,173 @@
+/*******************************************************************
+ * @file SaveFaultInjection.cpp
+ * @brief Breaks the writes of Save at every step, and checks that the old or the new saves survive.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note Run it from the bin folder, as the game: the saves are written in ../saves/.
+ *		 Returns 1 if a save is lost or mixed, 0 otherwise.
+ *********************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Save.hpp"
+#include "Save/FaultInjection.hpp"
+
+using namespace SafeSaves;
+
+
+namespace
+{
+std::string const savesPath{ "../saves/" }; // Same as Save.
+std::string const fileName{ "fault_injection.sav" };
+constexpr size_t recordCount{ 2'000 }; // More than a write buffer, to break the writes in the middle.
+constexpr bool encrypt{ false }; // An encrypted line may contain '\n': the records would not all be read back.
+
+/// What the file must contain once read back.
+enum class Outcome : uint8_t
+{
+	Old,
+	New,
+	OldOrNew
+};
+
+char const* faultName(FileFault fault) noexcept
+{
+	switch (fault)
+	{
+	case FileFault::ShortWrites: return "short writes";
+	case FileFault::NoSpace: return "no space";
+	case FileFault::Crash: return "crash";
+	case FileFault::CorruptTail: return "corrupt tail";
+	default: return "none";
+	}
+}
+
+std::vector<std::string> records(std::string const& prefix)
+{
+	std::vector<std::string> values(recordCount);
+	for (size_t i{ 0 }; i < recordCount; ++i)
+		values[i] = prefix + std::to_string(i * 7919);
+
+	return values;
+}
+
+/// The trigger points: both ends, around the tokens, and evenly spread in between.
+std::vector<uint64_t> triggerPoints(uint64_t totalSize)
+{
+	std::vector<uint64_t> points{ 0, 1, totalSize - 1, totalSize, totalSize + 1 };
+	for (uint64_t i{ 1 }; i < 32; ++i)
+		points.push_back(totalSize * i / 32);
+
+	std::sort(points.begin(), points.end());
+	points.erase(std::unique(points.begin(), points.end()), points.end());
+	return points;
+}
+
+Outcome expectedOutcome(FileFault fault, uint64_t triggerByte, uint64_t totalSize) noexcept
+{
+	switch (fault)
+	{
+	case FileFault::ShortWrites: return Outcome::New; // Every short write is completed.
+	case FileFault::NoSpace: return (triggerByte >= totalSize) ? Outcome::New : Outcome::Old;
+	case FileFault::CorruptTail: return (triggerByte >= totalSize) ? Outcome::New : Outcome::Old;
+	default: return Outcome::OldOrNew; // Depends on whether the rename happened before the crash.
+	}
+}
+
+/// True if an encrypted blob of several chunks is read back as written, with a key whose size does not divide a chunk.
+bool blobRoundTrips(bool compress)
+{
+	SaveStore store{ savesPath + "key_round_trip/", "another key" };
+	std::string const blobName{ "round_trip.bin" };
+
+	std::string blob(200'000, '\0');
+	for (size_t i{ 0 }; i < blob.size(); ++i)
+		blob[i] = static_cast<char>((i * 31) % 251); // Barely compressible.
+
+	static_cast<void>(store.createFile(blobName));
+	std::string loaded{};
+	return !store.writingBlob(blobName, blob, true, compress).has_value() && !store.readingBlob(blobName, loaded, true, compress).has_value() && loaded == blob;
+}
+} // namespace
+
+
+int main()
+{
+	std::filesystem::create_directories(savesPath);
+
+	std::vector<std::string> const oldRecords{ records("old ") };
+	std::vector<std::string> const newRecords{ records("new ") };
+
+	StreamBackend streams{};
+	FaultInjectionBackend faults{ streams };
+	Save::setIoBackend(&faults);
+
+	// A clean write gives the number of bytes to break.
+	static_cast<void>(Save::createFile(fileName));
+	faults.arm(FaultPlan{});
+	static_cast<void>(Save::writing(fileName, newRecords, encrypt));
+	uint64_t const totalSize{ faults.bytesWritten() };
+	faults.disarm();
+
+	size_t runs{ 0 };
+	size_t violations{ 0 };
+
+	for (FileFault const fault : { FileFault::ShortWrites, FileFault::NoSpace, FileFault::Crash, FileFault::CorruptTail })
+	{
+		std::vector<uint64_t> const points{ (fault == FileFault::ShortWrites) ? std::vector<uint64_t>{ 1, 7, 4'096, totalSize } : triggerPoints(totalSize) };
+
+		for (uint64_t const triggerByte : points)
+		{
+			static_cast<void>(Save::createFile(fileName));
+			static_cast<void>(Save::writing(fileName, oldRecords, encrypt));
+
+			faults.arm(FaultPlan{ fault, triggerByte });
+			auto const writingError{ Save::writing(fileName, newRecords, encrypt) };
+			bool const crashed{ faults.hasCrashed() }; // Nobody is left to report the error.
+			faults.disarm(); // As after a restart.
+
+			Save::forgetValidatedFiles(); // A restarted game knows nothing.
+			std::vector<std::string> loaded(recordCount);
+			auto const readingError{ Save::reading(fileName, loaded, encrypt) };
+
+			bool const isOld{ !readingError.has_value() && loaded == oldRecords };
+			bool const isNew{ !readingError.has_value() && loaded == newRecords };
+			Outcome const expected{ expectedOutcome(fault, triggerByte, totalSize) };
+
+			bool valid{ (expected == Outcome::Old) ? isOld : (expected == Outcome::New) ? isNew : isOld || isNew };
+			valid = valid && (isNew || writingError.has_value() || crashed); // A lost save is reported.
+			valid = valid && !std::filesystem::exists(savesPath + fileName + ".tmp"); // Recovered once read.
+
+			++runs;
+			if (!valid)
+			{
+				++violations;
+				std::cout << "FAILED: " << faultName(fault) << " at byte " << triggerByte << " of " << totalSize
+						  << ((isOld) ? ": old saves" : (isNew) ? ": new saves" : ": saves lost") << '\n';
+			}
+		}
+	}
+
+	Save::setIoBackend(nullptr);
+	std::filesystem::remove(savesPath + fileName);
+
+	for (bool const compress : { false, true })
+	{
+		++runs;
+		if (!blobRoundTrips(compress))
+		{
+			++violations;
+			std::cout << "FAILED: encrypted blob" << ((compress) ? " compressed" : "") << " not read back\n";
+		}
+	}
+	std::filesystem::remove_all(savesPath + "key_round_trip/");
+
+	std::cout << runs << " faults injected, " << violations << " saves lost or mixed\n";
+	return (violations == 0) ? 0 : 1;
+}
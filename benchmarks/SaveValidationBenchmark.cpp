@@ -0,0 +1,118 @@
+/*******************************************************************
+ * @file SaveValidationBenchmark.cpp
+ * @brief Counts the file operations and measures the latency of validating the saves.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note Run it from the bin folder, as the game: the saves are written in ../saves/.
+ *		 The counters are the operations done by Save to validate, recover and prepare the files;
+ *		 run it under `strace -c -f` to see every system call.
+ *********************************************************************/
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Save.hpp"
+#include "Save/SaveGenerations.hpp"
+
+using namespace SafeSaves;
+
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+std::string const savesPath{ "../saves/" }; // Same as Save.
+std::string const fileName{ "benchmark_validation.sav" };
+constexpr int iterations{ 2'000 };
+
+/// Runs a scenario, then prints its mean latency and file operations per call.
+template<typename Scenario>
+void benchmark(std::string const& name, Scenario&& scenario)
+{
+	Save::resetFileOperationCounters();
+	Clock::time_point const start{ Clock::now() };
+
+	for (int i{ 0 }; i < iterations; ++i)
+		scenario();
+
+	double const microseconds{ std::chrono::duration<double, std::micro>(Clock::now() - start).count() / iterations };
+	FileOperationCounters const counters{ Save::getFileOperationCounters() };
+	auto const perCall = [](uint64_t count) { return static_cast<double>(count) / iterations; };
+
+	std::cout << std::fixed << std::setprecision(2)
+			  << std::left << std::setw(26) << name << std::right
+			  << std::setw(10) << microseconds
+			  << std::setw(8) << perCall(counters.stats)
+			  << std::setw(8) << perCall(counters.opens)
+			  << std::setw(8) << perCall(counters.reads)
+			  << std::setw(8) << perCall(counters.copies)
+			  << std::setw(8) << perCall(counters.renames)
+			  << std::setw(8) << perCall(counters.removes)
+			  << std::setw(8) << perCall(counters.hits)
+			  << std::setw(8) << perCall(counters.links) << '\n';
+}
+} // namespace
+
+
+int main()
+{
+	std::filesystem::create_directories(savesPath);
+	static_cast<void>(Save::createFile(fileName));
+
+	std::vector<std::string> values(64, "0123456789abcdef");
+	static_cast<void>(Save::writing(fileName, values));
+
+	std::cout << std::left << std::setw(26) << "scenario" << std::right
+			  << std::setw(10) << "us/call"
+			  << std::setw(8) << "stat"
+			  << std::setw(8) << "open"
+			  << std::setw(8) << "read"
+			  << std::setw(8) << "copy"
+			  << std::setw(8) << "rename"
+			  << std::setw(8) << "remove"
+			  << std::setw(8) << "hit"
+			  << std::setw(8) << "link" << '\n';
+
+	std::vector<std::string> loaded(values.size());
+
+	benchmark("reading (cached)", [&]()
+	{
+		static_cast<void>(Save::reading(fileName, loaded));
+	});
+
+	benchmark("reading (uncached)", [&]()
+	{
+		Save::forgetValidatedFiles();
+		static_cast<void>(Save::reading(fileName, loaded));
+	});
+
+	benchmark("writing", [&]()
+	{
+		static_cast<void>(Save::writing(fileName, values));
+	});
+
+	SaveGenerations::setCapacity(4);
+	benchmark("writing (4 generations)", [&]()
+	{
+		static_cast<void>(Save::writing(fileName, values));
+	});
+	SaveGenerations::setCapacity(0);
+	static_cast<void>(SaveGenerations::prune(fileName, 0));
+
+	benchmark("recovery from tmp", [&]()
+	{	// As if the game crashed while writing: the tmp file is valid, the perm file is not.
+		std::filesystem::copy_file(savesPath + fileName, savesPath + fileName + ".tmp", std::filesystem::copy_options::overwrite_existing);
+		std::ofstream{ savesPath + fileName, std::ios::trunc } << "torn";
+		static_cast<void>(Save::reading(fileName, loaded));
+	});
+
+	std::filesystem::remove(savesPath + fileName);
+	return 0;
+}
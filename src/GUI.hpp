@@ -16,6 +16,13 @@
 #include "GUI/MutableInterface.hpp"
 #include "GUI/InteractiveInterface.hpp"
 #include "GUI/AdvancedInterface.hpp"
+#include "GUI/InterfaceState.hpp"
+#include "GUI/GlyphCache.hpp"
+#include "GUI/AssetPreloader.hpp"
+#include "GUI/WidgetRasterizer.hpp"
+#include "GUI/TextureBatch.hpp"
+#include "GUI/CommandQueue.hpp"
+#include "GUI/WorkStealingPool.hpp"
 
 using BGUI = gui::BasicInterface;
 using MGUI = gui::MutableInterface;
@@ -1,4 +1,6 @@
 #include "AdvancedInterface.hpp"
+#include "WidgetRasterizer.hpp"
+#include <cmath>
 
 namespace gui
 {
@@ -81,23 +83,17 @@ void AdvancedInterface::MultipleQuestionBoxes::reverseCurrentHovered(unsigned sh
 }
 
 
-AdvancedInterface::AdvancedInterface(sf::RenderWindow* window, unsigned int relativeScalingDefinition) noexcept
+AdvancedInterface::AdvancedInterface(sf::RenderTarget* window, unsigned int relativeScalingDefinition) noexcept
 	: InteractiveInterface{ window, relativeScalingDefinition }, m_sliders{}, m_mqbs{}
 {}
 
 void AdvancedInterface::addSlider(std::string identifier, sf::Vector2f pos, unsigned int size, short intervals, UserFunction userFunction, GrowthSliderFunction growthSliderFunction, bool showValueWithText) noexcept
 {
-	static constexpr std::string_view sliderBackgroundTextureName{ "__sb" };
-	static constexpr std::string_view sliderCursorTextureName{ "__sc" };
-
-	if (SpriteWrapper::getTexture(sliderBackgroundTextureName) == nullptr)
-	{
-		constexpr float goldenRatio{ 1.618f };
-		constexpr unsigned int size{ 30 };
-		static constexpr float outlineThickness{ -5.f };
-		SpriteWrapper::createTexture(std::string{ sliderBackgroundTextureName }, loadSolidRectange(sf::Vector2f{ size, 10 * size },			 outlineThickness), SpriteWrapper::Reserved::No);
-		SpriteWrapper::createTexture(std::string{ sliderCursorTextureName },	 loadSolidRectange(sf::Vector2f{ size * goldenRatio, size }, outlineThickness), SpriteWrapper::Reserved::No);
-	}
+	constexpr float goldenRatio{ 1.618f };
+	constexpr unsigned int width{ 30 };
+	constexpr unsigned int outlineThickness{ 5 };
+	const std::string sliderBackgroundTextureName{ WidgetRasterizer::textureOf(WidgetRasterizer::Style{ .size{ width, 10 * width }, .outlineThickness = outlineThickness }) };
+	const std::string sliderCursorTextureName{ WidgetRasterizer::textureOf(WidgetRasterizer::Style{ .size{ static_cast<unsigned int>(std::ceil(width * goldenRatio)), width }, .outlineThickness = outlineThickness }) };
 
 	if (m_sliders.find(identifier) != m_sliders.end()) 
 		return;
@@ -127,6 +123,23 @@ void AdvancedInterface::removeSlider(const std::string& identifier) noexcept
 	removeDynamicText(sliderTextPrefixeIdentifier + identifier); // Nothing happens if not there.
 }
 
+bool AdvancedInterface::applyCommand(const CommandQueue::Command& command) noexcept
+{
+	if (command.type != CommandQueue::Command::Type::SliderPosition)
+		return MutableInterface::applyCommand(command);
+
+	auto sliderIterator{ m_sliders.find(command.identifier) };
+	SpriteWrapper* background{ getDynamicSprite(command.identifier) };
+	SpriteWrapper* cursor{ getDynamicSprite(sliderCursorPrefixeIdentifier + command.identifier) };
+	if (sliderIterator == m_sliders.end() || background == nullptr || cursor == nullptr || !(command.sliderPosition >= 0.f && command.sliderPosition <= 1.f))
+		return false;
+
+	// Moves the cursor as the user would: the value, its text and its function follow.
+	const sf::FloatRect bounds{ background->getSprite().getGlobalBounds() };
+	sliderIterator->second.setCursor(bounds.position.y + (1.f - command.sliderPosition) * bounds.size.y, *cursor, *background, getDynamicText(sliderTextPrefixeIdentifier + command.identifier));
+	return true;
+}
+
 const AdvancedInterface::Slider* const AdvancedInterface::getSlider(const std::string& identifier) const noexcept
 {
 	auto itSlider{ m_sliders.find(identifier) };
@@ -139,16 +152,10 @@ const AdvancedInterface::Slider* const AdvancedInterface::getSlider(const std::s
 
 void AdvancedInterface::addMQB(std::string identifier, sf::Vector2f posInit, sf::Vector2f posDelta, unsigned short numberOfBoxes, bool multipleChoices, bool atLeastOne, unsigned short defaultCheckedBox) noexcept
 {
-	static constexpr std::string_view uncheckedMqbTextureName{ "__ub" };
-	static constexpr std::string_view checkedMqbTextureName{ "__cb" };
-
-	if (SpriteWrapper::getTexture(uncheckedMqbTextureName) == nullptr)
-	{
-		static constexpr sf::Vector2f boxSize{ 25, 25 };
-		static constexpr float outlineThickness{ -3.f };
-		SpriteWrapper::createTexture(std::string{ uncheckedMqbTextureName }, loadSolidRectange(boxSize,   outlineThickness), SpriteWrapper::Reserved::No);
-		SpriteWrapper::createTexture(std::string{ checkedMqbTextureName },   loadCheckBoxTexture(boxSize, outlineThickness), SpriteWrapper::Reserved::No);
-	}
+	constexpr sf::Vector2u boxSize{ 25, 25 };
+	constexpr unsigned int outlineThickness{ 3 };
+	const std::string uncheckedMqbTextureName{ WidgetRasterizer::textureOf(WidgetRasterizer::Style{ .size{ boxSize }, .outlineThickness = outlineThickness }) };
+	const std::string checkedMqbTextureName{ WidgetRasterizer::textureOf(WidgetRasterizer::Style{ .size{ boxSize }, .outlineThickness = outlineThickness, .checkMark = true }) };
 
 	if (getMQB(identifier) != nullptr)
 		return;
@@ -197,6 +204,7 @@ AdvancedInterface::MultipleQuestionBoxes* AdvancedInterface::getMQB(const std::s
 
 InteractiveInterface::Item AdvancedInterface::pressed(BasicInterface* activeGUI, sf::Vector2f cursorPos) noexcept
 {
+	GUI_PROFILE_SCOPE("AdvancedInterface::pressed");
 	AdvancedInterface* agui{dynamic_cast<AdvancedInterface*>(activeGUI)};
 	if (agui == nullptr || s_hoveredItem.identifier == "" || s_hoveredItem.igui != agui)
 		return s_hoveredItem;
@@ -211,43 +219,6 @@ InteractiveInterface::Item AdvancedInterface::pressed(BasicInterface* activeGUI,
 	return s_hoveredItem;
 }
 
-
-sf::Texture AdvancedInterface::loadSolidRectange(sf::Vector2f scale, float outlineThickness) noexcept
-{
-	static constexpr sf::Color fillColor{ 20, 20, 20 };
-	static constexpr sf::Color outlineColor{ 80, 80, 80 };
-
-	sf::RectangleShape shape{ scale };
-	shape.setFillColor(fillColor);
-	shape.setOutlineColor(outlineColor);
-	shape.setOutlineThickness(outlineThickness);
-
-	return createTextureFromDrawables(shape);
-}
-
-sf::Texture AdvancedInterface::loadCheckBoxTexture(sf::Vector2f scale, float outlineThickness) noexcept
-{
-	static constexpr sf::Color outlineColor{ 80, 80, 80 };
-	
-	auto texture{ loadSolidRectange(scale, outlineThickness) };
-	sf::Image image{ texture.copyToImage() };
-
-	for (unsigned int i{ 0 }; i < image.getSize().x; ++i)
-	{
-		for (unsigned int j{ 0 }; j < image.getSize().y; ++j)
-		{
-			if (std::abs(static_cast<int>(i) - static_cast<int>(j)) < std::abs(outlineThickness))
-				image.setPixel(sf::Vector2u{ i, j }, outlineColor);
-			else if (std::abs(static_cast<int>(image.getSize().x) - static_cast<int>(i) - static_cast<int>(j)) < std::abs(outlineThickness))
-				image.setPixel(sf::Vector2u{ i, j }, outlineColor);
-		}
-	}
-
-	if (!texture.loadFromImage(image))
-		texture = sf::Texture{};
-	return texture;
-}
-
 }
 
 
@@ -22,6 +22,8 @@
 namespace gui
 {
 
+class InterfaceState;
+
 class AdvancedInterface : public InteractiveInterface
 {
 public:
@@ -58,6 +60,7 @@ public:
 		GrowthSliderFunction m_growthSliderFunction; // The function to apply to the value of the slider when it is changed.
 
 	friend class AdvancedInterface;
+	friend class InterfaceState;
 	};
 
 	class MultipleQuestionBoxes
@@ -87,6 +90,7 @@ public:
 		std::unordered_set<unsigned short> m_checked;
 
 	friend class AdvancedInterface;
+	friend class InterfaceState;
 	};
 
 	//using MQB = MultipleQuestionBoxes;
@@ -96,6 +100,7 @@ public:
 	 * \complexity O(1)
 	 *
 	 * \param[in,out] window A valid pointer to the SFML window where interface elements will be rendered.
+	 *				  Any render target works, e.g. an `sf::RenderTexture` to render offscreen.
 	 * \param[in] relativeScalingDefinition A scaling baseline to ensure consistent visual proportions across
 	 *			  various window sizes. Scales of `sf::Transformable` elements are adjusted based on the window size
 	 *			  relative to this reference value:
@@ -116,7 +121,7 @@ public:
 	 * \pre `window` must be a valid.
 	 * \warning The program will assert otherwise.
 	 */
-	explicit AdvancedInterface(sf::RenderWindow* window, unsigned int relativeScalingDefinition = 1080) noexcept;
+	explicit AdvancedInterface(sf::RenderTarget* window, unsigned int relativeScalingDefinition = 1080) noexcept;
 
 	AdvancedInterface() noexcept = delete;
 	AdvancedInterface(AdvancedInterface const&) noexcept = delete;
@@ -151,19 +156,28 @@ public:
 	 */
 	static Item pressed(BasicInterface* activeGUI, sf::Vector2f cursorPos) noexcept;
 
+protected:
+
+	/**
+	 * \brief Applies a command drained from the queue of the interface, including those for sliders.
+	 * \complexity O(1).
+	 *
+	 * \see `MutableInterface::applyCommand`.
+	 */
+	virtual bool applyCommand(const CommandQueue::Command& command) noexcept override;
+
 private:
 
 	std::unordered_map< std::string, Slider> m_sliders;
 	std::unordered_map< std::string, MultipleQuestionBoxes> m_mqbs;
 
-	static sf::Texture loadSolidRectange(sf::Vector2f scale, float outlineThickness) noexcept;
-	static sf::Texture loadCheckBoxTexture(sf::Vector2f scale, float outlineThickness) noexcept;
-
 	inline static const std::string sliderCursorPrefixeIdentifier{ "_sb_" };
 	inline static const std::string sliderTextPrefixeIdentifier{ "_sb_" };
 
 	inline static const std::string checkedMqbPrefixeIdentifier{ "_cb_" };
 	inline static const std::string uncheckedMqbPrefixeIdentifier{ "_ub_" };
+
+friend class InterfaceState;
 };
 
 } // gui namespace
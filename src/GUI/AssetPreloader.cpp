@@ -0,0 +1,241 @@
+#include "AssetPreloader.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <filesystem>
+#include <optional>
+#include <thread>
+
+namespace gui
+{
+
+namespace
+{
+constexpr std::string_view imageExtensions[]{ ".png", ".jpg", ".jpeg", ".bmp", ".tga", ".gif", ".psd", ".hdr", ".pic" };
+constexpr std::string_view fontExtensions[]{ ".ttf", ".otf", ".ttc", ".pfb", ".pcf", ".fnt" };
+
+/// Returns `true` if the extension, in any case, is within the list.
+template<size_t N>
+bool hasExtension(std::string extension, const std::string_view (&extensions)[N])
+{
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return std::find(std::begin(extensions), std::end(extensions), extension) != std::end(extensions);
+}
+
+/// An asset decoded by a worker, waiting to be uploaded.
+struct Decoded
+{
+	std::optional<sf::Image> image; // For textures.
+	std::shared_ptr<const FontFile> font; // The mapped content of the file, for fonts.
+	std::string errorMessage; // Empty if it succeeded.
+};
+}
+
+AssetManifest AssetManifest::scan(std::string_view path, const std::vector<std::string>& excludedFolders)
+{
+	AssetManifest manifest{};
+	manifest.path = path;
+	std::error_code error{};
+
+	std::vector<std::string> skippedFolders{ excludedFolders };
+	for (const unsigned int tier : SpriteWrapper::getResolutionTiers())
+		skippedFolders.push_back(std::to_string(tier)); // The variants are loaded in place of their source.
+
+	for (std::filesystem::recursive_directory_iterator file{ path, error }, end{}; !error && file != end; file.increment(error))
+	{
+		const std::filesystem::path relativePath{ file->path().lexically_relative(path) };
+
+		if (file->is_directory(error))
+		{
+			if (std::find(skippedFolders.begin(), skippedFolders.end(), relativePath.generic_string()) != skippedFolders.end())
+				file.disable_recursion_pending();
+			continue;
+		}
+
+		if (!file->is_regular_file(error))
+			continue;
+
+		const std::string extension{ relativePath.extension().string() };
+		std::string name{ std::filesystem::path{ relativePath }.replace_extension().generic_string() };
+
+		if (hasExtension(extension, imageExtensions))
+			manifest.textures.push_back(Texture{ std::move(name), relativePath.generic_string() });
+		else if (hasExtension(extension, fontExtensions))
+			manifest.fonts.push_back(Font{ std::move(name), relativePath.generic_string() });
+	}
+
+	// The order of a directory iteration is unspecified.
+	std::sort(manifest.textures.begin(), manifest.textures.end(), [](const Texture& lhs, const Texture& rhs) { return lhs.name < rhs.name; });
+	std::sort(manifest.fonts.begin(), manifest.fonts.end(), [](const Font& lhs, const Font& rhs) { return lhs.name < rhs.name; });
+	return manifest;
+}
+
+std::string AssetPreloader::Report::summary() const
+{
+	std::ostringstream summary{};
+	summary << "Preloaded " << textures << " textures and " << fonts << " fonts (" << skipped << " skipped, " << failed << " failed) "
+			<< "with " << threads << " threads in " << total.count() / 1000.0 << " ms: "
+			<< decoding.count() / 1000.0 << " ms decoding, " << uploading.count() / 1000.0 << " ms uploading\n";
+
+	return summary.str();
+}
+
+AssetPreloader::Report AssetPreloader::preload(std::ostringstream& errorMessage, const AssetManifest& manifest, unsigned int threads) noexcept
+{
+	GUI_PROFILE_SCOPE("AssetPreloader::preload");
+	using Clock = std::chrono::steady_clock;
+	const Clock::time_point start{ Clock::now() };
+	Report report{};
+
+	try
+	{
+		// The lookups happen here, on the calling thread: the wrappers are not thread-safe.
+		std::vector<const AssetManifest::Texture*> textures{};
+		std::vector<TextureOptions> options{};
+		std::vector<std::pair<std::string, float>> files{}; // The variant to decode, and its resolution ratio.
+		std::vector<const AssetManifest::Font*> fonts{};
+
+		for (const auto& texture : manifest.textures)
+		{
+			auto mapIterator{ SpriteWrapper::s_accessToTextures.find(texture.name) };
+			if (mapIterator != SpriteWrapper::s_accessToTextures.end() && mapIterator->second->actualTexture != nullptr)
+			{
+				++report.skipped;
+				continue;
+			}
+
+			// Already registered: its own file, the one loaded again after an unload, wins over the manifest.
+			const bool isRegistered{ mapIterator != SpriteWrapper::s_accessToTextures.end() };
+			textures.push_back(&texture);
+			options.push_back((isRegistered) ? mapIterator->second->options : texture.options);
+			files.push_back(SpriteWrapper::resolveResolutionTier((isRegistered) ? mapIterator->second->fileName : texture.fileName, options.back(), manifest.path));
+		}
+
+		for (const auto& font : manifest.fonts)
+		{
+			if (TextWrapper::getFont(font.name) != nullptr)
+				++report.skipped;
+			else
+				fonts.push_back(&font);
+		}
+
+		// Decoding: each worker takes the next asset left, until none is.
+		const size_t assets{ textures.size() + fonts.size() };
+		std::vector<Decoded> decoded(assets);
+		std::atomic<size_t> next{ 0 };
+
+		threads = (threads == 0) ? std::max(std::thread::hardware_concurrency(), 1u) : threads;
+		report.threads = static_cast<unsigned int>(std::min<size_t>(threads, assets));
+
+		auto decode{ [&]() noexcept
+		{
+			for (size_t i{ next.fetch_add(1, std::memory_order_relaxed) }; i < assets; i = next.fetch_add(1, std::memory_order_relaxed))
+			{
+				try
+				{
+					if (i < textures.size())
+					{	// Only decoded into memory: OpenGL is not used by the workers.
+						const std::filesystem::path completePath{ std::filesystem::path(manifest.path) / files[i].first };
+						decoded[i].image.emplace();
+
+						if (!decoded[i].image->loadFromFile(completePath)) [[unlikely]]
+						{
+							decoded[i].image.reset();
+							decoded[i].errorMessage = "Failed to load texture from file " + completePath.string() + "\nThis texture cannot be displayed\n";
+						}
+					}
+					else
+					{	// Only read: the font is opened from its content once the duplicates are known.
+						std::ostringstream fontErrorMessage{};
+						decoded[i].font = readFontFile(fontErrorMessage, fonts[i - textures.size()]->fileName, manifest.path);
+						decoded[i].errorMessage = fontErrorMessage.str();
+					}
+				}
+				catch (const std::exception&)
+				{	// Only std::bad_alloc is expected.
+					decoded[i].image.reset();
+					decoded[i].font.reset();
+					decoded[i].errorMessage = "Not enough memory to preload an asset\n";
+				}
+			}
+		} };
+
+		{
+			std::vector<std::jthread> workers{};
+			workers.reserve(report.threads);
+
+			try
+			{	// The calling thread decodes too, so one fewer thread is created.
+				for (unsigned int i{ 1 }; i < report.threads; ++i)
+					workers.emplace_back(decode);
+			}
+			catch (const std::system_error&)
+			{}	// Fewer threads are used: the workers started take the remaining assets.
+
+			decode();
+		} // Joins the workers.
+
+		const Clock::time_point decodingEnd{ Clock::now() };
+		report.decoding = std::chrono::duration_cast<std::chrono::microseconds>(decodingEnd - start);
+
+		// Uploading, in one pass, in the order of the manifest.
+		for (size_t i{ 0 }; i < textures.size(); ++i)
+		{
+			sf::Texture texture{};
+			if (!decoded[i].image.has_value() || !texture.loadFromImage(*decoded[i].image)) [[unlikely]]
+			{
+				errorMessage << (decoded[i].errorMessage.empty() ? "Failed to upload texture " + files[i].first + "\nThis texture cannot be displayed\n" : decoded[i].errorMessage);
+				++report.failed;
+				continue;
+			}
+
+			GUI_PROFILE_COUNT(TextureLoads, 1);
+			texture.setSmooth(true);
+			SpriteWrapper::applyOptions(texture, options[i]);
+			decoded[i].image.reset(); // Frees the memory as soon as possible.
+
+			auto mapIterator{ SpriteWrapper::s_accessToTextures.find(textures[i]->name) };
+			if (mapIterator == SpriteWrapper::s_accessToTextures.end())
+			{	// Created with its file name, so it can be unloaded and loaded again.
+				SpriteWrapper::createTexture(textures[i]->name, textures[i]->fileName, textures[i]->shared, false, options[i]);
+				mapIterator = SpriteWrapper::s_accessToTextures.find(textures[i]->name);
+			}
+
+			mapIterator->second->actualTexture = std::make_unique<sf::Texture>(std::move(texture));
+			mapIterator->second->resolutionRatio = files[i].second;
+			++report.textures;
+		}
+
+		for (size_t i{ textures.size() }; i < assets; ++i)
+		{
+			if (decoded[i].font == nullptr) [[unlikely]]
+			{
+				errorMessage << decoded[i].errorMessage;
+				++report.failed;
+				continue;
+			}
+
+			try
+			{	// The files with the same content are opened once.
+				TextWrapper::createFont(fonts[i - textures.size()]->name, std::move(decoded[i].font));
+				++report.fonts;
+			}
+			catch (const LoadingGraphicalResourceFailure& error)
+			{
+				errorMessage << error.what();
+				++report.failed;
+			}
+		}
+
+		report.uploading = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - decodingEnd);
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected: the assets not preloaded are loaded at first use.
+		errorMessage << "Not enough memory to preload the assets\n";
+	}
+
+	report.total = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+	return report;
+}
+
+} // gui namespace
@@ -0,0 +1,154 @@
+/*******************************************************************
+ * \file   AssetPreloader.hpp, AssetPreloader.cpp
+ * \brief  Declare a manifest of the assets, and their loading in parallel at startup.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ *********************************************************************/
+
+#ifndef ASSETPRELOADER_HPP
+#define ASSETPRELOADER_HPP
+
+#include "GraphicalResources.hpp"
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gui
+{
+
+/**
+ * \brief Lists the textures and fonts to load at startup, under the names they will be used with.
+ *
+ * A manifest is either declared, by filling its lists, or built by scanning the assets folder.
+ *
+ * \see `AssetPreloader`.
+ */
+struct AssetManifest
+{
+	/// A texture, as `SpriteWrapper::createTexture` would create it.
+	struct Texture
+	{
+		std::string name;
+		std::string fileName; // Within the assets folder.
+		SpriteWrapper::Reserved shared{ SpriteWrapper::Reserved::No };
+		TextureOptions options{};
+	};
+
+	/// A font, as `TextWrapper::createFont` would create it.
+	struct Font
+	{
+		std::string name;
+		std::string fileName; // Within the assets folder.
+	};
+
+	std::vector<Texture> textures;
+	std::vector<Font> fonts;
+	std::string path{ "../assets/" }; // The assets folder.
+
+
+	/**
+	 * \brief Lists every image and font of a folder and its subfolders.
+	 * \complexity O(N) where N is the number of files.
+	 *
+	 * Each asset is named after its path within the folder, without extension: `buttons/play.png`
+	 * is the texture `buttons/play`. Textures are not reserved.
+	 *
+	 * The folders of the resolution tiers (see `SpriteWrapper::setResolutionTiers`) are skipped: they
+	 * hold variants of the textures, not textures of their own.
+	 *
+	 * \param[in] path The assets folder.
+	 * \param[in] excludedFolders Other folders to skip, relative to the assets folder, e.g. `"raw"`.
+	 *
+	 * \return The manifest, empty if the folder does not exist.
+	 *
+	 * \note Images are .png, .jpg, .jpeg, .bmp, .tga, .gif, .psd, .hdr and .pic files, as SFML can
+	 *		 read them. Fonts are .ttf, .otf, .ttc, .pfb, .pcf and .fnt files.
+	 * \note Declare the resolution tiers before scanning.
+	 */
+	[[nodiscard]] static AssetManifest scan(std::string_view path = "../assets/", const std::vector<std::string>& excludedFolders = {});
+};
+
+
+/**
+ * \brief Loads all the assets of a manifest at once, decoding them in parallel.
+ *
+ * Loading textures one by one, at first use, decodes each image on the thread that needs it, in
+ * the middle of a frame. The preloader decodes every image and reads every font file of a manifest
+ * across all cores, into memory, then creates the textures and opens the fonts in one pass on the
+ * calling thread, which must own the OpenGL context. Font files with the same content are opened once.
+ *
+ * The textures already created with a file name but not loaded (see `SpriteWrapper::createTexture`)
+ * are loaded too, with the options they were created with. The assets already loaded are skipped.
+ * The tiered textures are loaded in the selected resolution tier.
+ *
+ * \note This class is non-instantiable and only contains static methods.
+ *
+ * \see `AssetManifest`, `SpriteWrapper::createTexture`, `TextWrapper::createFont`.
+ *
+ * \code
+ * std::ostringstream errorMessage{};
+ * const auto report{ gui::AssetPreloader::preload(errorMessage, gui::AssetManifest::scan()) };
+ *
+ * std::cout << report.summary();
+ * if (report.failed != 0)
+ *     showErrorsUsingWindow("Assets", errorMessage);
+ * \endcode
+ */
+class AssetPreloader
+{
+public:
+
+	/// The timing report of a preload.
+	struct Report
+	{
+		size_t textures{ 0 }; // Loaded by this preload.
+		size_t fonts{ 0 }; // Loaded by this preload.
+		size_t skipped{ 0 }; // Already loaded.
+		size_t failed{ 0 }; // See the error message.
+		unsigned int threads{ 0 }; // Used to decode.
+
+		std::chrono::microseconds decoding{}; // Wall time to decode every asset, in parallel.
+		std::chrono::microseconds uploading{}; // Time to create the textures and register everything.
+		std::chrono::microseconds total{};
+
+		/**
+		 * \complexity O(1).
+		 *
+		 * \return The report, on one line.
+		 */
+		[[nodiscard]] std::string summary() const;
+	};
+
+
+	AssetPreloader() noexcept = delete;
+	AssetPreloader(const AssetPreloader&) noexcept = delete;
+	AssetPreloader(AssetPreloader&&) noexcept = delete;
+	AssetPreloader& operator=(const AssetPreloader&) noexcept = delete;
+	AssetPreloader& operator=(AssetPreloader&&) noexcept = delete;
+	~AssetPreloader() noexcept = delete;
+
+
+	/**
+	 * \brief Loads the textures and fonts of a manifest.
+	 * \complexity O(N / T + N) where N is the size of the assets, and T the number of threads: the
+	 *			   decoding is split, the upload is not.
+	 *
+	 * \param[out] errorMessage Contains the reason of each failure, if any.
+	 * \param[in] manifest The assets to load.
+	 * \param[in] threads The number of threads decoding, 0 for one per core.
+	 *
+	 * \return The timing report. The assets that failed are not created, the others are.
+	 *
+	 * \note Call it from the thread that draws: the textures are created on it.
+	 */
+	[[nodiscard]] static Report preload(std::ostringstream& errorMessage, const AssetManifest& manifest, unsigned int threads = 0) noexcept;
+};
+
+} // gui namespace
+
+#endif //ASSETPRELOADER_HPP
@@ -1,11 +1,14 @@
 #include "BasicInterface.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <utility>
 
 namespace gui
 {
 
-BasicInterface::BasicInterface(sf::RenderWindow* window, unsigned int relativeScalingDefinition) noexcept
-	: m_window{ window }, m_texts{}, m_sprites{}, m_relativeScalingDefinition{ relativeScalingDefinition }
+BasicInterface::BasicInterface(sf::RenderTarget* window, unsigned int relativeScalingDefinition) noexcept
+	: m_window{ window }, m_texts{}, m_sprites{}, m_relativeScalingDefinition{ relativeScalingDefinition }, m_preparedChunks{}, m_preparedGeneration{ 0 }, m_prepared{ false }
 {
 	ENSURE_SFML_WINDOW_VALIDITY(m_window, "Precondition violated; the window is invalid in the constructor of BasicInterface");
 
@@ -15,6 +18,7 @@ BasicInterface::BasicInterface(sf::RenderWindow* window, unsigned int relativeSc
 
 BasicInterface::BasicInterface(BasicInterface&& other) noexcept
 	: m_window{ other.m_window }, m_texts{ std::move(other.m_texts) }, m_sprites{ std::move(other.m_sprites) }, m_relativeScalingDefinition{ other.m_relativeScalingDefinition }
+	, m_preparedChunks{ std::move(other.m_preparedChunks) }, m_preparedGeneration{ other.m_preparedGeneration }, m_prepared{ std::exchange(other.m_prepared, false) }
 {
 	const auto interfaceRange{ s_allInterfaces.equal_range(other.m_window) };
 	for (auto it{ interfaceRange.first }; it != interfaceRange.second; ++it)
@@ -80,6 +84,9 @@ BasicInterface& BasicInterface::operator=(BasicInterface&& other) noexcept
 	std::swap(this->m_texts, other.m_texts);
 	std::swap(this->m_sprites, other.m_sprites);
 	std::swap(this->m_relativeScalingDefinition, other.m_relativeScalingDefinition);
+	std::swap(this->m_preparedChunks, other.m_preparedChunks);
+	std::swap(this->m_preparedGeneration, other.m_preparedGeneration);
+	std::swap(this->m_prepared, other.m_prepared);
 
 	return *this;
 }
@@ -97,6 +104,7 @@ BasicInterface::~BasicInterface() noexcept
 	}
 
 	m_window = nullptr;
+	m_prepared = false;
 	m_sprites.clear();
 	m_texts.clear();
 }
@@ -111,6 +119,7 @@ void BasicInterface::addSprite(std::string_view textureName, sf::Vector2f pos, s
 
 	SpriteWrapper newSprite{ textureName, pos, scale * relativeScalingValue, rect, rot, alignment, color };
 	m_sprites.push_back(std::move(newSprite));
+	discardPreparedFrame();
 }
 
 void BasicInterface::addSprite(sf::Texture texture, sf::Vector2f pos, sf::Vector2f scale, sf::IntRect rect, sf::Angle rot, Alignment alignment, sf::Color color) noexcept
@@ -133,51 +142,243 @@ void BasicInterface::addSprite(sf::Texture texture, sf::Vector2f pos, sf::Vector
 void BasicInterface::draw() const noexcept
 {
 	ENSURE_SFML_WINDOW_VALIDITY(m_window, "The window is invalid in the function draw of BasicInterface");
+	GUI_PROFILE_SCOPE("BasicInterface::draw");
 
-	for (const auto& sprite : m_sprites)
-		if (!sprite.hide)
-			m_window->draw(sprite.getSprite());
+	const auto drawSprites{ [this](size_t first, size_t last) noexcept
+	{
+		for (size_t i{ first }; i < std::min(last, m_sprites.size()); ++i)
+		{
+			if (!m_sprites[i].hide)
+			{
+				m_window->draw(m_sprites[i].getSprite());
+				GUI_PROFILE_COUNT(DrawCalls, 1);
+				GUI_PROFILE_COUNT(ElementsDrawn, 1);
+			}
+		}
+	} };
+
+	// Stale if a texture it points to may have been freed since.
+	m_prepared = m_prepared && m_preparedGeneration == SpriteWrapper::getTexturesGeneration();
+	if (!m_prepared)
+		drawSprites(0, m_sprites.size());
+
+	for (size_t chunk{ 0 }; m_prepared && chunk < m_preparedChunks.size(); ++chunk)
+	{	// Only the submission is left: the vertices are ready, grouped by texture.
+		const PreparedChunk& prepared{ m_preparedChunks[chunk] };
+		if (!prepared.valid) [[unlikely]]
+		{
+			drawSprites(chunk * s_preparedChunkSize, (chunk + 1) * s_preparedChunkSize);
+			continue;
+		}
+
+		size_t firstVertex{ 0 };
+		for (const auto& batch : prepared.batches)
+		{
+			sf::RenderStates states{};
+			states.texture = batch.texture;
+			m_window->draw(prepared.vertices.data() + firstVertex, batch.vertexCount, sf::PrimitiveType::Triangles, states);
+			firstVertex += batch.vertexCount;
+			GUI_PROFILE_COUNT(DrawCalls, 1);
+			GUI_PROFILE_COUNT(ElementsDrawn, static_cast<std::int64_t>(batch.vertexCount / 6));
+		}
+	}
+	m_prepared = false; // The elements may change before the next draw.
 
 	for (const auto& text : m_texts)
+	{
 		if (!text.hide)
+		{
 			m_window->draw(text.getText());
+			GUI_PROFILE_COUNT(DrawCalls, 1);
+			GUI_PROFILE_COUNT(ElementsDrawn, 1);
+		}
+	}
+}
+
+void BasicInterface::prepareFrame(sf::RenderTarget* target, unsigned int threads) noexcept
+{
+	ENSURE_SFML_WINDOW_VALIDITY(target, "Precondition violated; The target is invalid in the function prepareFrame of BasicInterface");
+	GUI_PROFILE_SCOPE("BasicInterface::prepareFrame");
+
+	// Culling is skipped with a rotated view: its visible area is not a rect of the world.
+	const sf::View& view{ target->getView() };
+	std::optional<sf::FloatRect> visibleArea{};
+	if (view.getRotation() == sf::degrees(0))
+		visibleArea = sf::FloatRect{ view.getCenter() - view.getSize() / 2.f, view.getSize() };
+
+	try
+	{	// The chunks are allocated here: the threads only fill them.
+		std::vector<std::pair<BasicInterface*, size_t>> chunks{};
+		const auto interfaceRange{ s_allInterfaces.equal_range(target) };
+		for (auto it{ interfaceRange.first }; it != interfaceRange.second; ++it)
+		{
+			BasicInterface* curInterface{ it->second };
+			curInterface->m_prepared = false;
+			curInterface->m_preparedChunks.resize((curInterface->m_sprites.size() + s_preparedChunkSize - 1) / s_preparedChunkSize);
+
+			for (size_t chunk{ 0 }; chunk < curInterface->m_preparedChunks.size(); ++chunk)
+				chunks.emplace_back(curInterface, chunk);
+		}
+
+		const auto prepare{ [&chunks, &visibleArea](size_t i) noexcept { chunks[i].first->prepareChunk(chunks[i].second, visibleArea); } };
+		if (WorkStealingPool* pool{ poolOf(threads) }; pool != nullptr)
+			pool->parallelFor(chunks.size(), prepare);
+		else
+			for (size_t i{ 0 }; i < chunks.size(); ++i)
+				prepare(i);
+
+		for (auto it{ interfaceRange.first }; it != interfaceRange.second; ++it)
+		{
+			it->second->m_preparedGeneration = SpriteWrapper::getTexturesGeneration();
+			it->second->m_prepared = true;
+		}
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: the interfaces not prepared are drawn sprite by sprite.
+}
+
+void BasicInterface::prepareChunk(size_t chunk, const std::optional<sf::FloatRect>& visibleArea) noexcept
+{
+	PreparedChunk& prepared{ m_preparedChunks[chunk] };
+	prepared.vertices.clear(); // Keeps the memory: no allocation once the interface was prepared.
+	prepared.batches.clear();
+	prepared.valid = false;
+
+	try
+	{
+		const size_t last{ std::min((chunk + 1) * s_preparedChunkSize, m_sprites.size()) };
+		for (size_t i{ chunk * s_preparedChunkSize }; i < last; ++i)
+		{
+			if (m_sprites[i].hide)
+				continue;
+
+			// The corners of the sprite, as sf::Sprite places its vertices.
+			const sf::Sprite& sprite{ m_sprites[i].getSprite() };
+			const sf::Transform& transform{ sprite.getTransform() };
+			const sf::FloatRect rect{ sprite.getTextureRect() };
+			const sf::Vector2f size{ std::abs(rect.size.x), std::abs(rect.size.y) };
+
+			const std::array<sf::Vector2f, 4> corners{ transform.transformPoint(sf::Vector2f{ 0.f, 0.f }), transform.transformPoint(sf::Vector2f{ 0.f, size.y }),
+													   transform.transformPoint(sf::Vector2f{ size.x, 0.f }), transform.transformPoint(size) };
+
+			if (visibleArea.has_value())
+			{	// The bounds of the corners, as getGlobalBounds would compute them.
+				sf::Vector2f min{ corners[0] }, max{ corners[0] };
+				for (const sf::Vector2f corner : corners)
+				{
+					min = sf::Vector2f{ std::min(min.x, corner.x), std::min(min.y, corner.y) };
+					max = sf::Vector2f{ std::max(max.x, corner.x), std::max(max.y, corner.y) };
+				}
+
+				if (!visibleArea->findIntersection(sf::FloatRect{ min, max - min }).has_value() && !visibleArea->contains(min))
+					continue; // Outside of the view.
+			}
+
+			const std::array<sf::Vector2f, 4> texCoords{ rect.position, rect.position + sf::Vector2f{ 0.f, rect.size.y },
+														 rect.position + sf::Vector2f{ rect.size.x, 0.f }, rect.position + rect.size };
+
+			const sf::Texture* texture{ &sprite.getTexture() };
+			if (prepared.batches.empty() || prepared.batches.back().texture != texture)
+				prepared.batches.push_back(PreparedChunk::Batch{ texture, 0 });
+
+			// The strip 0, 1, 2, 3 of sf::Sprite, as two triangles.
+			for (const size_t corner : { 0, 1, 2, 2, 1, 3 })
+				prepared.vertices.push_back(sf::Vertex{ corners[corner], sprite.getColor(), texCoords[corner] });
+
+			prepared.batches.back().vertexCount += 6;
+		}
+
+		prepared.valid = true;
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: the sprites of the chunk are drawn one by one.
 }
 
-void BasicInterface::proportionKeeper(sf::RenderWindow* resizedWindow, sf::Vector2f scaleFactor, float relativeMinAxisScale) noexcept
+WorkStealingPool* BasicInterface::poolOf(unsigned int threads) noexcept
+{
+	try
+	{
+		if (s_pool == nullptr || s_poolThreads != threads)
+		{
+			s_pool.reset(); // Joins the previous threads first.
+			s_pool = std::make_unique<WorkStealingPool>(threads);
+			s_poolThreads = threads;
+		}
+
+		return s_pool.get();
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected.
+		return nullptr;
+	}
+}
+
+void BasicInterface::targetResized(sf::RenderTarget* resizedTarget, sf::Vector2u previousSize, sf::Vector2u newSize) noexcept
+{
+	ENSURE_NOT_ZERO(previousSize.x, "Precondition violated; The previous size is invalid in the function targetResized of BasicInterface");
+	ENSURE_NOT_ZERO(previousSize.y, "Precondition violated; The previous size is invalid in the function targetResized of BasicInterface");
+	ENSURE_NOT_ZERO(newSize.x, "Precondition violated; The new size is invalid in the function targetResized of BasicInterface");
+	ENSURE_NOT_ZERO(newSize.y, "Precondition violated; The new size is invalid in the function targetResized of BasicInterface");
+
+	const sf::Vector2f scaleFactor{ newSize.x / static_cast<float>(previousSize.x), newSize.y / static_cast<float>(previousSize.y) };
+	const float relativeMinAxisScale{ static_cast<float>(std::min(newSize.x, newSize.y)) / std::min(previousSize.x, previousSize.y) };
+	proportionKeeper(resizedTarget, scaleFactor, relativeMinAxisScale);
+}
+
+void BasicInterface::proportionKeeper(sf::RenderTarget* resizedWindow, sf::Vector2f scaleFactor, float relativeMinAxisScale) noexcept
 {	
 	ENSURE_SFML_WINDOW_VALIDITY(resizedWindow, "Precondition violated; The window is invalid in the function proportionKeeper of BasicInterface");
 	ENSURE_NOT_ZERO(relativeMinAxisScale, "Precondition violated; relativeMinAxisScale is equal to 0 in proportionKeeper of BasicInterface");
 	ENSURE_NOT_ZERO(scaleFactor.x, "Precondition violated; scale factor is equal to 0 in the function proportionKeeper of BasicInterface");
 	ENSURE_NOT_ZERO(scaleFactor.y, "Precondition violated; scale factor is equal to 0 in the function proportionKeeper of BasicInterface");
-
-	const sf::Vector2f minScaling2f{ relativeMinAxisScale, relativeMinAxisScale };
+	GUI_PROFILE_SCOPE("BasicInterface::proportionKeeper");
 
 	const auto interfaceRange{ s_allInterfaces.equal_range(resizedWindow) }; // All interfaces associated with the resized window.
-	for (auto it{ interfaceRange.first }; it != interfaceRange.second; ++it)
-	{
-		auto* curInterface{ it->second };
 
-		if (curInterface->m_relativeScalingDefinition == 0)
-			continue; // No scaling definition, so no need to scale.
+	try
+	{	// The interfaces are independent: each one is rescaled by a thread of the pool.
+		std::vector<BasicInterface*> interfaces{};
+		for (auto it{ interfaceRange.first }; it != interfaceRange.second; ++it)
+			if (it->second->m_relativeScalingDefinition != 0) // No scaling definition, so no need to scale.
+				interfaces.push_back(it->second);
 
-		// Updating texts.
-		sf::Vector2f pos{};
-		for (auto& text : curInterface->m_texts)
+		WorkStealingPool* pool{ (interfaces.size() > 1) ? poolOf(s_poolThreads) : nullptr };
+		if (pool != nullptr)
 		{
-			text.scale(minScaling2f);
-
-			pos = text.getText().getPosition();
-			text.setPosition(sf::Vector2f{ pos.x * scaleFactor.x, pos.y * scaleFactor.y }); // Update position to match the new scale.
+			pool->parallelFor(interfaces.size(), [&](size_t i) noexcept { interfaces[i]->keepProportions(scaleFactor, relativeMinAxisScale); });
+			return;
 		}
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: the interfaces are rescaled one by one.
 
-		// Updating sprites.
-		for (auto& sprite : curInterface->m_sprites)
-		{
-			sprite.scale(minScaling2f);
+	for (auto it{ interfaceRange.first }; it != interfaceRange.second; ++it)
+		if (it->second->m_relativeScalingDefinition != 0)
+			it->second->keepProportions(scaleFactor, relativeMinAxisScale);
+}
 
-			pos = sprite.getSprite().getPosition();
-			sprite.setPosition(sf::Vector2f{ pos.x * scaleFactor.x, pos.y * scaleFactor.y }); // Update position to match the new scale.
-		}
+void BasicInterface::keepProportions(sf::Vector2f scaleFactor, float relativeMinAxisScale) noexcept
+{
+	const sf::Vector2f minScaling2f{ relativeMinAxisScale, relativeMinAxisScale };
+
+	// Updating texts.
+	sf::Vector2f pos{};
+	for (auto& text : m_texts)
+	{
+		text.scale(minScaling2f);
+
+		pos = text.getText().getPosition();
+		text.setPosition(sf::Vector2f{ pos.x * scaleFactor.x, pos.y * scaleFactor.y }); // Update position to match the new scale.
+	}
+
+	// Updating sprites.
+	discardPreparedFrame();
+	for (auto& sprite : m_sprites)
+	{
+		sprite.scale(minScaling2f);
+
+		pos = sprite.getSprite().getPosition();
+		sprite.setPosition(sf::Vector2f{ pos.x * scaleFactor.x, pos.y * scaleFactor.y }); // Update position to match the new scale.
 	}
 }
 
@@ -13,7 +13,11 @@
 #define BASICINTERFACE_HPP
 
 #include "GraphicalResources.hpp"
+#include "RenderTargetPool.hpp"
+#include "WorkStealingPool.hpp"
 #include <SFML/Graphics.hpp>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -84,6 +88,7 @@ public:
 	 * \complexity O(1)
 	 *
 	 * \param[in,out] window A valid pointer to the SFML window where interface elements will be rendered.
+	 *				  Any render target works, e.g. an `sf::RenderTexture` to render offscreen.
 	 * \param[in] relativeScalingDefinition A scaling baseline to ensure consistent visual proportions across
 	 *			  various window sizes. Scales of `sf::Transformable` elements are adjusted based on the window size
 	 *			  relative to this reference value:
@@ -104,9 +109,9 @@ public:
 	 * \pre `window` must be a valid.
 	 * \warning The program will assert otherwise.
 	 */
-	explicit BasicInterface(sf::RenderWindow* window, unsigned int relativeScalingDefinition = 1080) noexcept;
+	explicit BasicInterface(sf::RenderTarget* window, unsigned int relativeScalingDefinition = 1080) noexcept;
 
-	inline BasicInterface() noexcept : m_window{ nullptr }, m_texts{}, m_sprites{}, m_relativeScalingDefinition{ 1080 } {}
+	inline BasicInterface() noexcept : m_window{ nullptr }, m_texts{}, m_sprites{}, m_relativeScalingDefinition{ 1080 }, m_preparedChunks{}, m_preparedGeneration{ 0 }, m_prepared{ false } {}
 	BasicInterface(const BasicInterface&) noexcept = delete;
 	BasicInterface(BasicInterface&& other) noexcept;
 	BasicInterface& operator=(const BasicInterface&) noexcept = delete;
@@ -191,10 +196,52 @@ public:
 	 * \brief Renders the interface. Texts are drawn above sprites.
 	 * \complexity O(N), where N is the number of graphical elements.
 	 * 
-	 * \see `sf::Drawable::draw()`.
+	 * If the frame was prepared with `prepareFrame`, the sprites are drawn from the vertices prepared:
+	 * those outside the view are skipped, and those following each other with the same texture are
+	 * drawn at once. The preparation is used by one draw only, and not at all if sprites were added,
+	 * removed or reordered since, if a dynamic sprite was accessed since, or if a texture was freed.
+	 * 
+	 * \see `sf::Drawable::draw()`, `prepareFrame`.
 	 */
 	void draw() const noexcept;
 
+	/**
+	 * \brief Prepares the next draw of every interface of a target, on several threads.
+	 * \complexity O(N / T), where N is the number of sprites in all interfaces associated with the
+	 *						 target, and T the number of threads.
+	 *
+	 * The work of a draw that does not need OpenGL is done here, shared between the threads of a
+	 * work-stealing pool: the transforms and the bounds of the sprites, culling against the view of
+	 * the target, and the vertices of those visible, grouped by texture. The calling thread works too,
+	 * then only submits the vertices when each interface is drawn.
+	 *
+	 * \param[in] target A valid pointer to the target whose interfaces will be drawn.
+	 * \param[in] threads The threads preparing the interfaces, the calling one included. 0 for one per
+	 *					  core. The pool is created again when it changes.
+	 *
+	 * \note Call it once all changes of the frame are done, and with the view the interfaces are drawn
+	 *		 with: what is drawn is what was prepared. Accessing a dynamic sprite afterwards, directly or
+	 *		 through `applyCommands`, makes its interface drawn sprite by sprite. A change made through a
+	 *		 pointer kept from before the preparation only shows at the next frame prepared.
+	 * \note The texts are drawn as before: computing their geometry may rasterize glyphs into the
+	 *		 texture of their font, which uses OpenGL.
+	 *
+	 * \pre `target` must be valid.
+	 * \warning The program will assert otherwise.
+	 *
+	 * \see `draw`, `WorkStealingPool`.
+	 *
+	 * \code
+	 * window.clear();
+	 * BGUI::prepareFrame(&window); // The HUD, the inventory and the chat, in parallel.
+	 * hud.draw();
+	 * inventory.draw();
+	 * chat.draw();
+	 * window.display();
+	 * \endcode
+	 */
+	static void prepareFrame(sf::RenderTarget* target, unsigned int threads = 0) noexcept;
+
 
 	/**
 	 * \brief Handles window rescaling and updates views/interfaces' drawables accordingly.
@@ -262,10 +309,39 @@ public:
 		resizedWindow->setSize(newSize);
 	}
 
+	/**
+	 * \brief Handles the resizing of a render target that is not a window, e.g. an `sf::RenderTexture`.
+	 * \complexity O(N), where N is the number of graphical elements in all interfaces associated
+	 *					 with the resized target (if their 'relativeScalingDefinition's were not set to 0).
+	 *
+	 * Rescales and repositions the interfaces' drawables as `windowResized` does, but leaves the
+	 * target and its view untouched: resize it yourself.
+	 *
+	 * \param[in] resizedTarget A valid pointer to the target that was resized.
+	 * \param[in] previousSize The target's size before resizing.
+	 * \param[in] newSize The target's size after resizing.
+	 *
+	 * \pre Both sizes must be valid.
+	 * \warning The program will assert otherwise.
+	 *
+	 * \see `windowResized`.
+	 */
+	static void targetResized(sf::RenderTarget* resizedTarget, sf::Vector2u previousSize, sf::Vector2u newSize) noexcept;
+
 protected:
 
-	/// Pointer to the window.
-	mutable sf::RenderWindow* m_window;
+	/**
+	 * \brief Makes the next draw ignore the frame prepared. To call whenever a sprite may be modified.
+	 * \complexity O(1).
+	 */
+	inline void discardPreparedFrame() noexcept
+	{
+		m_prepared = false;
+	}
+
+
+	/// Pointer to the window, or to the render target the interface is drawn on.
+	mutable sf::RenderTarget* m_window;
 	/// Collection of texts in the interface.
 	std::vector<TextWrapper> m_texts;
 	/// Collection of sprites in the interface.
@@ -281,6 +357,56 @@ protected:
 
 private:
 
+	/**
+	 * \brief The vertices of a chunk of consecutive sprites, prepared to be drawn by `prepareFrame`.
+	 */
+	struct PreparedChunk
+	{
+		/// Consecutive vertices sharing a texture, drawn at once.
+		struct Batch
+		{
+			const sf::Texture* texture;
+			size_t vertexCount;
+		};
+
+		std::vector<sf::Vertex> vertices{}; // Two triangles per visible sprite.
+		std::vector<Batch> batches{};
+		bool valid{ false }; // False if there was not enough memory: its sprites are drawn one by one.
+	};
+
+	/// The sprites prepared by the same thread, at most. Large enough to outweigh taking it from a queue.
+	inline static constexpr size_t s_preparedChunkSize{ 256 };
+
+
+	/**
+	 * \brief Prepares the vertices of a chunk of sprites.
+	 * \complexity O(C), where C is the size of a chunk.
+	 *
+	 * \param[in] chunk The index of the chunk.
+	 * \param[in] visibleArea The area seen by the view, or nothing to draw every sprite.
+	 *
+	 * \note Only reads the sprites and writes the chunk: chunks can be prepared in parallel.
+	 */
+	void prepareChunk(size_t chunk, const std::optional<sf::FloatRect>& visibleArea) noexcept;
+
+	/**
+	 * \brief Rescales and repositions the elements of this interface, as `proportionKeeper` does.
+	 * \complexity O(N), where N is the number of graphical elements of the interface.
+	 *
+	 * \note Only modifies this interface: interfaces can be rescaled in parallel.
+	 */
+	void keepProportions(sf::Vector2f scaleFactor, float relativeMinAxisScale) noexcept;
+
+	/**
+	 * \brief Returns the pool shared by the interfaces, created if needed.
+	 * \complexity O(T) if it is created, where T is the number of threads, O(1) otherwise.
+	 *
+	 * \param[in] threads The threads asked for, 0 for one per core.
+	 *
+	 * \return The pool, or nullptr if there is not enough memory.
+	 */
+	[[nodiscard]] static WorkStealingPool* poolOf(unsigned int threads) noexcept;
+
 	/**
 	 * \brief Modifies the window' interfaces drawables after resizement.
 	 * \complexity O(N), where N is the number of graphical elements in all interfaces associated with
@@ -301,11 +427,22 @@ private:
 	 * \pre `scaleFactor` must not be equal to 0.
 	 * \warning The program will assert otherwise.
 	 */
-	static void proportionKeeper(sf::RenderWindow* resizedWindow, sf::Vector2f scaleFactor, float relativeMinAxisScale) noexcept;
+	static void proportionKeeper(sf::RenderTarget* resizedWindow, sf::Vector2f scaleFactor, float relativeMinAxisScale) noexcept;
+
 
+	/// The sprites prepared by `prepareFrame`, by chunk of `s_preparedChunkSize`.
+	std::vector<PreparedChunk> m_preparedChunks;
+	/// The generation of the textures when the chunks were prepared.
+	std::uint64_t m_preparedGeneration;
+	/// Tells if the next draw uses the prepared chunks.
+	mutable bool m_prepared;
 
 	/// Collection of all interfaces to perform resizing. Stored by window.
-	inline static std::unordered_multimap<sf::RenderWindow*, BasicInterface*> s_allInterfaces{};
+	inline static std::unordered_multimap<sf::RenderTarget*, BasicInterface*> s_allInterfaces{};
+	/// The threads preparing the interfaces, shared by all of them.
+	inline static std::unique_ptr<WorkStealingPool> s_pool{};
+	/// The threads asked for when the pool was created.
+	inline static unsigned int s_poolThreads{ 0 };
 };
 
 
@@ -317,29 +454,18 @@ concept Drawable = std::derived_from<std::remove_cvref_t<T>, sf::Drawable>
 && std::derived_from<std::remove_cvref_t<T>, sf::Transformable>;
 
 /**
+ * \brief Moves drawables so that, together, they begin at (0;0).
  * \complexity O(N), where N is the number of drawables passed as arguments.
- *  
- * From the given drawables, the function creates a texture that visually represents what
- * they look like if drawn separatly, in order. The texture size covers the distance between
- * the pixel at the leftmost/top edge of the leftmost/top drawable and the pixel at the
- * rightmost/bottom edge of the rightmost/bottom drawable, not beginning at (0;0). It accounts for
- * the drawables' transformables such as rotation, position...
- * 
- * \param[in] drawables: The drawables to create the texture from.
  *
- * \return Returns a texture created from the given drawables such as sprites, cricleShape, convexShape...
+ * \param[out] drawables: The drawables to move. Their origins are moved to 0;0, and their positions
+ *						  adjusted.
  *
- * \note The drawables' origins are moved to 0;0, and their positions are adjusted; therefore the
- *       drawables passed as arguments are very likely going to be modified.
- * \note If you create a texture from shapes, keep in mind that shapes are drawn differently than
- *		 sprites in SFML. Shapes use mathematical formulas to draw themselves, whereas sprites use arrays
- *		 of pixels (textures). While textures can be more detailed, they are also more pixelized. Be aware
- *		 that some sprites may have artefacts, which shapes usually don't have. For some reasons, this
- *	     seems to not be the case if the origins of such sprites are located at 0,0.
- * \note Consider generating a mipmap.
+ * \return The size of the texture covering them, rounded up.
+ *
+ * \see `createTextureFromDrawables`.
  */
 template<Drawable... Ts>
-sf::Texture createTextureFromDrawables(Ts&&... drawables) noexcept
+sf::Vector2u moveDrawablesToOrigin(Ts&&... drawables) noexcept
 {
 	// First, we need to calculate how much space the drawables will occupy in the render texture.
 
@@ -370,12 +496,47 @@ sf::Texture createTextureFromDrawables(Ts&&... drawables) noexcept
 	trueSize.x = ceilf(trueSize.x); // Round to prevent artifacts due to subpixels
 	trueSize.y = ceilf(trueSize.y);
 
-	sf::RenderTexture renderTexture{ static_cast<sf::Vector2u>(trueSize) };
-	renderTexture.clear(sf::Color::Transparent);
-	(renderTexture.draw(std::forward<Ts>(drawables)), ...);
-	renderTexture.display();
+	return static_cast<sf::Vector2u>(trueSize);
+}
+
+/**
+ * \complexity O(N), where N is the number of drawables passed as arguments.
+ *  
+ * From the given drawables, the function creates a texture that visually represents what
+ * they look like if drawn separatly, in order. The texture size covers the distance between
+ * the pixel at the leftmost/top edge of the leftmost/top drawable and the pixel at the
+ * rightmost/bottom edge of the rightmost/bottom drawable, not beginning at (0;0). It accounts for
+ * the drawables' transformables such as rotation, position...
+ * 
+ * \param[in] drawables: The drawables to create the texture from.
+ *
+ * \return Returns a texture created from the given drawables such as sprites, cricleShape, convexShape...
+ *
+ * \note The drawables' origins are moved to 0;0, and their positions are adjusted; therefore the
+ *       drawables passed as arguments are very likely going to be modified.
+ * \note If you create a texture from shapes, keep in mind that shapes are drawn differently than
+ *		 sprites in SFML. Shapes use mathematical formulas to draw themselves, whereas sprites use arrays
+ *		 of pixels (textures). While textures can be more detailed, they are also more pixelized. Be aware
+ *		 that some sprites may have artefacts, which shapes usually don't have. For some reasons, this
+ *	     seems to not be the case if the origins of such sprites are located at 0,0.
+ * \note Consider generating a mipmap.
+ * \note The render texture drawn into is taken from `RenderTargetPool`: creating many textures of
+ *		 the same size creates a single one. To generate many textures at once, see `TextureBatch`.
+ */
+template<Drawable... Ts>
+sf::Texture createTextureFromDrawables(Ts&&... drawables) noexcept
+{
+	const sf::Vector2u size{ moveDrawablesToOrigin(std::forward<Ts>(drawables)...) };
+
+	auto renderTexture{ RenderTargetPool::acquire(size) };
+	if (!renderTexture) [[unlikely]]
+		return sf::Texture{};
+
+	renderTexture->clear(sf::Color::Transparent);
+	(renderTexture->draw(std::forward<Ts>(drawables)), ...);
+	renderTexture->display();
 
-	sf::Texture texture{ renderTexture.getTexture() };
+	sf::Texture texture{ renderTexture->getTexture() };
 	texture.setSmooth(true);
 	return texture;
 }
@@ -0,0 +1,109 @@
+#include "CommandQueue.hpp"
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace gui
+{
+
+CommandQueue::CommandQueue(CommandQueue&& other) noexcept
+	: m_newest{ other.m_newest.exchange(nullptr, std::memory_order_acquire) }
+{}
+
+CommandQueue& CommandQueue::operator=(CommandQueue&& other) noexcept
+{
+	if (this != &other)
+		destroy(m_newest.exchange(other.m_newest.exchange(nullptr, std::memory_order_acquire), std::memory_order_acq_rel));
+
+	return *this;
+}
+
+CommandQueue::~CommandQueue() noexcept
+{
+	destroy(m_newest.load(std::memory_order_acquire));
+}
+
+bool CommandQueue::push(Command command) noexcept
+{
+	try
+	{
+		Node* node{ new Node{ std::move(command), m_newest.load(std::memory_order_relaxed) } };
+
+		// Nothing is ever taken from the middle of the chain: no ABA problem.
+		while (!m_newest.compare_exchange_weak(node->previous, node, std::memory_order_release, std::memory_order_relaxed))
+		{}	// Another thread pushed meanwhile: node->previous was updated, try again.
+
+		return true;
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected.
+		return false;
+	}
+}
+
+bool CommandQueue::setTextPosition(std::string identifier, sf::Vector2f position) noexcept
+{
+	return push(Command{ .type = Command::Type::TextPosition, .identifier = std::move(identifier), .position = position });
+}
+
+bool CommandQueue::setSpritePosition(std::string identifier, sf::Vector2f position) noexcept
+{
+	return push(Command{ .type = Command::Type::SpritePosition, .identifier = std::move(identifier), .position = position });
+}
+
+bool CommandQueue::hideText(std::string identifier, bool hidden) noexcept
+{
+	return push(Command{ .type = Command::Type::TextHidden, .identifier = std::move(identifier), .hidden = hidden });
+}
+
+bool CommandQueue::hideSprite(std::string identifier, bool hidden) noexcept
+{
+	return push(Command{ .type = Command::Type::SpriteHidden, .identifier = std::move(identifier), .hidden = hidden });
+}
+
+bool CommandQueue::switchToTexture(std::string identifier, size_t textureIndex) noexcept
+{
+	return push(Command{ .type = Command::Type::SpriteTexture, .identifier = std::move(identifier), .textureIndex = textureIndex });
+}
+
+bool CommandQueue::setSliderPosition(std::string identifier, float position) noexcept
+{
+	return push(Command{ .type = Command::Type::SliderPosition, .identifier = std::move(identifier), .sliderPosition = position });
+}
+
+std::vector<CommandQueue::Command> CommandQueue::drain()
+{
+	GUI_PROFILE_SCOPE("CommandQueue::drain");
+
+	// The whole chain at once: the producers go on pushing into an empty one.
+	Node* const newest{ m_newest.exchange(nullptr, std::memory_order_acquire) };
+	if (newest == nullptr)
+		return std::vector<Command>{};
+
+	struct Destroyer { Node* newest; ~Destroyer() noexcept { destroy(newest); } } destroyer{ newest };
+
+	// From the newest: the first command met of each kind for an element is the one kept.
+	std::array<std::unordered_set<std::string_view>, static_cast<size_t>(Command::Type::Count)> met{};
+	std::vector<Node*> kept{};
+
+	for (Node* node{ newest }; node != nullptr; node = node->previous)
+		if (met[static_cast<size_t>(node->command.type)].insert(node->command.identifier).second)
+			kept.push_back(node);
+
+	std::vector<Command> commands{};
+	commands.reserve(kept.size());
+	for (auto node{ kept.rbegin() }; node != kept.rend(); ++node)
+		commands.push_back(std::move((*node)->command)); // The sets are not used anymore: moving the identifiers is safe.
+
+	return commands;
+}
+
+void CommandQueue::destroy(Node* newest) noexcept
+{
+	while (newest != nullptr)
+		delete std::exchange(newest, newest->previous);
+}
+
+} // gui namespace
@@ -0,0 +1,190 @@
+/*******************************************************************
+ * \file   CommandQueue.hpp, CommandQueue.cpp
+ * \brief  Declare a queue of changes to an interface, pushed from any thread without locks.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ *********************************************************************/
+
+#ifndef COMMANDQUEUE_HPP
+#define COMMANDQUEUE_HPP
+
+#include "GraphicalResources.hpp"
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace gui
+{
+
+/**
+ * \brief Changes to the elements of an interface, pushed by any thread and applied by the one drawing it.
+ *
+ * The interfaces are not thread-safe: a networking or a simulation thread cannot edit a text while
+ * it is drawn. Instead, it pushes a command into the queue of the interface, without waiting for
+ * any lock. At the start of each frame, the drawing thread takes every command at once and applies
+ * them: see `MutableInterface::applyCommands`.
+ *
+ * The commands are absolute: only the last one of each kind for an element matters, so the others
+ * are dropped when the queue is drained. A thread updating a text 1000 times per second costs one
+ * change per frame.
+ *
+ * \note Any number of threads may push at once. Only one thread, the one drawing, may drain.
+ * \note Pushing allocates the command: it waits for no lock as long as the allocator does not.
+ * \note Do not move or destroy the interface while threads are pushing into its queue.
+ *
+ * \see `MutableInterface::getCommandQueue`, `MutableInterface::applyCommands`.
+ *
+ * \code
+ * gui::CommandQueue& commands{ myInterface.getCommandQueue() };
+ * std::jthread network{ [&commands](std::stop_token stop)
+ * {
+ *     while (!stop.stop_requested())
+ *         commands.setContent("ping", receivePing()); // Formatted here, on the network thread.
+ * } };
+ *
+ * while (window.isOpen())
+ * {
+ *     myInterface.applyCommands(); // The last ping only.
+ *     ...
+ * }
+ * \endcode
+ */
+class CommandQueue
+{
+public:
+
+	/**
+	 * \brief A change to an element of an interface, identified as when it was added.
+	 */
+	struct Command
+	{
+		enum class Type : std::uint8_t
+		{
+			TextContent, // The content of a dynamic text.
+			TextPosition, // The position of a dynamic text.
+			TextHidden, // Whether a dynamic text is hidden.
+			SpritePosition, // The position of a dynamic sprite.
+			SpriteHidden, // Whether a dynamic sprite is hidden.
+			SpriteTexture, // The index of the texture of a dynamic sprite, see `SpriteWrapper::switchToTexture`.
+			SliderPosition, // The position of the cursor of a slider, from 0 (bottom) to 1 (top).
+			Count
+		} type;
+
+		std::string identifier;
+		std::string content{}; // For the content of a text.
+		sf::Vector2f position{}; // For the position of a text or a sprite.
+		float sliderPosition{ 0.f }; // The position, not the value: the growth function cannot be inverted.
+		size_t textureIndex{ 0 };
+		bool hidden{ false };
+	};
+
+
+	CommandQueue() noexcept = default;
+	CommandQueue(const CommandQueue&) noexcept = delete;
+	CommandQueue(CommandQueue&& other) noexcept;
+	CommandQueue& operator=(const CommandQueue&) noexcept = delete;
+	CommandQueue& operator=(CommandQueue&& other) noexcept;
+
+	/// \complexity O(N) where N is the number of commands not drained.
+	~CommandQueue() noexcept;
+
+
+	/**
+	 * \brief Pushes a command, from any thread.
+	 * \complexity O(1), retried if another thread pushes at the same time.
+	 *
+	 * \param[in] command The change to apply at the next drain.
+	 *
+	 * \return `false` if there was not enough memory: the command is dropped.
+	 */
+	bool push(Command command) noexcept;
+
+	/**
+	 * \brief Pushes the content of a dynamic text, converted to a string on the calling thread.
+	 * \complexity O(1), retried if another thread pushes at the same time.
+	 *
+	 * \see `push`, `TextWrapper::setContent`.
+	 */
+	template<Ostreamable T>
+	inline bool setContent(std::string identifier, const T& content) noexcept
+	{
+		try
+		{
+			std::ostringstream oss{};
+			oss << content;
+			return push(Command{ .type = Command::Type::TextContent, .identifier = std::move(identifier), .content = oss.str() });
+		}
+		catch (const std::exception&)
+		{	// Only std::bad_alloc is expected.
+			return false;
+		}
+	}
+
+	/// \see `push`, `TransformableWrapper::setPosition`.
+	bool setTextPosition(std::string identifier, sf::Vector2f position) noexcept;
+
+	/// \see `push`, `TransformableWrapper::setPosition`.
+	bool setSpritePosition(std::string identifier, sf::Vector2f position) noexcept;
+
+	/// \see `push`, `TransformableWrapper::hide`.
+	bool hideText(std::string identifier, bool hidden = true) noexcept;
+
+	/// \see `push`, `TransformableWrapper::hide`.
+	bool hideSprite(std::string identifier, bool hidden = true) noexcept;
+
+	/// \see `push`, `SpriteWrapper::switchToTexture`.
+	bool switchToTexture(std::string identifier, size_t textureIndex) noexcept;
+
+	/// \see `push`, `Command::sliderPosition`.
+	bool setSliderPosition(std::string identifier, float position) noexcept;
+
+	/**
+	 * \brief Takes every command pushed so far, keeping only the last of each kind for each element.
+	 * \complexity O(N) where N is the number of commands pushed since the last drain.
+	 *
+	 * \return The commands kept, in the order they were pushed.
+	 *
+	 * \note Only the thread applying the commands may call it.
+	 *
+	 * \pre There should be enough memory.
+	 * \post The commands are returned.
+	 * \throw std::bad_alloc basic exception guarantee: the commands pushed so far are dropped.
+	 */
+	[[nodiscard]] std::vector<Command> drain();
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \return `true` if no command was pushed since the last drain. Others may push meanwhile.
+	 */
+	[[nodiscard]] inline bool empty() const noexcept
+	{
+		return m_newest.load(std::memory_order_relaxed) == nullptr;
+	}
+
+private:
+
+	/// A command pushed, linked to the one pushed before.
+	struct Node
+	{
+		Command command;
+		Node* previous;
+	};
+
+	/// Deletes a chain of commands, from the newest.
+	static void destroy(Node* newest) noexcept;
+
+
+	/// The last command pushed: the producers only ever push here, the consumer takes the whole chain.
+	std::atomic<Node*> m_newest{ nullptr };
+};
+
+} // gui namespace
+
+#endif //COMMANDQUEUE_HPP
@@ -0,0 +1,204 @@
+#include "GlyphCache.hpp"
+#include "../Save/BinaryUtils.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace gui
+{
+
+namespace
+{
+constexpr size_t headerSize{ 8 }; // Magic number, version, number of entries.
+constexpr size_t checksumSize{ 4 };
+constexpr size_t entryHeaderSize{ 2 + 4 + 1 + 4 }; // Name size, character size, bold, number of characters.
+
+/// Reads a whole file, empty if it cannot be read.
+std::string readFile(const std::filesystem::path& completePath)
+{
+	std::ifstream file{ completePath, std::ios::binary };
+	if (!file.is_open())
+		return std::string{};
+
+	return std::string{ std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{} };
+}
+}
+
+void GlyphCache::declare(std::string_view fontName, unsigned int characterSize, std::u32string_view characters, bool bold)
+{
+	Entry& entry{ entryOf(fontName, characterSize, bold) };
+	entry.characters.append(characters);
+	normalize(entry);
+}
+
+size_t GlyphCache::prewarm() noexcept
+{
+	size_t glyphs{ 0 };
+
+	for (const auto& entry : s_entries)
+	{
+		const sf::Font* font{ TextWrapper::getFont(entry.fontName) };
+		if (font == nullptr)
+			continue; // Not created yet, or no longer used.
+
+		for (const char32_t character : entry.characters)
+			static_cast<void>(font->getGlyph(character, entry.characterSize, entry.bold));
+
+		glyphs += entry.characters.size();
+	}
+
+	return glyphs;
+}
+
+void GlyphCache::startRecording() noexcept
+{
+	TextWrapper::s_contentRecorder = &record;
+}
+
+void GlyphCache::stopRecording() noexcept
+{
+	TextWrapper::s_contentRecorder = nullptr;
+}
+
+bool GlyphCache::load(std::string_view fileName, std::string_view path) noexcept
+{
+	try
+	{
+		const std::string file{ readFile(std::filesystem::path(path) / fileName) };
+		const std::string_view content{ file };
+
+		if (content.size() < headerSize + checksumSize
+		||  SafeSaves::readInteger<std::uint32_t>(content, 0) != magicNumber
+		||  SafeSaves::readInteger<std::uint16_t>(content, 4) != formatVersion
+		||  SafeSaves::readInteger<std::uint32_t>(content, content.size() - checksumSize) != SafeSaves::crc32(content.substr(0, content.size() - checksumSize))) [[unlikely]]
+			return false;
+
+		// Reads every entry before adding any: a corrupted file adds nothing.
+		const std::uint16_t count{ SafeSaves::readInteger<std::uint16_t>(content, 6) };
+		std::string_view entries{ content.substr(headerSize, content.size() - headerSize - checksumSize) };
+		std::vector<Entry> loaded{};
+		loaded.reserve(count);
+
+		for (std::uint16_t i{ 0 }; i < count; ++i)
+		{
+			if (entries.size() < entryHeaderSize) [[unlikely]]
+				return false;
+
+			const size_t nameSize{ SafeSaves::readInteger<std::uint16_t>(entries, 0) };
+			if (entries.size() < entryHeaderSize + nameSize) [[unlikely]]
+				return false;
+
+			Entry entry{ std::string{ entries.substr(2, nameSize) }, SafeSaves::readInteger<std::uint32_t>(entries, 2 + nameSize), SafeSaves::readInteger<std::uint8_t>(entries, 6 + nameSize) != 0, std::u32string{} };
+			const size_t characters{ SafeSaves::readInteger<std::uint32_t>(entries, 7 + nameSize) };
+			entries.remove_prefix(entryHeaderSize + nameSize);
+
+			if (entries.size() / 4 < characters) [[unlikely]]
+				return false;
+
+			entry.characters.resize(characters);
+			for (size_t j{ 0 }; j < characters; ++j)
+				entry.characters[j] = SafeSaves::readInteger<std::uint32_t>(entries, j * 4);
+
+			entries.remove_prefix(characters * 4);
+			loaded.push_back(std::move(entry));
+		}
+
+		if (!entries.empty()) [[unlikely]]
+			return false;
+
+		for (const auto& entry : loaded)
+			declare(entry.fontName, entry.characterSize, entry.characters, entry.bold);
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected.
+		return false;
+	}
+
+	return true;
+}
+
+bool GlyphCache::save(std::string_view fileName, std::string_view path) noexcept
+{
+	try
+	{
+		std::string content{};
+		SafeSaves::appendInteger<std::uint32_t>(content, magicNumber);
+		SafeSaves::appendInteger<std::uint16_t>(content, formatVersion);
+		SafeSaves::appendInteger<std::uint16_t>(content, static_cast<std::uint16_t>(std::min<size_t>(s_entries.size(), UINT16_MAX)));
+
+		for (size_t i{ 0 }; i < std::min<size_t>(s_entries.size(), UINT16_MAX); ++i)
+		{
+			const Entry& entry{ s_entries[i] };
+			const size_t nameSize{ std::min<size_t>(entry.fontName.size(), UINT16_MAX) };
+
+			SafeSaves::appendInteger<std::uint16_t>(content, static_cast<std::uint16_t>(nameSize));
+			content.append(entry.fontName, 0, nameSize);
+			SafeSaves::appendInteger<std::uint32_t>(content, entry.characterSize);
+			SafeSaves::appendInteger<std::uint8_t>(content, entry.bold);
+			SafeSaves::appendInteger<std::uint32_t>(content, static_cast<std::uint32_t>(entry.characters.size()));
+
+			for (const char32_t character : entry.characters)
+				SafeSaves::appendInteger<std::uint32_t>(content, character);
+		}
+
+		SafeSaves::appendInteger<std::uint32_t>(content, SafeSaves::crc32(content));
+
+		std::ofstream file{ std::filesystem::path(path) / fileName, std::ios::binary | std::ios::trunc };
+		file.write(content.data(), static_cast<std::streamsize>(content.size()));
+		return static_cast<bool>(file);
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected.
+		return false;
+	}
+}
+
+const std::vector<GlyphCache::Entry>& GlyphCache::entries() noexcept
+{
+	return s_entries;
+}
+
+void GlyphCache::clear() noexcept
+{
+	s_entries.clear();
+}
+
+void GlyphCache::record(const sf::Text& text) noexcept
+{
+	try
+	{
+		const std::string_view fontName{ TextWrapper::getFontName(&text.getFont()) };
+		if (fontName.empty())
+			return; // The default font of the wrapper, before the actual one is set.
+
+		Entry& entry{ entryOf(fontName, text.getCharacterSize(), (text.getStyle() & sf::Text::Bold) != 0) };
+
+		for (const char32_t character : text.getString().toUtf32())
+		{	// Kept sorted: the contents set are short, and mostly use characters already there.
+			const auto position{ std::lower_bound(entry.characters.begin(), entry.characters.end(), character) };
+			if (position == entry.characters.end() || *position != character)
+				entry.characters.insert(position, character);
+		}
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: these glyphs will be rasterized at first use.
+}
+
+GlyphCache::Entry& GlyphCache::entryOf(std::string_view fontName, unsigned int characterSize, bool bold)
+{
+	const auto entry{ std::find_if(s_entries.begin(), s_entries.end(), [&](const Entry& entry) { return entry.characterSize == characterSize && entry.bold == bold && entry.fontName == fontName; }) };
+	if (entry != s_entries.end())
+		return *entry;
+
+	s_entries.push_back(Entry{ std::string{ fontName }, characterSize, bold, std::u32string{} });
+	return s_entries.back();
+}
+
+void GlyphCache::normalize(Entry& entry)
+{
+	std::sort(entry.characters.begin(), entry.characters.end());
+	entry.characters.erase(std::unique(entry.characters.begin(), entry.characters.end()), entry.characters.end());
+}
+
+} // gui namespace
@@ -0,0 +1,170 @@
+/*******************************************************************
+ * \file   GlyphCache.hpp, GlyphCache.cpp
+ * \brief  Declare a cache of the glyphs used by the texts, rasterized at startup instead of first use.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ *********************************************************************/
+
+#ifndef GLYPHCACHE_HPP
+#define GLYPHCACHE_HPP
+
+#include "GraphicalResources.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gui
+{
+
+/**
+ * \brief Rasterizes the glyphs of the texts ahead of time, so no screen spikes when it first shows.
+ *
+ * `sf::Font` rasterizes each glyph the first time a text needs it, for each character size and
+ * style. As a `TextWrapper` computes its bounds when its content is set, building a screen rasterizes
+ * every glyph it shows, and the frame doing so spikes. This cache knows which glyphs are needed, for
+ * which (font, size, style), and rasterizes them all at startup with `prewarm`.
+ *
+ * The glyphs needed can be declared, or recorded while the game runs: every content set while
+ * recording is added to the cache. The cache is saved in a compact binary file next to the assets,
+ * and loaded at the next startup: the first run records, the next ones prewarm.
+ *
+ * \note This class is non-instantiable and only contains static methods.
+ * \note SFML cannot build a font from glyphs rasterized elsewhere: the file stores what to rasterize,
+ *		 not the bitmaps. The work still happens, but at startup, before any screen is built.
+ * \note Fonts are referred to by the name given to `TextWrapper::createFont`. Those not created when
+ *		 `prewarm` is called are skipped.
+ *
+ * \see `TextWrapper`, `sf::Font::getGlyph`.
+ *
+ * \code
+ * gui::TextWrapper::createFont("title", "title.ttf");
+ *
+ * if (!gui::GlyphCache::load()) // First run: no cache yet.
+ *     gui::GlyphCache::startRecording();
+ * gui::GlyphCache::declare("title", 64, U"0123456789"); // The score is never shown before it changes.
+ * gui::GlyphCache::prewarm();
+ *
+ * // Game loop...
+ *
+ * gui::GlyphCache::stopRecording();
+ * static_cast<void>(gui::GlyphCache::save());
+ * \endcode
+ */
+class GlyphCache
+{
+public:
+
+	/// The glyphs needed for a font, at a character size and style.
+	struct Entry
+	{
+		std::string fontName;
+		unsigned int characterSize;
+		bool bold;
+		std::u32string characters; // Sorted, without duplicates.
+	};
+
+
+	GlyphCache() noexcept = delete;
+	GlyphCache(const GlyphCache&) noexcept = delete;
+	GlyphCache(GlyphCache&&) noexcept = delete;
+	GlyphCache& operator=(const GlyphCache&) noexcept = delete;
+	GlyphCache& operator=(GlyphCache&&) noexcept = delete;
+	~GlyphCache() noexcept = delete;
+
+
+	/**
+	 * \brief Adds glyphs to the cache.
+	 * \complexity O(N log N) where N is the number of characters of the entry.
+	 *
+	 * \param[in] fontName The name of the font, as given to `TextWrapper::createFont`.
+	 * \param[in] characterSize The character size of the texts.
+	 * \param[in] characters The characters to rasterize.
+	 * \param[in] bold `true` for texts with the `sf::Text::Bold` style.
+	 */
+	static void declare(std::string_view fontName, unsigned int characterSize, std::u32string_view characters, bool bold = false);
+
+	/**
+	 * \brief Rasterizes every glyph of the cache whose font exists.
+	 * \complexity O(N) where N is the number of glyphs of the cache.
+	 *
+	 * \return The number of glyphs rasterized, or already rasterized.
+	 *
+	 * \note Call it once the fonts are created, before the first screen is built.
+	 */
+	static size_t prewarm() noexcept;
+
+	/**
+	 * \brief Adds the glyphs of every content set from now on, with `TextWrapper::setContent`.
+	 * \complexity O(1).
+	 *
+	 * \note Changing the font, size or style of a text after its content is not recorded.
+	 */
+	static void startRecording() noexcept;
+
+	/**
+	 * \brief Stops adding the glyphs of the contents set.
+	 * \complexity O(1).
+	 */
+	static void stopRecording() noexcept;
+
+	/**
+	 * \brief Adds the entries saved in a file to the cache.
+	 * \complexity O(N log N) where N is the number of glyphs in the file.
+	 *
+	 * \param[in] fileName The name of the file.
+	 * \param[in] path The folder of the file.
+	 *
+	 * \return `false` if the file does not exist or is corrupted. Nothing is added then.
+	 */
+	[[nodiscard]] static bool load(std::string_view fileName = "glyphs.cache", std::string_view path = "../assets/") noexcept;
+
+	/**
+	 * \brief Saves the cache in a file, replacing it.
+	 * \complexity O(N) where N is the number of glyphs of the cache.
+	 *
+	 * \param[in] fileName The name of the file.
+	 * \param[in] path The folder of the file.
+	 *
+	 * \return `false` if the file could not be written.
+	 */
+	[[nodiscard]] static bool save(std::string_view fileName = "glyphs.cache", std::string_view path = "../assets/") noexcept;
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \return The entries of the cache.
+	 */
+	[[nodiscard]] static const std::vector<Entry>& entries() noexcept;
+
+	/**
+	 * \brief Empties the cache. The glyphs already rasterized stay in their fonts.
+	 * \complexity O(N) where N is the number of entries.
+	 */
+	static void clear() noexcept;
+
+private:
+
+	/// Adds the glyphs of a text while recording.
+	static void record(const sf::Text& text) noexcept;
+
+	/// Returns the entry of a (font, size, style), created if needed.
+	[[nodiscard]] static Entry& entryOf(std::string_view fontName, unsigned int characterSize, bool bold);
+
+	/// Sorts the characters of an entry and removes the duplicates.
+	static void normalize(Entry& entry);
+
+
+	/// All entries, by (font, size, style).
+	inline static std::vector<Entry> s_entries{};
+
+	inline static constexpr std::uint32_t magicNumber{ 0x43474753 }; // "SGGC" in little endian.
+	inline static constexpr std::uint16_t formatVersion{ 1 };
+};
+
+} // gui namespace
+
+#endif //GLYPHCACHE_HPP
@@ -1,5 +1,10 @@
 #include "GraphicalResources.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
 #include <utility>
+#include "../Save/BinaryUtils.hpp"
+#include "../Exceptions.hpp"
 
 namespace gui
 {
@@ -99,7 +104,7 @@ void TransformableWrapper::create(sf::Transformable* transformable, sf::Vector2f
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 TextWrapper::TextWrapper(const TextWrapper& other) noexcept
-	: TransformableWrapper{}, m_wrappedText{ other.m_wrappedText }
+	: TransformableWrapper{}, m_wrappedText{ other.m_wrappedText }, m_font{ other.m_font }
 {
 	this->m_alignment = other.m_alignment;
 	this->hide = other.hide;
@@ -108,7 +113,7 @@ TextWrapper::TextWrapper(const TextWrapper& other) noexcept
 }
 
 TextWrapper::TextWrapper(TextWrapper&& other) noexcept
-	: TransformableWrapper{}, m_wrappedText{ std::move(other.m_wrappedText) }
+	: TransformableWrapper{}, m_wrappedText{ std::move(other.m_wrappedText) }, m_font{ other.m_font }
 {
 	std::swap(this->m_alignment, other.m_alignment);
 	std::swap(this->hide,		 other.hide);
@@ -120,6 +125,7 @@ TextWrapper::TextWrapper(TextWrapper&& other) noexcept
 TextWrapper& TextWrapper::operator=(const TextWrapper& other) noexcept
 {
 	this->m_wrappedText = other.m_wrappedText;
+	this->m_font =		  other.m_font;
 	this->m_alignment =	  other.m_alignment;
 	this->hide =		  other.hide;
 
@@ -131,6 +137,7 @@ TextWrapper& TextWrapper::operator=(const TextWrapper& other) noexcept
 TextWrapper& TextWrapper::operator=(TextWrapper&& other) noexcept
 {
 	std::swap(this->m_wrappedText, other.m_wrappedText);
+	std::swap(this->m_font,		   other.m_font);
 	std::swap(this->m_alignment,   other.m_alignment);
 	std::swap(this->hide,		   other.hide);
 
@@ -142,18 +149,20 @@ TextWrapper& TextWrapper::operator=(TextWrapper&& other) noexcept
 
 bool TextWrapper::setFont(std::string_view name) noexcept
 {
-	sf::Font* font{ getFont(name) };
+	const auto mapIterator{ s_accessToFonts.find(name) };
 
-	if (!font)
+	if (mapIterator == s_accessToFonts.end())
 		return false;
 
-	m_wrappedText.setFont(*font);
+	m_font = &mapIterator->second;
+	resolveFont();
 	return true;
 }
 
 void TextWrapper::setCharacterSize(unsigned int size) noexcept
 {
 	m_wrappedText.setCharacterSize(size);
+	resolveFont(); // Another page of glyphs.
 	m_wrappedText.setOrigin(computeNewOrigin(m_wrappedText.getLocalBounds(), m_alignment));
 }
 
@@ -179,11 +188,11 @@ void TextWrapper::createFont(std::string name, std::string_view fileName)
 		return;
 
 	std::ostringstream errorMessage{};
-	auto optFont{ loadFontFromFile(errorMessage, fileName) };
-	if (!optFont.has_value()) [[unlikely]]
+	auto content{ readFontFile(errorMessage, fileName) };
+	if (content == nullptr) [[unlikely]]
 		throw LoadingGraphicalResourceFailure{ errorMessage.str() };
 	
-	createFont(std::move(name), std::move(optFont.value()));
+	createFont(std::move(name), std::move(content));
 }
 
 void TextWrapper::createFont(std::string name, sf::Font font) noexcept
@@ -193,8 +202,57 @@ void TextWrapper::createFont(std::string name, sf::Font font) noexcept
 
 	// We add the font using push_front so we know that it is at the beginning.
 	// Therefore, using the function begin() we have a direct iterator pointing to it.
-	s_allFonts.push_front(std::move(font));
-	s_accessToFonts.insert(std::make_pair(std::move(name), s_allFonts.begin()));
+	s_allFonts.push_front(LoadedFont{ nullptr, std::move(font) });
+	s_accessToFonts.insert(std::make_pair(std::move(name), FontName{ s_allFonts.begin() }));
+}
+
+void TextWrapper::createFont(std::string name, std::shared_ptr<const FontFile> content)
+{
+	if (getFont(name) != nullptr)
+		return;
+
+	if (content == nullptr) [[unlikely]]
+		throw LoadingGraphicalResourceFailure{ "The font " + name + " has no content\nThis font cannot be displayed\n" };
+
+	// The same content: another name of the same font. The hash rules out the others without reading them.
+	const auto sameContent{ std::find_if(s_allFonts.begin(), s_allFonts.end(), [&content](const LoadedFont& loadedFont)
+		{ return loadedFont.content != nullptr && loadedFont.content->hash == content->hash && loadedFont.content->mapping.view() == content->mapping.view(); }) };
+
+	if (sameContent != s_allFonts.end())
+	{
+		s_accessToFonts.insert(std::make_pair(std::move(name), FontName{ sameContent }));
+		++sameContent->names;
+		return;
+	}
+
+	sf::Font font{};
+	const std::string_view view{ content->mapping.view() };
+	if (!font.openFromMemory(view.data(), view.size())) [[unlikely]]
+		throw LoadingGraphicalResourceFailure{ "Failed to open the font " + name + " from its content\nThis font cannot be displayed\n" };
+
+	font.setSmooth(true);
+	s_allFonts.push_front(LoadedFont{ std::move(content), std::move(font) });
+
+	try
+	{
+		s_accessToFonts.insert(std::make_pair(std::move(name), FontName{ s_allFonts.begin() }));
+	}
+	catch (...)
+	{	// Strong exception guarantee.
+		s_allFonts.pop_front();
+		throw;
+	}
+}
+
+bool TextWrapper::setFontFallbacks(std::string_view name, std::vector<std::string> fallbacks) noexcept
+{
+	const auto mapIterator{ s_accessToFonts.find(name) };
+
+	if (mapIterator == s_accessToFonts.end())
+		return false;
+
+	mapIterator->second.fallbacks = std::move(fallbacks);
+	return true;
 }
 
 void TextWrapper::removeFont(std::string_view name) noexcept
@@ -204,7 +262,8 @@ void TextWrapper::removeFont(std::string_view name) noexcept
 	if (mapIterator == s_accessToFonts.end())
 		return;
 
-	s_allFonts.erase(mapIterator->second); // First, removing the actual font.
+	if (--mapIterator->second.font->names == 0)
+		s_allFonts.erase(mapIterator->second.font); // First, removing the actual font, if it has no other name.
 	s_accessToFonts.erase(mapIterator); // Then, the accessing item within the map.
 }
 
@@ -215,7 +274,80 @@ sf::Font* TextWrapper::getFont(std::string_view name) noexcept
 	if (mapIterator == s_accessToFonts.end()) [[unlikely]]
 		return nullptr;
 
-	return &*mapIterator->second;
+	return &mapIterator->second.font->font;
+}
+
+std::string_view TextWrapper::getFontName(const sf::Font* font) noexcept
+{
+	for (const auto& [name, fontName] : s_accessToFonts)
+		if (&fontName.font->font == font)
+			return name;
+
+	return std::string_view{};
+}
+
+TextWrapper::FontMemory TextWrapper::getFontMemory(std::string_view name) noexcept
+{
+	const auto mapIterator{ s_accessToFonts.find(name) };
+
+	if (mapIterator == s_accessToFonts.end())
+		return FontMemory{};
+
+	const LoadedFont& loadedFont{ *mapIterator->second.font };
+	FontMemory memory{};
+	memory.content = (loadedFont.content != nullptr) ? loadedFont.content->mapping.view().size() : 0;
+	memory.characterSizes = loadedFont.characterSizes.size();
+
+	for (const unsigned int characterSize : loadedFont.characterSizes)
+	{
+		const sf::Vector2u size{ loadedFont.font.getTexture(characterSize).getSize() };
+		memory.glyphPages += static_cast<size_t>(size.x) * size.y * 4;
+	}
+
+	return memory;
+}
+
+void TextWrapper::resolveFont() noexcept
+{
+	if (m_font == nullptr) [[unlikely]]
+		return; // Still the default font.
+
+	LoadedFont* chosen{ &*m_font->font };
+
+	if (!m_font->fallbacks.empty())
+	{	// The first font of the chain missing no glyph, or the one missing the fewest.
+		const sf::String& content{ m_wrappedText.getString() };
+		const auto missingGlyphs{ [&content](const sf::Font& font)
+		{
+			return std::count_if(content.begin(), content.end(), [&font](char32_t character) { return character >= U' ' && !font.hasGlyph(character); });
+		} };
+
+		auto fewestMissing{ missingGlyphs(chosen->font) };
+		for (auto fallback{ m_font->fallbacks.begin() }; fewestMissing != 0 && fallback != m_font->fallbacks.end(); ++fallback)
+		{
+			const auto mapIterator{ s_accessToFonts.find(*fallback) };
+			if (mapIterator == s_accessToFonts.end())
+				continue; // Not created, or removed.
+
+			const auto missing{ missingGlyphs(mapIterator->second.font->font) };
+			if (missing < fewestMissing)
+			{
+				fewestMissing = missing;
+				chosen = &*mapIterator->second.font;
+			}
+		}
+	}
+
+	m_wrappedText.setFont(chosen->font);
+
+	try
+	{	// Few sizes per font: a vector is faster than a set.
+		const unsigned int characterSize{ m_wrappedText.getCharacterSize() };
+		if (std::find(chosen->characterSizes.begin(), chosen->characterSizes.end(), characterSize) == chosen->characterSizes.end())
+			chosen->characterSizes.push_back(characterSize);
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: the page is not counted by getFontMemory.
 }
 
 
@@ -243,6 +375,29 @@ std::optional<sf::Font> loadFontFromFile(std::ostringstream& errorMessage, std::
 	}
 }
 
+std::shared_ptr<const FontFile> readFontFile(std::ostringstream& errorMessage, std::string_view fileName, std::string_view path) noexcept
+{
+	try
+	{
+		const std::filesystem::path completePath{ std::filesystem::path(path) / fileName };
+		SafeSaves::MappedFile mapping{ completePath.string() };
+
+		const std::uint64_t hash{ SafeSaves::hash64(mapping.view()) };
+		return std::make_shared<const FontFile>(FontFile{ std::move(mapping), hash });
+	}
+	catch (const SafeSaves::FileFailure& error)
+	{
+		errorMessage << "Failed to read font from file: " << error.what() << '\n';
+		errorMessage << "This font cannot be displayed\n";
+		return nullptr;
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected.
+		errorMessage << "Not enough memory to read the font " << fileName << "\nThis font cannot be displayed\n";
+		return nullptr;
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /// A `sf::Text` wrapper.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -251,8 +406,18 @@ std::optional<sf::Font> loadFontFromFile(std::ostringstream& errorMessage, std::
 /// A `sf::Sprite` wrapper.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+/// Scales a rect given for the source resolution to a texture of a resolution tier.
+static sf::IntRect scaleRect(sf::IntRect rect, float ratio) noexcept
+{
+	if (ratio == 1.f) [[likely]]
+		return rect;
+
+	const auto scale{ [ratio](int value) { return static_cast<int>(std::lround(static_cast<float>(value) * ratio)); } };
+	return sf::IntRect{ { scale(rect.position.x), scale(rect.position.y) }, { scale(rect.size.x), scale(rect.size.y) } };
+}
+
 SpriteWrapper::SpriteWrapper(std::string_view textureName, sf::Vector2f pos, sf::Vector2f scale, sf::IntRect rect, sf::Angle rot, Alignment alignment, sf::Color color)
-	: TransformableWrapper{}, m_wrappedSprite{ s_defaultTexture }, m_curTextureIndex{ 0 }, m_textures{}, m_uniqueTextures{}
+	: TransformableWrapper{}, m_wrappedSprite{ s_defaultTexture }, m_resolutionRatio{ 1.f }, m_curTextureIndex{ 0 }, m_textures{}, m_uniqueTextures{}
 {
 	create(&m_wrappedSprite, pos, scale, rot, alignment);
 
@@ -265,7 +430,7 @@ SpriteWrapper::SpriteWrapper(std::string_view textureName, sf::Vector2f pos, sf:
 }
 
 SpriteWrapper::SpriteWrapper(SpriteWrapper&& other) noexcept
-	: TransformableWrapper{}, m_wrappedSprite{ std::move(other.m_wrappedSprite) }, m_curTextureIndex{ other.m_curTextureIndex }, m_textures{ std::move(other.m_textures) }, m_uniqueTextures{ std::move(other.m_uniqueTextures) }
+	: TransformableWrapper{}, m_wrappedSprite{ std::move(other.m_wrappedSprite) }, m_resolutionRatio{ other.m_resolutionRatio }, m_curTextureIndex{ other.m_curTextureIndex }, m_textures{ std::move(other.m_textures) }, m_uniqueTextures{ std::move(other.m_uniqueTextures) }
 {
 	std::swap(this->m_alignment, other.m_alignment);
 	std::swap(this->hide,		 other.hide);
@@ -277,6 +442,7 @@ SpriteWrapper::SpriteWrapper(SpriteWrapper&& other) noexcept
 SpriteWrapper& SpriteWrapper::operator=(SpriteWrapper&& other) noexcept
 {
 	std::swap(this->m_wrappedSprite,   other.m_wrappedSprite);
+	std::swap(this->m_resolutionRatio, other.m_resolutionRatio);
 	std::swap(this->m_curTextureIndex, other.m_curTextureIndex);
 	std::swap(this->m_textures,		   other.m_textures);
 	std::swap(this->m_uniqueTextures,  other.m_uniqueTextures);
@@ -291,6 +457,9 @@ SpriteWrapper& SpriteWrapper::operator=(SpriteWrapper&& other) noexcept
 
 SpriteWrapper::~SpriteWrapper() noexcept
 {
+	if (!m_uniqueTextures.empty())
+		++s_texturesGeneration;
+
 	for (auto& reservedTexture : m_uniqueTextures)
 	{
 		auto mapAccessIterator{ s_accessToTextures.find(reservedTexture) };
@@ -314,6 +483,11 @@ void SpriteWrapper::setAlignment(Alignment alignment) noexcept
 	m_wrappedSprite.setOrigin(computeNewOrigin(m_wrappedSprite.getLocalBounds(), m_alignment));
 }
 
+void SpriteWrapper::setScale(sf::Vector2f scale) noexcept
+{
+	TransformableWrapper::setScale(scale / m_resolutionRatio);
+}
+
 void SpriteWrapper::switchToNextTexture(long long indexOffset)
 {
 	const long long totalIndex{ static_cast<long long>(m_curTextureIndex) + indexOffset };
@@ -327,19 +501,21 @@ void SpriteWrapper::switchToNextTexture(long long indexOffset)
 	if (newTexture == nullptr) [[unlikely]]
 	{	// Not loaded yet, so we need to load it first.
 		std::ostringstream errorMessage{};
-		auto optTexture{ loadTextureFromFile(errorMessage, textureInfo.texture->fileName) };
-		
-		if (!optTexture.has_value()) [[unlikely]]
+		if (!loadHolder(errorMessage, *textureInfo.texture)) [[unlikely]]
 			throw LoadingGraphicalResourceFailure{ errorMessage.str() };
-
-		newTexture = std::make_unique<sf::Texture>(std::move(optTexture.value()));
 	}	
 	
+	// Rects are given for the source resolution: a texture of a lower tier has fewer pixels.
+	const float ratio{ textureInfo.texture->resolutionRatio };
 	if (textureInfo.displayedTexturePart == sf::IntRect{}) [[unlikely]] // If rect is 0,0 then the rect should cover the whole texture.
-		textureInfo.displayedTexturePart.size = static_cast<sf::Vector2i>(newTexture->getSize());
+		textureInfo.displayedTexturePart = scaleRect(sf::IntRect{ {}, static_cast<sf::Vector2i>(newTexture->getSize()) }, 1.f / ratio);
 
-	m_wrappedSprite.setTextureRect(textureInfo.displayedTexturePart);
+	m_wrappedSprite.setTextureRect(scaleRect(textureInfo.displayedTexturePart, ratio));
 	m_wrappedSprite.setTexture(*newTexture);
+
+	// Scaled up, to be drawn as large as the source would be.
+	m_wrappedSprite.scale(sf::Vector2f{ m_resolutionRatio / ratio, m_resolutionRatio / ratio });
+	m_resolutionRatio = ratio;
 }
 
 void SpriteWrapper::switchToTexture(size_t index)
@@ -353,23 +529,19 @@ void SpriteWrapper::switchToTexture(size_t index)
 	switchToNextTexture(0);
 }
 
-void SpriteWrapper::createTexture(std::string name, std::string fileName, Reserved shared, bool loadImmediately)
+void SpriteWrapper::createTexture(std::string name, std::string fileName, Reserved shared, bool loadImmediately, TextureOptions options)
 {
 	if (getTexture(name) != nullptr)
 		return;
 
-	TextureHolder newTexture{ .fileName = std::move(fileName) };
+	TextureHolder newTexture{ .fileName = std::move(fileName), .options = options };
 	newTexture.actualTexture = nullptr;
 
 	if (loadImmediately)
 	{
 		std::ostringstream errorMessage{};
-		auto optTexture{ loadTextureFromFile(errorMessage, newTexture.fileName) };
-
-		if (!optTexture.has_value()) [[unlikely]]
+		if (!loadHolder(errorMessage, newTexture)) [[unlikely]]
 			throw LoadingGraphicalResourceFailure{ errorMessage.str() };
-		else
-			newTexture.actualTexture = std::make_unique<sf::Texture>(std::move(optTexture.value()));
 	}
 
 	// We add the font using push_front so we know that it is at the beginning.
@@ -401,6 +573,7 @@ void SpriteWrapper::removeTexture(std::string_view name) noexcept
 
 	s_allTextures.erase(mapIterator->second); // First, removing the actual texture.
 	s_accessToTextures.erase(mapIterator); // Then, the accessing item within the map.
+	++s_texturesGeneration;
 }
 
 sf::Texture* SpriteWrapper::getTexture(std::string_view name) noexcept
@@ -427,8 +600,7 @@ bool SpriteWrapper::loadTexture(std::string_view name, bool failingImpliesRemova
 	// Texture with no path are always loaded.
 
 	std::ostringstream errorMessage{};
-	auto optTexture{ loadTextureFromFile(errorMessage, textureHolder->fileName) };
-	if (!optTexture.has_value()) [[unlikely]]
+	if (!loadHolder(errorMessage, *textureHolder)) [[unlikely]]
 	{
 		if (failingImpliesRemoval && s_allUniqueTextures.find(&*mapIterator->second) == s_allUniqueTextures.end()) 
 			removeTexture(name);
@@ -436,7 +608,6 @@ bool SpriteWrapper::loadTexture(std::string_view name, bool failingImpliesRemova
 		throw LoadingGraphicalResourceFailure{ errorMessage.str() };
 	}
 
-	textureHolder->actualTexture = std::make_unique<sf::Texture>(std::move(optTexture.value()));
 	return true;
 }
 
@@ -455,12 +626,84 @@ bool SpriteWrapper::unloadTexture(std::string_view name) noexcept
 		return true; // Already unloaded.
 
 	textureHolder->actualTexture = nullptr;
+	++s_texturesGeneration;
 	return true;
 }
 
+void SpriteWrapper::setResolutionTiers(unsigned int sourceResolution, std::vector<unsigned int> tiers)
+{
+	std::erase_if(tiers, [sourceResolution](unsigned int tier) { return tier == 0 || tier >= sourceResolution; });
+	std::sort(tiers.begin(), tiers.end());
+	tiers.erase(std::unique(tiers.begin(), tiers.end()), tiers.end());
+
+	s_sourceResolution = sourceResolution;
+	s_resolutionTiers = std::move(tiers);
+	s_selectedTier = 0;
+}
+
+unsigned int SpriteWrapper::selectResolutionTier(float relativeScaling) noexcept
+{
+	const float neededResolution{ relativeScaling * static_cast<float>(s_sourceResolution) };
+	s_selectedTier = 0;
+
+	for (const unsigned int tier : s_resolutionTiers) // Ascending: the first large enough is the smallest.
+	{
+		if (static_cast<float>(tier) >= neededResolution)
+		{
+			s_selectedTier = tier;
+			break;
+		}
+	}
+
+	return (s_selectedTier == 0) ? s_sourceResolution : s_selectedTier;
+}
+
+bool SpriteWrapper::loadHolder(std::ostringstream& errorMessage, TextureHolder& textureHolder) noexcept
+{
+	try
+	{
+		auto [fileName, ratio]{ resolveResolutionTier(textureHolder.fileName, textureHolder.options) };
+		auto optTexture{ loadTextureFromFile(errorMessage, fileName) };
+		if (!optTexture.has_value()) [[unlikely]]
+			return false;
+
+		applyOptions(optTexture.value(), textureHolder.options);
+		textureHolder.actualTexture = std::make_unique<sf::Texture>(std::move(optTexture.value()));
+		textureHolder.resolutionRatio = ratio;
+		return true;
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected.
+		errorMessage << "Not enough memory to load the texture " << textureHolder.fileName << '\n';
+		errorMessage << "This texture cannot be displayed\n";
+		return false;
+	}
+}
+
+std::pair<std::string, float> SpriteWrapper::resolveResolutionTier(const std::string& fileName, TextureOptions options, std::string_view path)
+{
+	if (!options.tiered || s_selectedTier == 0)
+		return std::make_pair(fileName, 1.f);
+
+	std::string variant{ std::to_string(s_selectedTier) + '/' + fileName };
+	std::error_code error{};
+	if (!std::filesystem::exists(std::filesystem::path(path) / variant, error))
+		return std::make_pair(fileName, 1.f); // No variant for this texture: the source is used.
+
+	return std::make_pair(std::move(variant), static_cast<float>(s_selectedTier) / static_cast<float>(s_sourceResolution));
+}
+
+void SpriteWrapper::applyOptions(sf::Texture& texture, TextureOptions options) noexcept
+{
+	if (options.mipmap)
+		static_cast<void>(texture.generateMipmap()); // If the driver cannot, the texture is still usable without.
+}
+
 
 std::optional<sf::Texture> loadTextureFromFile(std::ostringstream& errorMessage, std::string_view fileName, std::string_view path) noexcept
 {
+	GUI_PROFILE_SCOPE("loadTextureFromFile");
+	GUI_PROFILE_COUNT(TextureLoads, 1);
 	sf::Texture texture{};
 
 	try
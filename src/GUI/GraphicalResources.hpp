@@ -25,6 +25,8 @@
 #include <cstdint>
 #include <concepts>
 #include <type_traits>
+#include "Profiler.hpp"
+#include "../Save/MappedFile.hpp"
 
 #ifndef NDEBUG 
 
@@ -230,8 +232,9 @@ public:
 	 * 
 	 * \note The scale parameter should take into account the current size of the window. In a smaller
 	 * 		 window, the same `sf::Transformable` will appear larger, and vice-versa.
+	 * \note Virtual so that `create` applies the corrections of the derived classes too.
 	 */
-	void setScale(sf::Vector2f scale) noexcept;
+	virtual void setScale(sf::Vector2f scale) noexcept;
 
 	/**
 	 * \see Similar to the `sf::Transformable::setRotation` function.
@@ -303,6 +306,19 @@ protected:
 /// A `sf::Text` wrapper.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+class GlyphCache;
+
+/**
+ * \brief The content of a font file, mapped in memory rather than copied.
+ *
+ * \see `readFontFile`, `TextWrapper::createFont`.
+ */
+struct FontFile
+{
+	SafeSaves::MappedFile mapping; // Its pages are only loaded when the glyphs are read.
+	std::uint64_t hash; // `SafeSaves::hash64` of the content: only contents with the same hash are compared.
+};
+
 /// The type must be streamable to `std::basic_ostream`.
 template <typename T>
 concept Ostreamable = requires(std::ostream & os, T t)
@@ -317,6 +333,10 @@ concept Ostreamable = requires(std::ostream & os, T t)
  * for the user to choose from. He can add/remove as much as he wants while keeping O(1) complexity.
  * The function `createFont` adds and loads a font that all instances can use, while `removeFont`
  * deletes it completely. Don't remove fonts that are being used by a text.
+ *
+ * A font file is mapped once: the names created from files with the same content share the font, and
+ * the glyphs are read from the mapping. A font can fall back on others for the glyphs
+ * it does not have, e.g. a font per script in a multi-language interface: see `setFontFallbacks`.
  * 
  * \see `sf::Text`, `sf::Font`, `TransformableWrapper`.
  */
@@ -349,7 +369,7 @@ public:
 	 */
 	template<Ostreamable T>
 	inline TextWrapper(const T& content, std::string_view fontName, unsigned int characterSize, sf::Vector2f pos, sf::Vector2f scale, sf::Color color = sf::Color::White, Alignment alignment = Alignment::Center, std::uint32_t style = 0, sf::Angle rot = sf::degrees(0))
-		: TransformableWrapper{}, m_wrappedText{ s_defaultFont, "", characterSize }
+		: TransformableWrapper{}, m_wrappedText{ s_defaultFont, "", characterSize }, m_font{ nullptr }
 	{
 		create(&m_wrappedText, pos, scale, rot, alignment);
 
@@ -383,8 +403,26 @@ public:
 		std::ostringstream oss{}; // Convert the content to a string.
 		oss << content; // Assigning the content to the variable.
 
-		m_wrappedText.setString(oss.str());
+		setContent(sf::String{ oss.str() });
+	}
+
+	/**
+	 * \brief Updates the text content, as is: no character is lost converting it.
+	 * \complexity O(1).
+	 *
+	 * \param[in] content The new content for the text.
+	 *
+	 * \see `sf::Text::setString`.
+	 */
+	inline void setContent(const sf::String& content) noexcept
+	{
+		m_wrappedText.setString(content);
+		resolveFont(); // The glyphs needed may have changed.
 		m_wrappedText.setOrigin(computeNewOrigin(m_wrappedText.getLocalBounds(), m_alignment));
+		GUI_PROFILE_COUNT(SetContentCalls, 1);
+
+		if (s_contentRecorder != nullptr) [[unlikely]]
+			s_contentRecorder(m_wrappedText);
 	}
 
 	/**
@@ -398,8 +436,9 @@ public:
 	 * \note This function is designed not to throw, to support scenarios where the user tries multiple
 	 *		 font until one is successfully found and set. This is useful when font loading may have failed
 	 *		 earlier, and fallback attempts are expected behavior.
+	 * \note If the font has fallbacks, the text uses the first font of the chain that has its glyphs.
 	 *
-	 * \see `sf::Text::setFont`, `createFont`, `loadFontFromFile`.
+	 * \see `sf::Text::setFont`, `createFont`, `loadFontFromFile`, `setFontFallbacks`.
 	 */
 	bool setFont(std::string_view name) noexcept;
 
@@ -481,6 +520,56 @@ public:
 	 * \see `loadFontFromFile`, `setFont`
 	 */
 	static void createFont(std::string name, sf::Font font) noexcept;
+
+	/**
+	 * \brief Opens a font from the content of its file and registers it under a given name.
+	 * \complexity O(F) where F is the number of fonts, O(F + S) if a content has the same hash, where
+	 *			   S is the size of the content.
+	 *
+	 * If a font was already created from the same content, the name refers to that font: the file is
+	 * not opened twice, and the glyphs already rasterized are shared. Otherwise, the font reads its
+	 * glyphs from the content, which it keeps alive. If a font with the same name already exists, the
+	 * function does nothing.
+	 *
+	 * \param[in] name The alias under which the font will be stored.
+	 * \param[in] content The mapped content of the font file. See `readFontFile`.
+	 *
+	 * \note Do not start a font name with an underscore.
+	 *
+	 * \pre `content` must be the content of a valid font file.
+	 * \post The font is available for use via the alias `name`.
+	 * \throw LoadingGraphicalResourceFailure Strong exception guarantee: no state is modified on failure.
+	 *
+	 * \see `readFontFile`, `setFont`
+	 */
+	static void createFont(std::string name, std::shared_ptr<const FontFile> content);
+
+	/**
+	 * \brief Sets the fonts a font falls back on, for the texts having glyphs it does not have.
+	 * \complexity O(K) where K is the number of fallbacks.
+	 *
+	 * A text keeps a single font: it uses the first font of the chain, the font itself then its
+	 * fallbacks in order, that has every glyph of its content. If none has, the one missing the
+	 * fewest glyphs is used. The fallbacks are looked up by name each time: they may be created later,
+	 * and those missing are skipped.
+	 *
+	 * \param[in] name The alias of the font.
+	 * \param[in] fallbacks The aliases of its fallbacks, in order. Empty to remove them.
+	 *
+	 * \return `false` if no font exists under that name, `true` otherwise.
+	 *
+	 * \note The texts already using the font pick a fallback the next time their content is set.
+	 * \note Only the names are linked: two names of the same font may have different fallbacks.
+	 *
+	 * \see `setFont`, `createFont`.
+	 *
+	 * \code
+	 * gui::TextWrapper::createFont("latin", "latin.ttf");
+	 * gui::TextWrapper::createFont("cjk", "cjk.otf");
+	 * gui::TextWrapper::setFontFallbacks("latin", { "cjk" }); // "latin" texts in Japanese use "cjk".
+	 * \endcode
+	 */
+	static bool setFontFallbacks(std::string_view name, std::vector<std::string> fallbacks) noexcept;
 	
 	/**
 	 * \brief Removes the font from the wrapper with the given name.
@@ -510,18 +599,91 @@ public:
 	 */
 	[[nodiscard]] static sf::Font* getFont(std::string_view name) noexcept;
 
+	/**
+	 * \brief Returns the name of a font, or an empty view if it was not created with `createFont`.
+	 * \complexity O(N) where N is the number of fonts.
+	 *
+	 * \param[in] font The address of the font, e.g. the one of a `sf::Text`.
+	 *
+	 * \return The alias under which the font was stored, valid until it is removed.
+	 *
+	 * \see `getFont`.
+	 */
+	[[nodiscard]] static std::string_view getFontName(const sf::Font* font) noexcept;
+
+	/**
+	 * \brief The memory used by a font, whatever the number of names it has.
+	 */
+	struct FontMemory
+	{
+		size_t content{ 0 }; // The content of its file, mapped for the glyphs to be read from.
+		size_t glyphPages{ 0 }; // The textures of its glyphs, a page per character size used, in bytes.
+		size_t characterSizes{ 0 }; // The number of pages.
+	};
+
+	/**
+	 * \brief Returns the memory used by a font, or nothing if it does not exist.
+	 * \complexity O(P) where P is the number of character sizes used with the font.
+	 *
+	 * \param[in] name The alias under which the font was stored.
+	 *
+	 * \return The memory used, shared by all the names of the font.
+	 *
+	 * \note The glyph pages are those of the sizes used by the texts, 4 bytes per pixel. A font created
+	 *		 with `createFont(name, sf::Font)` has no content kept.
+	 *
+	 * \see `createFont`, `GlyphCache`.
+	 */
+	[[nodiscard]] static FontMemory getFontMemory(std::string_view name) noexcept;
+
 private:
 
+	/**
+	 * \brief A font, loaded once whatever the number of names it is created under.
+	 */
+	struct LoadedFont
+	{
+		std::shared_ptr<const FontFile> content; // What the font reads its glyphs from, if created from it. Declared first: destroyed after the font.
+		sf::Font font;
+		size_t names{ 1 }; // The number of names referring to the font: destroyed with the last one.
+		std::vector<unsigned int> characterSizes{}; // The sizes its glyphs were drawn at: a page each.
+	};
+
+	/**
+	 * \brief A name of a font, with the fonts it falls back on.
+	 */
+	struct FontName
+	{
+		std::list<LoadedFont>::iterator font;
+		std::vector<std::string> fallbacks{};
+	};
+
+
+	/**
+	 * \brief Sets the font of the chain having the glyphs of the content, and records its size.
+	 * \complexity O(1) if the font has no fallbacks, O(L * K) otherwise where L is the length of the
+	 *			   content and K the number of fallbacks.
+	 */
+	void resolveFont() noexcept;
+
+
 	/// What `sf::Text` the wrapper is being used for.
 	sf::Text m_wrappedText;
+	/// The name of the font set, with its fallbacks. Nullptr before the font is set.
+	const FontName* m_font;
 
 	/// Contains all loaded fonts
-	inline static std::list<sf::Font> s_allFonts{};
+	inline static std::list<LoadedFont> s_allFonts{};
 	/// Allows to find fonts with a name in O(1) time complexity.
-	inline static std::unordered_map<std::string, std::list<sf::Font>::iterator, TransparentHash, TransparentEqual> s_accessToFonts{};
+	inline static std::unordered_map<std::string, FontName, TransparentHash, TransparentEqual> s_accessToFonts{};
 	
 	/// A default font that is used to initialize the `sf::Text` before setting its actual font.
 	inline static const sf::Font s_defaultFont{}; 
+
+	/// Called each time a content is set, if not nullptr. Set by `GlyphCache` while it records.
+	inline static void (*s_contentRecorder)(const sf::Text&) noexcept { nullptr };
+
+friend class GlyphCache;
 };
 
 
@@ -543,6 +705,23 @@ private:
  */
 [[nodiscard]] std::optional<sf::Font> loadFontFromFile(std::ostringstream& errorMessage, std::string_view fileName, std::string_view path = "../assets/") noexcept;
 
+/**
+ * \brief Maps the content of a font file and hashes it, for `TextWrapper::createFont` to open it.
+ * \complexity O(S) where S is the size of the file, for the hash.
+ *
+ * \param[out] errorMessage Will add the error message to this stream if the mapping fails.
+ * \param[in]  fileName The name of the file.
+ * \param[in]  path The path to this file (assets file by default).
+ *
+ * \return The content of the file if it was mapped, nullptr otherwise.
+ *
+ * \note Only reads the file: it can be called from any thread.
+ * \note A message is added to the stream only if the function returns nullptr.
+ *
+ * \see `TextWrapper::createFont`, `loadFontFromFile`.
+ */
+[[nodiscard]] std::shared_ptr<const FontFile> readFontFile(std::ostringstream& errorMessage, std::string_view fileName, std::string_view path = "../assets/") noexcept;
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 /// A `sf::Text` wrapper.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -551,6 +730,23 @@ private:
 /// A `sf::Sprite` wrapper.
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+/**
+ * \brief How a texture is loaded from its file.
+ *
+ * \note The textures are always stored as RGBA8: SFML does not let us choose the format on the GPU.
+ *
+ * \see `SpriteWrapper::createTexture`, `SpriteWrapper::selectResolutionTier`.
+ */
+struct TextureOptions
+{
+	/// Generates the mipmaps of the texture. A sprite drawn smaller than its texture, e.g. in a small
+	/// window, samples a smaller level: it does not alias, and reads less memory. Costs a third more memory.
+	bool mipmap{ false };
+
+	/// Loads the variant of the file in the folder of the selected resolution tier, if there is one.
+	bool tiered{ false };
+};
+
 /**
  * \brief A wrapper around `sf::Sprite` that simplifies texture management.
  *
@@ -576,6 +772,14 @@ private:
  * - Reserved textures cannot be manually removed with `removeTexture`; they are automatically
  *   cleaned up when their owning sprite instance is destroyed. However, they can still be unloaded.
  * 
+ * Resolution tiers:
+ * - The files of the assets folder are drawn at a source resolution, e.g. 2160. Downscaled variants
+ *   can be placed in a folder per tier, e.g. `1080/` and `540/`, with the same file names.
+ * - `selectResolutionTier` picks the smallest tier large enough for the current scaling. The tiered
+ *   textures loaded afterwards use its variants, which take less memory and are faster to sample.
+ * - Rects and scales are always given for the source resolution: the sprites drawing a variant are
+ *   scaled up to the same size on screen.
+ * 
  * A code example is provided at the end of the file.
  *
  * \note Reserved textures may consume slightly more memory due to exclusive ownership.
@@ -646,6 +850,28 @@ public:
 	 */
 	virtual void setAlignment(Alignment alignment) noexcept final;
 
+	/**
+	 * \see Similar to the `sf::Transformable::setScale` function.
+	 * 
+	 * \note The scale is given for the source resolution of the texture, even if a resolution tier
+	 *		 is drawn.
+	 */
+	virtual void setScale(sf::Vector2f scale) noexcept final;
+
+	/**
+	 * \brief Gives the scale for the source resolution of the texture, as given to `setScale`.
+	 * \complexity O(1).
+	 *
+	 * \return The scale of the wrapped sprite multiplied by the resolution ratio of its texture.
+	 *
+	 * \note `getSprite().getScale()` is the scale actually drawn: it is divided by the resolution ratio,
+	 *		 so it must not be given back to `setScale`.
+	 */
+	[[nodiscard]] inline sf::Vector2f getScale() const noexcept
+	{
+		return m_wrappedSprite.getScale() * m_resolutionRatio;
+	}
+
 	/**
 	 * \brief Accesses the wrapped `sf::Sprite` object.
 	 * \complexity O(1).
@@ -707,6 +933,17 @@ public:
 		return m_curTextureIndex;
 	}
 
+	/**
+	 * \brief Returns the number of textures of this sprite, that is the size of the texture vector.
+	 * \complexity O(1).
+	 *
+	 * \return The number of textures the sprite can switch to.
+	 */
+	[[nodiscard]] inline size_t getTextureCount() const noexcept
+	{
+		return m_textures.size();
+	}
+
 	/**
 	 * \brief Adds a texture (with one or more sub-rectangles) to this instance's texture vector.
 	 * 
@@ -805,6 +1042,7 @@ public:
 	 * \param[in] shared: `No` if the texture is reserved.
 	 * \param[in] loadImmediately: `true` if you want the texture to be loaded from the file when the
 	 *							   function is called. if so, may throw an exception if failed.
+	 * \param[in] options: How the texture is loaded, now or later.
 	 *
 	 * \note If loadImmediately is set to `true`, It is recommended to call this from a separate thread
 	 *		 for large textures or to avoid frame drops.
@@ -816,7 +1054,7 @@ public:
 	 *
 	 * \see `loadTextureFromFile`, `addTexture`.
 	 */
-	static void createTexture(std::string name, std::string fileName, Reserved shared = Reserved::Yes, bool loadImmediately = false);
+	static void createTexture(std::string name, std::string fileName, Reserved shared = Reserved::Yes, bool loadImmediately = false, TextureOptions options = TextureOptions{});
 
 	/**
 	 * \brief Creates a texture from a file and registers it under a given name.
@@ -926,6 +1164,62 @@ public:
 	 */
 	static bool unloadTexture(std::string_view name) noexcept;
 
+	/**
+	 * \brief Returns a number changed each time a texture is freed.
+	 * \complexity O(1).
+	 *
+	 * \return The generation of the textures: what was prepared with an older one may point to a texture
+	 *		   no longer existing. A sprite switching texture does not change it: the previous texture
+	 *		   still exists, and its interface discards what it prepared.
+	 *
+	 * \see `BasicInterface::prepareFrame`.
+	 */
+	[[nodiscard]] static inline std::uint64_t getTexturesGeneration() noexcept
+	{
+		return s_texturesGeneration;
+	}
+
+	/**
+	 * \brief Declares the resolution tiers: the folders of the downscaled variants of the textures.
+	 * \complexity O(T log T) where T is the number of tiers.
+	 *
+	 * \param[in] sourceResolution The resolution the files of the assets folder are drawn for, e.g. 2160.
+	 * \param[in] tiers The resolutions of the variants, e.g. { 1080, 540 }: each one is a folder
+	 *			   within the assets folder. Those not smaller than the source are ignored.
+	 *
+	 * \note No tier is selected afterwards: the source files are used until `selectResolutionTier`.
+	 *
+	 * \see `selectResolutionTier`, `TextureOptions::tiered`.
+	 */
+	static void setResolutionTiers(unsigned int sourceResolution, std::vector<unsigned int> tiers);
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \return The resolution tiers declared, ascending: the folders of the downscaled variants.
+	 *
+	 * \see `setResolutionTiers`.
+	 */
+	[[nodiscard]] static inline const std::vector<unsigned int>& getResolutionTiers() noexcept
+	{
+		return s_resolutionTiers;
+	}
+
+	/**
+	 * \brief Selects the smallest resolution tier that is large enough for a scaling.
+	 * \complexity O(T) where T is the number of tiers.
+	 *
+	 * \param[in] relativeScaling The scale the textures are drawn at, compared to the source resolution,
+	 *			   e.g. `std::min(windowSize.x, windowSize.y) / 2160.f`.
+	 *
+	 * \return The resolution selected, or the source resolution if no tier is small enough.
+	 *
+	 * \note The textures already loaded keep their resolution: unload and load them again to switch.
+	 *
+	 * \see `setResolutionTiers`, `TextureOptions::tiered`.
+	 */
+	static unsigned int selectResolutionTier(float relativeScaling) noexcept;
+
 private:
 
 	/**
@@ -943,6 +1237,8 @@ private:
 	{
 		std::unique_ptr<sf::Texture> actualTexture;
 		std::string fileName;
+		TextureOptions options{};
+		float resolutionRatio{ 1.f }; // Resolution of the texture loaded, compared to the source.
 	};
 
 	/**
@@ -958,9 +1254,40 @@ private:
 	};
 
 
+	/**
+	 * \brief Loads the texture of a holder from its file, in the selected resolution tier if it is tiered.
+	 * \complexity O(1).
+	 *
+	 * \param[out] errorMessage Will add the error message to this stream if the loading fails.
+	 * \param[out] textureHolder The holder whose texture is loaded.
+	 *
+	 * \return `false` if the loading failed: the holder is left as it was.
+	 */
+	static bool loadHolder(std::ostringstream& errorMessage, TextureHolder& textureHolder) noexcept;
+
+	/**
+	 * \brief Finds the file to load for a texture, and its resolution compared to the source.
+	 * \complexity O(1).
+	 *
+	 * \param[in] fileName The file name of the texture, within the assets folder.
+	 * \param[in] options How the texture is loaded.
+	 * \param[in] path The assets folder.
+	 *
+	 * \return The file name of the variant of the selected tier if the texture is tiered and the variant
+	 *		   exists, with its ratio. Otherwise, the file name given, with a ratio of 1.
+	 */
+	[[nodiscard]] static std::pair<std::string, float> resolveResolutionTier(const std::string& fileName, TextureOptions options, std::string_view path = "../assets/");
+
+	/// Applies the options that take effect once the texture is created, such as mipmaps.
+	static void applyOptions(sf::Texture& texture, TextureOptions options) noexcept;
+
+
 	/// What `sf::Sprite` the wrapper is being used for.
 	sf::Sprite m_wrappedSprite;
 
+	/// Resolution of the texture set, compared to the source: the sprite is scaled by its inverse.
+	float m_resolutionRatio;
+
 	/// The current index within the texture vector.
 	size_t m_curTextureIndex; 
 	/// All textures used by the sprite.
@@ -976,12 +1303,24 @@ private:
 	/// Textures that can be used just once by a single instance.
 	inline static std::unordered_map<TextureHolder*, bool> s_allUniqueTextures{};
 
+	/// The resolution the files of the assets folder are drawn for, 0 if there are no tiers.
+	inline static unsigned int s_sourceResolution{ 0 };
+	/// The resolutions of the downscaled variants, ascending.
+	inline static std::vector<unsigned int> s_resolutionTiers{};
+	/// The tier whose variants are loaded, 0 for the source files.
+	inline static unsigned int s_selectedTier{ 0 };
+	/// Incremented each time a texture is freed.
+	inline static std::uint64_t s_texturesGeneration{ 0 };
+
 	/// A default texture that is used to initialize the `sf::Sprite` before setting its actual texture.
 	inline static const sf::Texture s_defaultTexture{}; 
+
+friend class AssetPreloader;
 };
 
 /**
- * Here are two use of SpriteWrapper. One is simple; the other is slightly more complicated, yet very complete.
+ * Here are three use of SpriteWrapper. One is simple; the second is slightly more complicated, yet very complete;
+ * the last one uses resolution tiers.
  * 
  * \code Simple sprites: buttons.
  * const std::string button{ "buttonTex" };
@@ -1012,7 +1351,7 @@ private:
  * player.addTexture("hero attack2160", sf::IntRect{ {}, {100, 100} }, sf::IntRect{ {100, 0}, {100, 100} });
  * 
  * // Let's assume we're in the game loop
- * if (player.getSprite().getScale().x == 1.8) // Accounts for screen definition and other scaling reasons (e.g. gameplay, zooming).
+ * if (player.getScale().x == 1.8) // Accounts for screen definition and other scaling reasons (e.g. gameplay, zooming).
  * {	// Let's say 1.8 times is too pixeled so we load the 4k textures. 
  *		gui::SpriteWrapper::loadTexture("hero run2160"); // using another thread is recommended.
  *		gui::SpriteWrapper::loadTexture("hero attack2160");
@@ -1033,6 +1372,15 @@ private:
  *		}
  * }
  * \endcode
+ * 
+ * \code Resolution tiers: textures drawn for 4K, with variants in the folders 1080/ and 540/.
+ * gui::SpriteWrapper::setResolutionTiers(2160, { 1080, 540 });
+ * gui::SpriteWrapper::selectResolutionTier(std::min(windowSize.x, windowSize.y) / 2160.f); // 540 in a 960x540 window.
+ * 
+ * const gui::TextureOptions options{ .mipmap = true, .tiered = true };
+ * gui::SpriteWrapper::createTexture("background", "background.png", gui::SpriteWrapper::Reserved::No, true, options); // Loads 540/background.png.
+ * gui::SpriteWrapper background{ "background", { 0, 0 }, scale, sf::IntRect{}, sf::degrees(0), gui::Alignment::Top | gui::Alignment::Left }; // As for 4K.
+ * \endcode
  */
 
 
@@ -3,7 +3,7 @@
 namespace gui
 {
 
-InteractiveInterface::InteractiveInterface(sf::RenderWindow* window, unsigned int relativeScalingDefinition) noexcept
+InteractiveInterface::InteractiveInterface(sf::RenderTarget* window, unsigned int relativeScalingDefinition) noexcept
 	: MutableInterface{ window, relativeScalingDefinition }, m_interactiveTextButtons{}, m_interactiveSpriteButtons{}, m_writingTextIdentifier{ "" }, m_writingFunction{nullptr}
 {
 	static constexpr std::string_view textureName{ "__plainGrey" }; 
@@ -99,6 +99,7 @@ void InteractiveInterface::addInteractive(std::string_view identifier, ButtonFun
 	if (spriteIterator != m_dynamicSprites.end() && spriteIterator->second >= m_interactiveSpriteButtons.size())
 	{	// Checks if the sprite exists and is not already an interactable.
 		swapElement(spriteIterator->second, m_interactiveSpriteButtons.size(), m_sprites, m_dynamicSprites, m_indexesForEachDynamicSprites);
+		discardPreparedFrame();
 		m_interactiveSpriteButtons.push_back(Button{ std::move(function), when }); // Some compilers might trigger a false positive warning for use of a moved-from object. 
 	}
 }
@@ -135,6 +136,7 @@ void InteractiveInterface::setWritingText(std::string_view identifier, WritableF
 InteractiveInterface::Item InteractiveInterface::eventUpdateHovered(BasicInterface* activeGUI, sf::Vector2f cursorPos) noexcept
 {
 	ENSURE_VALID_PTR(activeGUI, "The gui was nullptr when the function updateHovered was called in InteractiveInterface");
+	GUI_PROFILE_SCOPE("InteractiveInterface::eventUpdateHovered");
 
 	InteractiveInterface* const igui{ dynamic_cast<InteractiveInterface*>(activeGUI) };
 
@@ -142,6 +144,7 @@ InteractiveInterface::Item InteractiveInterface::eventUpdateHovered(BasicInterfa
 	// Type is set to None if no item wa hovered, or if the gui was nullptr
 	if (s_hoveredItem.igui == igui)
 	{
+		GUI_PROFILE_COUNT(HitTests, 1);
 		if (s_hoveredItem.type == Item::Type::Text   && igui->getDynamicText(s_hoveredItem.identifier)->getText().getGlobalBounds().contains(cursorPos))
 			return s_hoveredItem; // No need to check again if the hovered item is the same.
 	
@@ -158,7 +161,11 @@ InteractiveInterface::Item InteractiveInterface::eventUpdateHovered(BasicInterfa
 	for (size_t i{ 0 }; i < m_endSpriteInteractives; ++i)
 	{
 		SpriteWrapper& sprite{ igui->m_sprites[i] };
-		if (!sprite.hide && sprite.getSprite().getGlobalBounds().contains(cursorPos))
+		if (sprite.hide)
+			continue;
+
+		GUI_PROFILE_COUNT(HitTests, 1);
+		if (sprite.getSprite().getGlobalBounds().contains(cursorPos))
 		{
 			s_hoveredItem = Item{ igui, igui->m_indexesForEachDynamicSprites.at(i)->first, Item::Type::Sprite, &igui->m_interactiveSpriteButtons[i] };
 
@@ -173,7 +180,11 @@ InteractiveInterface::Item InteractiveInterface::eventUpdateHovered(BasicInterfa
 	for (size_t i{ 0 }; i < m_endTextInteractives; ++i)
 	{
 		TextWrapper& text{ igui->m_texts[i] };
-		if (!text.hide && text.getText().getGlobalBounds().contains(cursorPos))
+		if (text.hide)
+			continue;
+
+		GUI_PROFILE_COUNT(HitTests, 1);
+		if (text.getText().getGlobalBounds().contains(cursorPos))
 		{
 			s_hoveredItem = Item{ igui, igui->m_indexesForEachDynamicTexts.at(i)->first, Item::Type::Text, &igui->m_interactiveTextButtons[i]};
 
@@ -190,6 +201,7 @@ InteractiveInterface::Item InteractiveInterface::eventUpdateHovered(BasicInterfa
 InteractiveInterface::Item InteractiveInterface::eventPressed(BasicInterface* activeGUI) noexcept
 {
 	ENSURE_VALID_PTR(activeGUI, "The gui was nullptr when the function pressed was called in InteractiveInterface");
+	GUI_PROFILE_SCOPE("InteractiveInterface::eventPressed");
 
 	InteractiveInterface* const igui{ dynamic_cast<InteractiveInterface*>(activeGUI) };
 
@@ -204,6 +216,7 @@ InteractiveInterface::Item InteractiveInterface::eventPressed(BasicInterface* ac
 void InteractiveInterface::textEntered(BasicInterface* activeGUI, char32_t character) noexcept
 {
 	ENSURE_VALID_PTR(activeGUI, "The gui was nullptr when the function textEntered was called in InteractiveInterface");
+	GUI_PROFILE_SCOPE("InteractiveInterface::textEntered");
 
 	InteractiveInterface* const gui{ dynamic_cast<InteractiveInterface*>(activeGUI) };
 
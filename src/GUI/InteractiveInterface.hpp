@@ -109,6 +109,7 @@ public:
 	 * \complexity O(1)
 	 *
 	 * \param[in,out] window A valid pointer to the SFML window where interface elements will be rendered.
+	 *				  Any render target works, e.g. an `sf::RenderTexture` to render offscreen.
 	 * \param[in] relativeScalingDefinition A scaling baseline to ensure consistent visual proportions across
 	 *			  various window sizes. Scales of `sf::Transformable` elements are adjusted based on the window size
 	 *			  relative to this reference value:
@@ -129,7 +130,7 @@ public:
 	 * \pre `window` must be a valid.
 	 * \warning The program will assert otherwise.
 	 */
-	explicit InteractiveInterface(sf::RenderWindow* window, unsigned int relativeScalingDefinition = 1080) noexcept;
+	explicit InteractiveInterface(sf::RenderTarget* window, unsigned int relativeScalingDefinition = 1080) noexcept;
 
 	InteractiveInterface() noexcept = delete;
 	InteractiveInterface(const InteractiveInterface&) noexcept = delete;
@@ -0,0 +1,236 @@
+#include "InterfaceState.hpp"
+#include "../Save.hpp"
+#include "../Save/BinaryUtils.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace gui
+{
+
+namespace
+{
+/// An element as stored in the blob.
+struct StoredField
+{
+	InterfaceField::Kind kind;
+	std::string_view identifier;
+	std::string_view payload;
+};
+
+constexpr size_t headerSize{ 8 }; // Magic number, version, number of fields.
+constexpr size_t checksumSize{ 4 };
+}
+
+std::string InterfaceState::snapshot(AdvancedInterface* gui, std::span<const InterfaceField> fields) noexcept
+{
+	ENSURE_VALID_PTR(gui, "The gui was nullptr when the function snapshot was called in InterfaceState");
+
+	try
+	{
+		std::string blob{};
+		SafeSaves::appendInteger<std::uint32_t>(blob, magicNumber);
+		SafeSaves::appendInteger<std::uint16_t>(blob, formatVersion);
+		SafeSaves::appendInteger<std::uint16_t>(blob, 0); // Written once the fields found are counted.
+
+		std::uint16_t count{ 0 };
+		std::string payload{};
+
+		for (const auto& field : fields)
+		{
+			const std::string identifier{ field.identifier };
+			payload.clear();
+
+			if (field.kind == InterfaceField::Kind::Slider)
+			{
+				const SpriteWrapper* background{ gui->getDynamicSprite(identifier) };
+				const SpriteWrapper* cursor{ gui->getDynamicSprite(AdvancedInterface::sliderCursorPrefixeIdentifier + identifier) };
+				if (gui->m_sliders.find(identifier) == gui->m_sliders.end() || background == nullptr || cursor == nullptr)
+					continue;
+
+				// The position, not the value: the growth function of the slider cannot be inverted.
+				const sf::FloatRect bounds{ background->getSprite().getGlobalBounds() };
+				float position{ (bounds.size.y > 0.f) ? 1.f - (cursor->getSprite().getPosition().y - bounds.position.y) / bounds.size.y : 0.5f };
+				position = std::clamp(position, 0.f, 1.f);
+
+				SafeSaves::appendInteger<std::uint32_t>(payload, std::bit_cast<std::uint32_t>(position));
+			}
+			else if (field.kind == InterfaceField::Kind::MultipleQuestionBoxes)
+			{
+				const AdvancedInterface::MultipleQuestionBoxes* mqb{ gui->getMQB(identifier) };
+				if (mqb == nullptr)
+					continue;
+
+				std::vector<unsigned short> checked{ mqb->m_checked.begin(), mqb->m_checked.end() };
+				std::sort(checked.begin(), checked.end()); // The same state always gives the same blob.
+
+				SafeSaves::appendInteger<std::uint16_t>(payload, static_cast<std::uint16_t>(checked.size()));
+				for (unsigned short box : checked)
+					SafeSaves::appendInteger<std::uint16_t>(payload, box);
+			}
+			else
+			{
+				const TextWrapper* text{ gui->getDynamicText(identifier) };
+				if (text == nullptr)
+					continue;
+
+				// In UTF-8: converting to std::string would lose the characters outside of the locale.
+				const auto utf8{ text->getText().getString().toUtf8() };
+				payload.assign(utf8.begin(), utf8.end());
+			}
+
+			SafeSaves::appendInteger<std::uint8_t>(blob, static_cast<std::uint8_t>(field.kind));
+			SafeSaves::appendInteger<std::uint16_t>(blob, static_cast<std::uint16_t>(identifier.size()));
+			blob.append(identifier);
+			SafeSaves::appendInteger<std::uint32_t>(blob, static_cast<std::uint32_t>(payload.size()));
+			blob.append(payload);
+			++count;
+		}
+
+		blob[6] = static_cast<char>(count & 0xFF);
+		blob[7] = static_cast<char>(count >> 8);
+		SafeSaves::appendInteger<std::uint32_t>(blob, SafeSaves::crc32(blob));
+
+		return blob;
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected: an empty blob is never restored.
+		return std::string{};
+	}
+}
+
+bool InterfaceState::restore(AdvancedInterface* gui, std::span<const InterfaceField> fields, std::string_view blob) noexcept
+{
+	ENSURE_VALID_PTR(gui, "The gui was nullptr when the function restore was called in InterfaceState");
+
+	if (blob.size() < headerSize + checksumSize
+	||  SafeSaves::readInteger<std::uint32_t>(blob, 0) != magicNumber
+	||  SafeSaves::readInteger<std::uint16_t>(blob, 4) != formatVersion
+	||  SafeSaves::readInteger<std::uint32_t>(blob, blob.size() - checksumSize) != SafeSaves::crc32(blob.substr(0, blob.size() - checksumSize))) [[unlikely]]
+		return false;
+
+	// Reads every stored field before changing anything: a corrupted blob restores nothing.
+	const std::uint16_t count{ SafeSaves::readInteger<std::uint16_t>(blob, 6) };
+	std::string_view content{ blob.substr(headerSize, blob.size() - headerSize - checksumSize) };
+	std::vector<StoredField> storedFields{};
+	storedFields.reserve(count);
+
+	for (std::uint16_t i{ 0 }; i < count; ++i)
+	{
+		if (content.size() < 3) [[unlikely]]
+			return false;
+
+		const auto kind{ static_cast<InterfaceField::Kind>(SafeSaves::readInteger<std::uint8_t>(content, 0)) };
+		const size_t identifierSize{ SafeSaves::readInteger<std::uint16_t>(content, 1) };
+		if (content.size() < 3 + identifierSize + 4) [[unlikely]]
+			return false;
+
+		const size_t payloadSize{ SafeSaves::readInteger<std::uint32_t>(content, 3 + identifierSize) };
+		if (content.size() - (3 + identifierSize + 4) < payloadSize) [[unlikely]]
+			return false;
+
+		storedFields.push_back(StoredField{ kind, content.substr(3, identifierSize), content.substr(3 + identifierSize + 4, payloadSize) });
+		content.remove_prefix(3 + identifierSize + 4 + payloadSize);
+	}
+
+	if (!content.empty()) [[unlikely]]
+		return false;
+
+	for (const auto& field : fields)
+	{
+		const auto stored{ std::find_if(storedFields.begin(), storedFields.end(), [&field](const StoredField& stored) { return stored.kind == field.kind && stored.identifier == field.identifier; }) };
+		if (stored == storedFields.end())
+			continue; // Not saved yet: keeps its current state.
+
+		const std::string identifier{ field.identifier };
+		const std::string_view payload{ stored->payload };
+
+		if (field.kind == InterfaceField::Kind::Slider)
+		{
+			auto sliderIterator{ gui->m_sliders.find(identifier) };
+			SpriteWrapper* background{ gui->getDynamicSprite(identifier) };
+			SpriteWrapper* cursor{ gui->getDynamicSprite(AdvancedInterface::sliderCursorPrefixeIdentifier + identifier) };
+			if (sliderIterator == gui->m_sliders.end() || background == nullptr || cursor == nullptr || payload.size() != 4)
+				continue;
+
+			const float position{ std::bit_cast<float>(SafeSaves::readInteger<std::uint32_t>(payload, 0)) };
+			if (!std::isfinite(position) || position < 0.f || position > 1.f) [[unlikely]]
+				continue;
+
+			// Moves the cursor as the user would: the value, its text and its function follow.
+			const sf::FloatRect bounds{ background->getSprite().getGlobalBounds() };
+			sliderIterator->second.setCursor(bounds.position.y + (1.f - position) * bounds.size.y, *cursor, *background, gui->getDynamicText(AdvancedInterface::sliderTextPrefixeIdentifier + identifier));
+		}
+		else if (field.kind == InterfaceField::Kind::MultipleQuestionBoxes)
+		{
+			AdvancedInterface::MultipleQuestionBoxes* mqb{ gui->getMQB(identifier) };
+			if (mqb == nullptr || payload.size() < 2 || payload.size() != 2 + 2 * size_t{ SafeSaves::readInteger<std::uint16_t>(payload, 0) })
+				continue;
+
+			std::unordered_set<unsigned short> checked{};
+			for (size_t offset{ 2 }; offset < payload.size(); offset += 2)
+				checked.insert(SafeSaves::readInteger<std::uint16_t>(payload, offset));
+
+			// The boxes may have changed since the save: the state must still satisfy the mqb.
+			const bool outOfRange{ std::any_of(checked.begin(), checked.end(), [mqb](unsigned short box) { return box == 0 || box > mqb->m_numberOfBoxes; }) };
+			if (outOfRange || (!mqb->m_multipleChoices && checked.size() > 1) || (mqb->m_atLeastOne && checked.empty()))
+				continue;
+
+			mqb->m_checked = std::move(checked);
+
+			for (unsigned short box{ 1 }; box <= mqb->m_numberOfBoxes; ++box)
+			{
+				SpriteWrapper* boxSprite{ gui->getDynamicSprite("_" + std::to_string(box) + "_" + identifier) };
+				if (boxSprite != nullptr) // 0 is the unchecked texture, 1 the checked one.
+					boxSprite->switchToTexture((mqb->m_checked.contains(box)) ? 1 : 0);
+			}
+		}
+		else if (field.kind == InterfaceField::Kind::Text)
+		{
+			TextWrapper* text{ gui->getDynamicText(identifier) };
+			if (text != nullptr)
+				text->setContent(sf::String::fromUtf8(payload.begin(), payload.end()));
+		}
+	}
+
+	return true;
+}
+
+std::optional<std::string> InterfaceState::save(const std::string& fileName, AdvancedInterface* gui, std::span<const InterfaceField> fields) noexcept
+{
+	ENSURE_VALID_PTR(gui, "The gui was nullptr when the function save was called in InterfaceState");
+
+	const std::string blob{ snapshot(gui, fields) };
+	if (blob.empty()) [[unlikely]]
+	{	// Writing it would replace the previous state by a corrupted one.
+		std::ostringstream errorMessage{};
+		errorMessage << "The state of the interface could not be encoded: " << fileName << '\n';
+		errorMessage << "Error: the previous save is kept" << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	return SafeSaves::Save::writingBlob(fileName, blob);
+}
+
+std::optional<std::string> InterfaceState::load(const std::string& fileName, AdvancedInterface* gui, std::span<const InterfaceField> fields) noexcept
+{
+	ENSURE_VALID_PTR(gui, "The gui was nullptr when the function load was called in InterfaceState");
+
+	std::string blob{};
+	if (auto error{ SafeSaves::Save::readingBlob(fileName, blob) })
+		return error;
+
+	if (!restore(gui, fields, blob)) [[unlikely]]
+	{
+		std::ostringstream errorMessage{};
+		errorMessage << "The state of the interface is corrupted: " << fileName << '\n';
+		errorMessage << "Error: the interface keeps its current state" << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	return std::nullopt;
+}
+
+} // gui namespace
@@ -0,0 +1,167 @@
+/*******************************************************************
+ * \file   InterfaceState.hpp, InterfaceState.cpp
+ * \brief  Declare the snapshots of what the user changed in a gui: sliders, boxes and texts.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ *********************************************************************/
+
+#ifndef INTERFACESTATE_HPP
+#define INTERFACESTATE_HPP
+
+#include "AdvancedInterface.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace gui
+{
+
+/**
+ * \brief Describes one element of a gui whose state is saved, e.g. a slider named "volume".
+ *
+ * Descriptors are meant to be declared once, at compile time, for each screen to save.
+ *
+ * \see `InterfaceState`, `hasUniqueFields`.
+ */
+struct InterfaceField
+{
+	enum class Kind : std::uint8_t
+	{
+		Slider = 1, // The position of its cursor.
+		MultipleQuestionBoxes = 2, // The boxes checked.
+		Text = 3 // The content of a dynamic text in UTF-8, e.g. a writable one.
+	} kind;
+
+	std::string_view identifier; // The identifier given when the element was added.
+
+	[[nodiscard]] static constexpr InterfaceField slider(std::string_view identifier) noexcept { return InterfaceField{ Kind::Slider, identifier }; }
+	[[nodiscard]] static constexpr InterfaceField mqb(std::string_view identifier) noexcept { return InterfaceField{ Kind::MultipleQuestionBoxes, identifier }; }
+	[[nodiscard]] static constexpr InterfaceField text(std::string_view identifier) noexcept { return InterfaceField{ Kind::Text, identifier }; }
+};
+
+/**
+ * \brief Checks, at compile time, that no element is described twice.
+ * \complexity O(N²) where N is the number of fields, at compile time.
+ *
+ * \param[in] fields The descriptors of a screen.
+ *
+ * \return `true` if each identifier is used once per kind.
+ */
+template<size_t N>
+[[nodiscard]] consteval bool hasUniqueFields(const std::array<InterfaceField, N>& fields) noexcept
+{
+	for (size_t i{ 0 }; i < N; ++i)
+		for (size_t j{ i + 1 }; j < N; ++j)
+			if (fields[i].kind == fields[j].kind && fields[i].identifier == fields[j].identifier)
+				return false;
+
+	return true;
+}
+
+/**
+ * \brief Snapshots and restores the state of an `AdvancedInterface` as a single compact blob.
+ *
+ * Only the elements described by the fields are saved. The blob stores each of them with its kind
+ * and identifier, so a screen can gain or lose elements between two versions of the game: elements
+ * missing from the blob keep their current state, and entries no longer described are ignored.
+ * Restoring a whole settings screen is then a single read, through `SafeSaves::Save::readingBlob`.
+ *
+ * \note This class is non-instantiable and only contains static methods.
+ * \note Sliders are saved by the position of their cursor: restoring it calls their function as
+ *		 if the user moved it, with the same value.
+ *
+ * \see `InterfaceField`, `SafeSaves::Save`.
+ *
+ * \code
+ * static constexpr std::array settingsFields{ gui::InterfaceField::slider("volume"), gui::InterfaceField::mqb("difficulty"), gui::InterfaceField::text("name") };
+ * static_assert(gui::hasUniqueFields(settingsFields));
+ *
+ * if (auto error{ gui::InterfaceState::load("settings.sav", &settingsInterface, settingsFields) })
+ *     showErrorsUsingWindow("Settings", std::ostringstream{ error.value() });
+ *
+ * // When leaving the screen.
+ * auto error{ gui::InterfaceState::save("settings.sav", &settingsInterface, settingsFields) };
+ * \endcode
+ */
+class InterfaceState
+{
+public:
+
+	InterfaceState() noexcept = delete;
+	InterfaceState(const InterfaceState&) noexcept = delete;
+	InterfaceState(InterfaceState&&) noexcept = delete;
+	InterfaceState& operator=(const InterfaceState&) noexcept = delete;
+	InterfaceState& operator=(InterfaceState&&) noexcept = delete;
+	~InterfaceState() noexcept = delete;
+
+
+	/**
+	 * \brief Encodes the state of the elements described.
+	 * \complexity O(N) where N is the number of fields.
+	 *
+	 * \param[in] gui The interface to snapshot.
+	 * \param[in] fields The elements to save. Those not found in the gui are skipped.
+	 *
+	 * \return The blob, or an empty string if memory ran out. `restore` rejects an empty blob.
+	 *
+	 * \warning Asserts if gui is nullptr.
+	 */
+	[[nodiscard]] static std::string snapshot(AdvancedInterface* gui, std::span<const InterfaceField> fields) noexcept;
+
+	/**
+	 * \brief Restores the state of the elements described from a blob given by `snapshot`.
+	 * \complexity O(N + M) where N is the number of fields, and M the size of the blob.
+	 *
+	 * \param[out] gui The interface to restore.
+	 * \param[in] fields The elements to restore.
+	 * \param[in] blob The blob.
+	 *
+	 * \return `false` if the blob is corrupted. Nothing is restored then.
+	 *
+	 * \warning Asserts if gui is nullptr.
+	 */
+	[[nodiscard]] static bool restore(AdvancedInterface* gui, std::span<const InterfaceField> fields, std::string_view blob) noexcept;
+
+	/**
+	 * \brief Snapshots the interface into a save file.
+	 * \complexity O(N) where N is the number of fields.
+	 *
+	 * \param[in] fileName The name of the save file, created with `SafeSaves::Save::createFile`.
+	 * \param[in] gui The interface to save.
+	 * \param[in] fields The elements to save.
+	 *
+	 * \return An optional string that contains an error message.
+	 *
+	 * \see `snapshot`, `SafeSaves::Save::writingBlob`.
+	 */
+	[[nodiscard]] static std::optional<std::string> save(const std::string& fileName, AdvancedInterface* gui, std::span<const InterfaceField> fields) noexcept;
+
+	/**
+	 * \brief Restores the interface from a save file.
+	 * \complexity O(N + M) where N is the number of fields, and M the size of the file.
+	 *
+	 * \param[in] fileName The name of the save file.
+	 * \param[out] gui The interface to restore.
+	 * \param[in] fields The elements to restore.
+	 *
+	 * \return An optional string that contains an error message. Nothing is restored then.
+	 *
+	 * \see `restore`, `SafeSaves::Save::readingBlob`.
+	 */
+	[[nodiscard]] static std::optional<std::string> load(const std::string& fileName, AdvancedInterface* gui, std::span<const InterfaceField> fields) noexcept;
+
+private:
+
+	inline static constexpr std::uint32_t magicNumber{ 0x53494753 }; // "SGIS" in little endian.
+	inline static constexpr std::uint16_t formatVersion{ 1 };
+};
+
+} // gui namespace
+
+#endif //INTERFACESTATE_HPP
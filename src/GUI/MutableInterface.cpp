@@ -47,6 +47,7 @@ void MutableInterface::removeDynamicSprite(std::string_view identifier) noexcept
 	m_indexesForEachDynamicSprites.erase(m_sprites.size() - 1);
 	m_dynamicSprites.erase(mapIterator); 
 	m_sprites.pop_back();
+	discardPreparedFrame();
 }
 
 TextWrapper* MutableInterface::getDynamicText(std::string_view identifier) noexcept
@@ -66,7 +67,81 @@ SpriteWrapper* MutableInterface::getDynamicSprite(std::string_view identifier) n
 	if (mapIterator == m_dynamicSprites.end())
 		return nullptr;
 
+	discardPreparedFrame(); // Hidden, recolored, rotated or switching texture: the vertices prepared would be stale.
 	return &m_sprites[mapIterator->second];
 }
 
+size_t MutableInterface::applyCommands() noexcept
+{
+	if (m_commands.empty()) [[likely]]
+		return 0;
+
+	GUI_PROFILE_SCOPE("MutableInterface::applyCommands");
+
+	try
+	{
+		size_t applied{ 0 };
+		for (const auto& command : m_commands.drain())
+			applied += applyCommand(command);
+
+		return applied;
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected: the commands are dropped.
+		return 0;
+	}
+}
+
+bool MutableInterface::applyCommand(const CommandQueue::Command& command) noexcept
+{
+	using Type = CommandQueue::Command::Type;
+
+	const bool concernsText{ command.type == Type::TextContent || command.type == Type::TextPosition || command.type == Type::TextHidden };
+	TextWrapper* text{ concernsText ? getDynamicText(command.identifier) : nullptr };
+	SpriteWrapper* sprite{ concernsText ? nullptr : getDynamicSprite(command.identifier) };
+
+	if (text == nullptr && sprite == nullptr)
+		return false;
+
+	switch (command.type)
+	{
+	case Type::TextContent:
+		text->setContent(command.content);
+		return true;
+
+	case Type::TextPosition:
+		text->setPosition(command.position);
+		return true;
+
+	case Type::TextHidden:
+		text->hide = command.hidden;
+		return true;
+
+	case Type::SpritePosition:
+		sprite->setPosition(command.position);
+		return true;
+
+	case Type::SpriteHidden:
+		sprite->hide = command.hidden;
+		return true;
+
+	case Type::SpriteTexture:
+		if (command.textureIndex >= sprite->getTextureCount()) [[unlikely]]
+			return false;
+
+		try
+		{
+			sprite->switchToTexture(command.textureIndex);
+			return true;
+		}
+		catch (const LoadingGraphicalResourceFailure&)
+		{	// The texture could not be loaded: the sprite keeps its current one.
+			return false;
+		}
+
+	default:
+		return false; // Not an element of this interface, e.g. a slider.
+	}
+}
+
 } // gui namespace
\ No newline at end of file
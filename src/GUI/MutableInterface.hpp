@@ -13,6 +13,7 @@
 #define MUTABLEINTERFACE_HPP
 
 #include "BasicInterface.hpp"
+#include "CommandQueue.hpp"
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <string_view>
@@ -59,6 +60,7 @@ public:
 	 * \complexity O(1)
 	 *
 	 * \param[in,out] window A valid pointer to the SFML window where interface elements will be rendered.
+	 *				  Any render target works, e.g. an `sf::RenderTexture` to render offscreen.
 	 * \param[in] relativeScalingDefinition A scaling baseline to ensure consistent visual proportions across
 	 *			  various window sizes. Scales of `sf::Transformable` elements are adjusted based on the window size
 	 *			  relative to this reference value:
@@ -79,8 +81,8 @@ public:
 	 * \pre `window` must be a valid.
 	 * \warning The program will assert otherwise.
 	 */
-	inline explicit MutableInterface(sf::RenderWindow* window, unsigned int relativeScalingDefinition = 1080) noexcept
-		: BasicInterface{ window, relativeScalingDefinition }, m_dynamicTexts{}, m_dynamicSprites{}, m_indexesForEachDynamicTexts{}, m_indexesForEachDynamicSprites{}
+	inline explicit MutableInterface(sf::RenderTarget* window, unsigned int relativeScalingDefinition = 1080) noexcept
+		: BasicInterface{ window, relativeScalingDefinition }, m_dynamicTexts{}, m_dynamicSprites{}, m_indexesForEachDynamicTexts{}, m_indexesForEachDynamicSprites{}, m_commands{}
 	{}
 
 	MutableInterface() noexcept = default;
@@ -213,6 +215,8 @@ public:
 	 *
 	 * \return The address of the sprite.
 	 *
+	 * \note The sprite may be modified through it: the frame prepared for this interface is
+	 *		 discarded, see `prepareFrame`.
 	 * \warning The returned pointer is not guaranteed to be valid after ANY addition or removal of a
 	 *			dynamic sprite.
 	 * 
@@ -220,6 +224,35 @@ public:
 	 */
 	[[nodiscard]] SpriteWrapper* getDynamicSprite(std::string_view identifier) noexcept;
 
+	/**
+	 * \brief Returns the queue other threads push changes into, applied by `applyCommands`.
+	 * \complexity O(1).
+	 *
+	 * \return The queue of the interface, valid as long as the interface is not moved or destroyed.
+	 *
+	 * \see `CommandQueue`, `applyCommands`.
+	 */
+	[[nodiscard]] inline CommandQueue& getCommandQueue() noexcept
+	{
+		return m_commands;
+	}
+
+	/**
+	 * \brief Applies the changes pushed into the queue of the interface by other threads, at once.
+	 * \complexity O(N) where N is the number of commands pushed since the last call.
+	 *
+	 * Call it from the thread drawing the interface, e.g. at the start of each frame. Only the last
+	 * command of each kind for each element is applied. Those for elements that do not exist (anymore)
+	 * are ignored.
+	 *
+	 * \return The number of commands applied.
+	 *
+	 * \note If there is not enough memory, the commands pushed so far are dropped.
+	 *
+	 * \see `CommandQueue`, `getCommandQueue`.
+	 */
+	size_t applyCommands() noexcept;
+
 protected:
 
 	using MutableElementUmap = std::unordered_map<std::string, size_t, TransparentHash, TransparentEqual>;
@@ -230,6 +263,21 @@ protected:
 	std::unordered_map<size_t, UmapMutablesIterator> m_indexesForEachDynamicTexts; // Allows removal of dynamic texts in O(1).
 	std::unordered_map<size_t, UmapMutablesIterator> m_indexesForEachDynamicSprites; // Allows removal of dynamic sprites in O(1).
 
+	CommandQueue m_commands; // The changes pushed by other threads, applied by `applyCommands`.
+
+
+	/**
+	 * \brief Applies a command drained from the queue of the interface.
+	 * \complexity O(1).
+	 *
+	 * \param[in] command The change, to a dynamic text or sprite.
+	 *
+	 * \return `false` if the element does not exist, or the command does not concern this interface.
+	 *
+	 * \note Overridden by the interfaces with other elements, e.g. sliders.
+	 */
+	virtual bool applyCommand(const CommandQueue::Command& command) noexcept;
+
 
 	/**
 	 * \brief Swaps two elements in the vector, and updates the identifier map and index map accordingly.
@@ -0,0 +1,238 @@
+#ifdef GUI_PROFILING
+
+#include "Profiler.hpp"
+#include "GraphicalResources.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+namespace gui
+{
+
+namespace
+{
+/// The names of the counters, in the order of `Profiler::Counter`.
+constexpr std::array<std::string_view, Profiler::counterCount> counterNames{ "drawCalls", "elementsDrawn", "hitTests", "textureLoads", "setContentCalls" };
+
+/// Number of zones opened on this thread and not ended yet.
+thread_local std::uint32_t openedZones{ 0 };
+
+/// The thread that calls `newFrame`, which is the thread 0 of the trace.
+std::atomic<std::thread::id> frameThread{};
+
+/// Gives the other threads an index, in the order they first end a zone.
+std::atomic<std::uint32_t> otherThreads{ 0 };
+
+/// Returns the index of the calling thread in the trace.
+std::uint32_t threadIndex() noexcept
+{
+	if (std::this_thread::get_id() == frameThread.load(std::memory_order_relaxed))
+		return 0;
+
+	thread_local const std::uint32_t index{ otherThreads.fetch_add(1, std::memory_order_relaxed) + 1 };
+	return index;
+}
+
+/// Writes a name as a JSON string.
+void writeJsonString(std::ostream& stream, std::string_view text)
+{
+	stream << '"';
+	for (const char character : text)
+	{
+		if (character == '"' || character == '\\')
+			stream << '\\';
+
+		stream << character;
+	}
+	stream << '"';
+}
+
+/// Writes nanoseconds as the microseconds of the trace.
+void writeMicroseconds(std::ostream& stream, std::int64_t nanoseconds)
+{
+	stream << nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << nanoseconds % 1000;
+}
+}
+
+
+Profiler::Scope::Scope(const char* name) noexcept
+	: m_name{ name }, m_start{ std::chrono::steady_clock::now() }
+{
+	++openedZones;
+}
+
+Profiler::Scope::~Scope() noexcept
+{
+	const auto end{ std::chrono::steady_clock::now() };
+	--openedZones;
+
+	const Zone zone{ m_name, sinceStart(m_start), std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_start).count(), threadIndex(), openedZones };
+
+	try
+	{
+		std::unique_lock lock{ s_mutex };
+		s_current.zones.push_back(zone);
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: the zone is lost, not the frame.
+}
+
+void Profiler::newFrame() noexcept
+{
+	const std::int64_t now{ sinceStart(std::chrono::steady_clock::now()) };
+	frameThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+
+	std::unique_lock lock{ s_mutex };
+
+	s_current.index = s_framesEnded;
+	s_current.duration = now - s_current.start;
+	for (size_t i{ 0 }; i < counterCount; ++i)
+		s_current.counters[i] = s_counters[i].exchange(0, std::memory_order_relaxed);
+
+	// The oldest frame becomes the current one: its zones keep their memory.
+	std::swap(s_frames[s_framesEnded % frameCapacity], s_current);
+	++s_framesEnded;
+
+	s_current.start = now;
+	s_current.zones.clear();
+}
+
+const Profiler::Frame* Profiler::frame(size_t age) noexcept
+{
+	if (age >= recordedFrames())
+		return nullptr;
+
+	return &s_frames[(s_framesEnded - 1 - age) % frameCapacity];
+}
+
+size_t Profiler::recordedFrames() noexcept
+{
+	return static_cast<size_t>(std::min<std::uint64_t>(s_framesEnded, frameCapacity));
+}
+
+bool Profiler::exportChromeTrace(std::ostream& stream) noexcept
+{
+	try
+	{
+		stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		bool first{ true };
+		for (size_t age{ recordedFrames() }; age-- > 0;)
+		{	// From the oldest to the last frame.
+			const Frame& recorded{ *frame(age) };
+
+			stream << ((first) ? "\n" : ",\n") << "{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":";
+			writeMicroseconds(stream, recorded.start);
+			stream << ",\"dur\":";
+			writeMicroseconds(stream, recorded.duration);
+			stream << ",\"args\":{\"index\":" << recorded.index << "}}";
+			first = false;
+
+			stream << ",\n{\"name\":\"Counters\",\"ph\":\"C\",\"pid\":0,\"tid\":0,\"ts\":";
+			writeMicroseconds(stream, recorded.start);
+			stream << ",\"args\":{";
+			for (size_t i{ 0 }; i < counterCount; ++i)
+				stream << ((i == 0) ? "\"" : ",\"") << counterNames[i] << "\":" << recorded.counters[i];
+			stream << "}}";
+
+			for (const auto& zone : recorded.zones)
+			{
+				stream << ",\n{\"name\":";
+				writeJsonString(stream, zone.name);
+				stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << zone.thread << ",\"ts\":";
+				writeMicroseconds(stream, zone.start);
+				stream << ",\"dur\":";
+				writeMicroseconds(stream, zone.duration);
+				stream << ",\"args\":{\"frame\":" << recorded.index << ",\"depth\":" << zone.depth << "}}";
+			}
+		}
+
+		stream << "\n]}\n";
+		stream.flush();
+	}
+	catch (const std::exception&)
+	{
+		return false;
+	}
+
+	return static_cast<bool>(stream);
+}
+
+bool Profiler::exportChromeTrace(const std::string& fileName) noexcept
+{
+	std::ofstream file{ fileName, std::ios::trunc };
+	if (!file.is_open()) [[unlikely]]
+		return false;
+
+	return exportChromeTrace(file);
+}
+
+void Profiler::drawOverlay(sf::RenderTarget& target, std::string_view fontName) noexcept
+{
+	static constexpr unsigned int characterSize{ 16 };
+	static constexpr size_t maxZonesShown{ 8 };
+	static std::optional<TextWrapper> overlay{};
+
+	const Frame* const last{ frame() };
+	if (last == nullptr || TextWrapper::getFont(fontName) == nullptr)
+		return;
+
+	try
+	{
+		std::int64_t total{ 0 }, worst{ 0 };
+		for (size_t age{ 0 }; age < recordedFrames(); ++age)
+		{
+			total += frame(age)->duration;
+			worst = std::max(worst, frame(age)->duration);
+		}
+
+		// The time of the zones of the last frame, by name.
+		std::vector<std::pair<std::string_view, std::int64_t>> zones{};
+		for (const auto& zone : last->zones)
+		{
+			auto it{ std::find_if(zones.begin(), zones.end(), [&zone](const auto& named) { return named.first == zone.name; }) };
+			if (it == zones.end())
+				zones.emplace_back(zone.name, zone.duration);
+			else
+				it->second += zone.duration;
+		}
+		std::sort(zones.begin(), zones.end(), [](const auto& lhs, const auto& rhs) { return lhs.second > rhs.second; });
+
+		std::ostringstream summary{};
+		summary << std::fixed << std::setprecision(2);
+		summary << "frame " << last->duration / 1e6 << " ms   mean " << total / 1e6 / recordedFrames() << " ms   worst " << worst / 1e6 << " ms\n";
+		for (size_t i{ 0 }; i < counterCount; ++i)
+			summary << counterNames[i] << ' ' << last->counters[i] << ((i + 1 == counterCount) ? "\n" : "   ");
+		for (size_t i{ 0 }; i < std::min(zones.size(), maxZonesShown); ++i)
+			summary << zones[i].first << ' ' << zones[i].second / 1e6 << " ms\n";
+
+		if (!overlay.has_value())
+			overlay.emplace("", fontName, characterSize, sf::Vector2f{ 8.f, 8.f }, sf::Vector2f{ 1.f, 1.f }, sf::Color::White, Alignment::Top | Alignment::Left);
+		else
+			overlay->setFont(fontName);
+
+		overlay->setContent(summary.str());
+		s_counters[static_cast<size_t>(Counter::SetContentCalls)].fetch_sub(1, std::memory_order_relaxed); // Not counted.
+
+		const sf::View userView{ target.getView() };
+		target.setView(target.getDefaultView()); // Not moved nor scaled with the guis.
+		target.draw(overlay->getText());
+		target.setView(userView);
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: the overlay is not drawn this frame.
+}
+
+std::int64_t Profiler::sinceStart(std::chrono::steady_clock::time_point time) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time - s_epoch).count();
+}
+
+} // gui namespace
+
+#endif // GUI_PROFILING
@@ -0,0 +1,267 @@
+/*******************************************************************
+ * \file   Profiler.hpp, Profiler.cpp
+ * \brief  Declare a frame profiler: scoped timers, per-frame counters and a trace export.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ * \note Everything is compiled only if `GUI_PROFILING` is defined (CMake option `GUI_PROFILING`).
+ *		 Otherwise, the macros expand to nothing and the profiler does not exist: no overhead at all.
+ *********************************************************************/
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#ifdef GUI_PROFILING
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gui
+{
+
+/**
+ * \brief Measures where the time of each frame goes.
+ *
+ * Scoped timers (zones) record the time spent in the functions of the guis, and counters record
+ * how much work each frame did: draw calls, elements drawn, hit-tests, texture loads and calls to
+ * `setContent`. The last `frameCapacity` frames are kept in a ring buffer, and can be exported as
+ * Chrome trace events (chrome://tracing, Perfetto) or summarized on screen with `drawOverlay`.
+ *
+ * Use the macros rather than this class directly: `GUI_PROFILE_FRAME`, `GUI_PROFILE_SCOPE` and
+ * `GUI_PROFILE_COUNT` expand to nothing when `GUI_PROFILING` is not defined.
+ *
+ * \note This class is non-instantiable and only contains static methods.
+ * \note Zones and counters can be recorded from any thread. The other functions must be called by
+ *		 the thread that calls `newFrame`.
+ *
+ * \see `GUI_PROFILE_FRAME`, `GUI_PROFILE_SCOPE`, `GUI_PROFILE_COUNT`.
+ *
+ * \code
+ * while (window.isOpen())
+ * {
+ *     GUI_PROFILE_FRAME();
+ *     // Events...
+ *
+ *     window.clear();
+ *     curInterface->draw();
+ * #ifdef GUI_PROFILING
+ *     gui::Profiler::drawOverlay(window);
+ * #endif
+ *     window.display();
+ * }
+ *
+ * #ifdef GUI_PROFILING
+ * gui::Profiler::exportChromeTrace("frames.json");
+ * #endif
+ * \endcode
+ */
+class Profiler
+{
+public:
+
+	/// What is counted for each frame.
+	enum class Counter : std::uint8_t
+	{
+		DrawCalls,
+		ElementsDrawn,
+		HitTests,
+		TextureLoads,
+		SetContentCalls,
+		Count // Number of counters, not a counter.
+	};
+
+	inline static constexpr size_t counterCount{ static_cast<size_t>(Counter::Count) };
+
+	/// A zone timed within a frame.
+	struct Zone
+	{
+		const char* name; // A string literal, given to `GUI_PROFILE_SCOPE`.
+		std::int64_t start; // In nanoseconds, since the profiler started.
+		std::int64_t duration; // In nanoseconds.
+		std::uint32_t thread; // 0 for the thread that calls `newFrame`.
+		std::uint32_t depth; // Number of zones opened around this one, on its thread.
+	};
+
+	/// A recorded frame.
+	struct Frame
+	{
+		std::uint64_t index; // Number of frames recorded before this one.
+		std::int64_t start; // In nanoseconds, since the profiler started.
+		std::int64_t duration; // In nanoseconds.
+		std::array<std::uint64_t, counterCount> counters;
+		std::vector<Zone> zones; // In the order they ended.
+	};
+
+	/**
+	 * \brief Times the scope it is declared in, as a zone of the current frame.
+	 *
+	 * \see `GUI_PROFILE_SCOPE`.
+	 */
+	class Scope
+	{
+	public:
+
+		/**
+		 * \complexity O(1).
+		 *
+		 * \param[in] name The name of the zone. It must be a string literal: only the pointer is kept.
+		 */
+		explicit Scope(const char* name) noexcept;
+
+		Scope(const Scope&) noexcept = delete;
+		Scope(Scope&&) noexcept = delete;
+		Scope& operator=(const Scope&) noexcept = delete;
+		Scope& operator=(Scope&&) noexcept = delete;
+
+		/// \complexity Amortized O(1).
+		~Scope() noexcept;
+
+	private:
+
+		const char* m_name;
+		std::chrono::steady_clock::time_point m_start;
+	};
+
+
+	Profiler() noexcept = delete;
+	Profiler(const Profiler&) noexcept = delete;
+	Profiler(Profiler&&) noexcept = delete;
+	Profiler& operator=(const Profiler&) noexcept = delete;
+	Profiler& operator=(Profiler&&) noexcept = delete;
+	~Profiler() noexcept = delete;
+
+
+	/**
+	 * \brief Ends the current frame, keeps it in the ring buffer, and begins the next one.
+	 * \complexity O(1): the memory of the oldest frame is reused.
+	 *
+	 * \note Call it once per frame, before the events are handled.
+	 */
+	static void newFrame() noexcept;
+
+	/**
+	 * \brief Adds to a counter of the current frame.
+	 * \complexity O(1).
+	 *
+	 * \param[in] counter The counter.
+	 * \param[in] amount The amount to add.
+	 *
+	 * \see `GUI_PROFILE_COUNT`.
+	 */
+	inline static void count(Counter counter, std::uint64_t amount = 1) noexcept
+	{
+		s_counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+	}
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \param[in] age 0 for the last frame ended, 1 for the one before, etc.
+	 *
+	 * \return The frame, or `nullptr` if it is not in the ring buffer. Valid until `newFrame`.
+	 */
+	[[nodiscard]] static const Frame* frame(size_t age = 0) noexcept;
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \return The number of frames in the ring buffer.
+	 */
+	[[nodiscard]] static size_t recordedFrames() noexcept;
+
+	/**
+	 * \brief Writes the frames of the ring buffer as Chrome trace events (JSON).
+	 * \complexity O(N) where N is the number of zones recorded.
+	 *
+	 * Each frame is a zone named "Frame" on the thread 0, with its counters as counter events.
+	 *
+	 * \param[out] stream Where the JSON is written.
+	 *
+	 * \return `false` if the stream failed.
+	 */
+	static bool exportChromeTrace(std::ostream& stream) noexcept;
+
+	/**
+	 * \see `exportChromeTrace(std::ostream&)`.
+	 *
+	 * \param[in] fileName The path of the file to create.
+	 */
+	static bool exportChromeTrace(const std::string& fileName) noexcept;
+
+	/**
+	 * \brief Draws a summary of the last frames at the top left of a target.
+	 * \complexity O(F + N) where F is the number of frames kept, and N the number of zones of the
+	 *			   last frame.
+	 *
+	 * The summary shows the duration of the last frame, the mean and worst over the ring buffer,
+	 * the counters of the last frame, and the total time of its zones by name.
+	 *
+	 * \param[out] target Where the summary is drawn, usually the window.
+	 * \param[in] fontName The font used, created with `TextWrapper::createFont`. Nothing is drawn
+	 *			  if it does not exist.
+	 *
+	 * \note What the overlay draws is not counted.
+	 */
+	static void drawOverlay(sf::RenderTarget& target, std::string_view fontName = "__default") noexcept;
+
+
+	inline static constexpr size_t frameCapacity{ 240 };
+
+private:
+
+	/// Returns the time elapsed since the profiler started, in nanoseconds.
+	[[nodiscard]] static std::int64_t sinceStart(std::chrono::steady_clock::time_point time) noexcept;
+
+	/// The counters of the current frame.
+	inline static std::array<std::atomic<std::uint64_t>, counterCount> s_counters{};
+
+	/// Protects the current frame, as zones can be recorded from any thread.
+	inline static std::mutex s_mutex{};
+
+	/// The frame being recorded.
+	inline static Frame s_current{};
+
+	/// The last frames ended, oldest overwritten first.
+	inline static std::array<Frame, frameCapacity> s_frames{};
+
+	/// The number of frames ended since the profiler started.
+	inline static std::uint64_t s_framesEnded{ 0 };
+
+	/// Where the times are measured from.
+	inline static const std::chrono::steady_clock::time_point s_epoch{ std::chrono::steady_clock::now() };
+};
+
+} // gui namespace
+
+#define GUI_PROFILE_CONCATENATE_IMPL(lhs, rhs) lhs##rhs
+#define GUI_PROFILE_CONCATENATE(lhs, rhs) GUI_PROFILE_CONCATENATE_IMPL(lhs, rhs)
+
+/// Ends the current frame and begins the next one.
+#define GUI_PROFILE_FRAME() \
+	::gui::Profiler::newFrame()
+
+/// Times the rest of the scope as a zone. The name must be a string literal.
+#define GUI_PROFILE_SCOPE(name) \
+	const ::gui::Profiler::Scope GUI_PROFILE_CONCATENATE(profileScope, __LINE__){ (name) }
+
+/// Adds an amount to a counter of the current frame, e.g. `GUI_PROFILE_COUNT(DrawCalls, 1)`.
+#define GUI_PROFILE_COUNT(counter, amount) \
+	::gui::Profiler::count(::gui::Profiler::Counter::counter, (amount))
+
+#else
+#define GUI_PROFILE_FRAME()
+#define GUI_PROFILE_SCOPE(name)
+#define GUI_PROFILE_COUNT(counter, amount)
+#endif // GUI_PROFILING
+
+#endif //PROFILER_HPP
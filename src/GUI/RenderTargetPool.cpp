@@ -0,0 +1,82 @@
+#include "RenderTargetPool.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace gui
+{
+
+RenderTargetPool::Lease::Lease(std::unique_ptr<sf::RenderTexture> renderTexture) noexcept
+	: m_renderTexture{ std::move(renderTexture) }
+{}
+
+RenderTargetPool::Lease& RenderTargetPool::Lease::operator=(Lease&& other) noexcept
+{
+	if (this != &other)
+	{
+		if (m_renderTexture != nullptr)
+			release(std::move(m_renderTexture));
+
+		m_renderTexture = std::move(other.m_renderTexture);
+	}
+
+	return *this;
+}
+
+RenderTargetPool::Lease::~Lease() noexcept
+{
+	if (m_renderTexture != nullptr)
+		release(std::move(m_renderTexture));
+}
+
+RenderTargetPool::Lease RenderTargetPool::acquire(sf::Vector2u size) noexcept
+{
+	GUI_PROFILE_SCOPE("RenderTargetPool::acquire");
+
+	// The last released first: the most likely to be asked again, e.g. while widgets of a kind are built.
+	const auto available{ std::find_if(s_available.rbegin(), s_available.rend(), [size](const auto& renderTexture) { return renderTexture->getSize() == size; }) };
+	if (available != s_available.rend())
+	{
+		auto renderTexture{ std::move(*available) };
+		s_available.erase(std::next(available).base());
+		return Lease{ std::move(renderTexture) };
+	}
+
+	try
+	{
+		auto renderTexture{ std::make_unique<sf::RenderTexture>() };
+		if (!renderTexture->resize(size)) [[unlikely]]
+			return Lease{};
+
+		return Lease{ std::move(renderTexture) };
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected.
+		return Lease{};
+	}
+}
+
+void RenderTargetPool::clear() noexcept
+{
+	s_available.clear();
+}
+
+size_t RenderTargetPool::available() noexcept
+{
+	return s_available.size();
+}
+
+void RenderTargetPool::release(std::unique_ptr<sf::RenderTexture> renderTexture) noexcept
+{
+	try
+	{
+		if (s_available.size() >= capacity)
+			s_available.erase(s_available.begin());
+
+		s_available.push_back(std::move(renderTexture));
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: the render texture is destroyed instead.
+}
+
+} // gui namespace
@@ -0,0 +1,138 @@
+/*******************************************************************
+ * \file   RenderTargetPool.hpp, RenderTargetPool.cpp
+ * \brief  Declare a pool of render textures, reused instead of created for each generated texture.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ *********************************************************************/
+
+#ifndef RENDERTARGETPOOL_HPP
+#define RENDERTARGETPOOL_HPP
+
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+
+namespace gui
+{
+
+/**
+ * \brief Keeps the render textures released, to be reused by the next ones of the same size.
+ *
+ * Each `sf::RenderTexture` owns a frame buffer and a texture: creating and destroying one for each
+ * texture generated from drawables is costly. The pool keeps the last ones released, and gives one
+ * back when a render texture of the same size is acquired.
+ *
+ * \note This class is non-instantiable and only contains static methods.
+ * \note Only a render texture of the exact size is reused: the texture copied from it must not be
+ *		 larger than what was drawn. Widgets of a kind usually share their size.
+ * \note Use it from the thread that draws only.
+ *
+ * \see `createTextureFromDrawables`, `TextureBatch`.
+ *
+ * \code
+ * auto renderTexture{ gui::RenderTargetPool::acquire(sf::Vector2u{ 64, 64 }) };
+ * if (renderTexture)
+ * {
+ *     renderTexture->clear(sf::Color::Transparent);
+ *     renderTexture->draw(shape);
+ *     renderTexture->display();
+ *     sf::Texture texture{ renderTexture->getTexture() };
+ * } // Back to the pool.
+ * \endcode
+ */
+class RenderTargetPool
+{
+public:
+
+	/**
+	 * \brief A render texture taken from the pool, given back when destroyed.
+	 */
+	class Lease
+	{
+	public:
+
+		Lease() noexcept = default;
+		Lease(const Lease&) noexcept = delete;
+		Lease(Lease&&) noexcept = default;
+		Lease& operator=(const Lease&) noexcept = delete;
+		Lease& operator=(Lease&& other) noexcept;
+
+		/// \complexity Amortized O(1).
+		~Lease() noexcept;
+
+		/// \return `false` if the render texture could not be created.
+		[[nodiscard]] inline explicit operator bool() const noexcept
+		{
+			return m_renderTexture != nullptr;
+		}
+
+		[[nodiscard]] inline sf::RenderTexture* operator->() const noexcept
+		{
+			return m_renderTexture.get();
+		}
+
+		[[nodiscard]] inline sf::RenderTexture& operator*() const noexcept
+		{
+			return *m_renderTexture;
+		}
+
+	private:
+
+		explicit Lease(std::unique_ptr<sf::RenderTexture> renderTexture) noexcept;
+
+		std::unique_ptr<sf::RenderTexture> m_renderTexture;
+
+	friend class RenderTargetPool;
+	};
+
+
+	RenderTargetPool() noexcept = delete;
+	RenderTargetPool(const RenderTargetPool&) noexcept = delete;
+	RenderTargetPool(RenderTargetPool&&) noexcept = delete;
+	RenderTargetPool& operator=(const RenderTargetPool&) noexcept = delete;
+	RenderTargetPool& operator=(RenderTargetPool&&) noexcept = delete;
+	~RenderTargetPool() noexcept = delete;
+
+
+	/**
+	 * \brief Takes a render texture of a size from the pool, or creates it if there is none.
+	 * \complexity O(C) where C is the capacity of the pool.
+	 *
+	 * \param[in] size The size of the render texture.
+	 *
+	 * \return The render texture, empty if it could not be created. Its content is undefined: clear it.
+	 */
+	[[nodiscard]] static Lease acquire(sf::Vector2u size) noexcept;
+
+	/**
+	 * \brief Destroys the render textures kept.
+	 * \complexity O(C) where C is the capacity of the pool.
+	 */
+	static void clear() noexcept;
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \return The number of render textures kept.
+	 */
+	[[nodiscard]] static size_t available() noexcept;
+
+
+	/// The render textures kept at most. The oldest released is destroyed first.
+	inline static constexpr size_t capacity{ 8 };
+
+private:
+
+	/// Keeps a render texture, destroying the oldest one if the pool is full.
+	static void release(std::unique_ptr<sf::RenderTexture> renderTexture) noexcept;
+
+	/// The render textures released, oldest first.
+	inline static std::vector<std::unique_ptr<sf::RenderTexture>> s_available{};
+};
+
+} // gui namespace
+
+#endif //RENDERTARGETPOOL_HPP
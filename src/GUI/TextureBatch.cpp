@@ -0,0 +1,82 @@
+#include "TextureBatch.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace gui
+{
+
+std::vector<sf::IntRect> TextureBatch::build(std::string textureName, unsigned int padding)
+{
+	GUI_PROFILE_SCOPE("TextureBatch::build");
+
+	if (SpriteWrapper::getTexture(textureName) != nullptr) [[unlikely]]
+		throw std::invalid_argument{ "Precondition violated; the texture " + textureName + " already exists when the function build of TextureBatch was called" };
+
+	if (m_groups.empty())
+		return std::vector<sf::IntRect>{};
+
+	// Shelf packing: the groups, tallest first, fill the rows of a roughly square atlas from left to right.
+	std::vector<size_t> order(m_groups.size());
+	std::iota(order.begin(), order.end(), size_t{ 0 });
+	std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs) { return m_groups[lhs].size.y > m_groups[rhs].size.y; });
+
+	unsigned long long area{ 0 };
+	unsigned int widest{ 0 };
+	for (const auto& group : m_groups)
+	{
+		area += static_cast<unsigned long long>(group.size.x + padding) * (group.size.y + padding);
+		widest = std::max(widest, group.size.x);
+	}
+
+	const unsigned int shelfWidth{ std::max(widest, static_cast<unsigned int>(std::ceil(std::sqrt(static_cast<double>(area))))) };
+	std::vector<sf::IntRect> rects(m_groups.size());
+	sf::Vector2u atlasSize{ 0, 0 };
+	sf::Vector2u cursor{ 0, 0 };
+	unsigned int shelfHeight{ 0 };
+
+	for (const size_t i : order)
+	{
+		const sf::Vector2u size{ m_groups[i].size };
+		if (cursor.x != 0 && cursor.x + size.x > shelfWidth)
+		{	// Next shelf.
+			cursor = sf::Vector2u{ 0, cursor.y + shelfHeight + padding };
+			shelfHeight = 0;
+		}
+
+		rects[i] = sf::IntRect{ static_cast<sf::Vector2i>(cursor), static_cast<sf::Vector2i>(size) };
+		atlasSize.x = std::max(atlasSize.x, cursor.x + size.x);
+		cursor.x += size.x + padding;
+		shelfHeight = std::max(shelfHeight, size.y);
+	}
+
+	atlasSize.y = cursor.y + shelfHeight;
+	if (atlasSize.x > sf::Texture::getMaximumSize() || atlasSize.y > sf::Texture::getMaximumSize()) [[unlikely]]
+		throw LoadingGraphicalResourceFailure{ "The atlas " + textureName + " is larger than the maximum size of a texture\n" };
+
+	// A single pass, into a single render texture.
+	auto renderTexture{ RenderTargetPool::acquire(atlasSize) };
+	if (!renderTexture) [[unlikely]]
+		throw LoadingGraphicalResourceFailure{ "The render texture of the atlas " + textureName + " could not be created\n" };
+
+	renderTexture->clear(sf::Color::Transparent);
+	for (size_t i{ 0 }; i < m_groups.size(); ++i)
+	{
+		sf::RenderStates states{};
+		states.transform.translate(static_cast<sf::Vector2f>(rects[i].position));
+
+		for (const auto& drawable : m_groups[i].drawables)
+			renderTexture->draw(*drawable, states);
+	}
+	renderTexture->display();
+
+	sf::Texture atlas{ renderTexture->getTexture() };
+	atlas.setSmooth(true);
+	SpriteWrapper::createTexture(std::move(textureName), std::move(atlas), SpriteWrapper::Reserved::No);
+
+	m_groups.clear();
+	return rects;
+}
+
+} // gui namespace
@@ -0,0 +1,131 @@
+/*******************************************************************
+ * \file   TextureBatch.hpp, TextureBatch.cpp
+ * \brief  Declare a batch generating many textures from drawables into a single atlas, in one pass.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ *********************************************************************/
+
+#ifndef TEXTUREBATCH_HPP
+#define TEXTUREBATCH_HPP
+
+#include "BasicInterface.hpp"
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace gui
+{
+
+/**
+ * \brief Draws many groups of drawables into regions of one texture, an atlas, in a single pass.
+ *
+ * Each call to `createTextureFromDrawables` draws into a render texture, then uploads a texture of
+ * its own. A batch collects the groups first, packs them into a single atlas, draws them all into one
+ * render texture and copies it once: any number of textures cost one render texture and one texture.
+ *
+ * Each group is drawn as `createTextureFromDrawables` would draw it, at the rect `build` returns for
+ * it. The sprites then use the atlas with that rect.
+ *
+ * \see `createTextureFromDrawables`, `RenderTargetPool`, `SpriteWrapper::createTexture`.
+ *
+ * \code
+ * gui::TextureBatch batch{};
+ * const size_t button{ batch.add(buttonShape, buttonBorder) }; // Copied: the shapes are left untouched.
+ * const size_t icon{ batch.add(iconShape) };
+ * const auto rects{ batch.build("menuAtlas") };
+ *
+ * myInterface.addSprite("menuAtlas", { 500, 500 }, { 1.f, 1.f }, rects[button]);
+ * myInterface.addSprite("menuAtlas", { 500, 700 }, { 1.f, 1.f }, rects[icon]);
+ * \endcode
+ */
+class TextureBatch
+{
+public:
+
+	TextureBatch() noexcept = default;
+	TextureBatch(const TextureBatch&) noexcept = delete;
+	TextureBatch(TextureBatch&&) noexcept = default;
+	TextureBatch& operator=(const TextureBatch&) noexcept = delete;
+	TextureBatch& operator=(TextureBatch&&) noexcept = default;
+	~TextureBatch() noexcept = default;
+
+
+	/**
+	 * \brief Adds a group of drawables, drawn together as one texture of the atlas.
+	 * \complexity O(N), where N is the number of drawables passed as arguments.
+	 *
+	 * \param[in] drawables: The drawables of the group, in the order they are drawn. They are copied:
+	 *						 unlike `createTextureFromDrawables`, they are not modified.
+	 *
+	 * \return The index of the group, that is the index of its rect in what `build` returns.
+	 */
+	template<Drawable... Ts>
+	size_t add(const Ts&... drawables)
+	{
+		return addCopies(std::make_unique<std::remove_cvref_t<Ts>>(drawables)...);
+	}
+
+	/**
+	 * \brief Draws every group into an atlas, and creates it as a shared texture.
+	 * \complexity O(G log G + N) where G is the number of groups, and N the number of drawables.
+	 *
+	 * \param[in] textureName The name of the atlas, for `SpriteWrapper`.
+	 * \param[in] padding The transparent pixels between two groups, so that smoothing does not bleed.
+	 *
+	 * \return The rect of each group within the atlas, by index. The batch is emptied.
+	 *		   Empty if no group was added: no atlas is created then.
+	 *
+	 * \pre No texture should be named `textureName`.
+	 * \post The atlas is created.
+	 * \throw std::invalid_argument strong exception guarantee: nothing happens.
+	 *
+	 * \pre The groups should fit into a texture: see `sf::Texture::getMaximumSize`.
+	 * \post The atlas is created.
+	 * \throw LoadingGraphicalResourceFailure strong exception guarantee: nothing happens.
+	 */
+	[[nodiscard]] std::vector<sf::IntRect> build(std::string textureName, unsigned int padding = 1);
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \return The number of groups added since the last build.
+	 */
+	[[nodiscard]] inline size_t size() const noexcept
+	{
+		return m_groups.size();
+	}
+
+private:
+
+	/// Drawables drawn together, as one texture of the atlas.
+	struct Group
+	{
+		std::vector<std::unique_ptr<sf::Drawable>> drawables; // Moved so that the group begins at (0;0).
+		sf::Vector2u size;
+	};
+
+	/// Adds a group from the copies of its drawables.
+	template<typename... Ts>
+	size_t addCopies(std::unique_ptr<Ts>... copies)
+	{
+		Group group{ std::vector<std::unique_ptr<sf::Drawable>>{}, moveDrawablesToOrigin(*copies...) };
+		group.drawables.reserve(sizeof...(Ts));
+		(group.drawables.push_back(std::move(copies)), ...);
+
+		m_groups.push_back(std::move(group));
+		return m_groups.size() - 1;
+	}
+
+
+	/// The groups added since the last build, by index.
+	std::vector<Group> m_groups;
+};
+
+} // gui namespace
+
+#endif //TEXTUREBATCH_HPP
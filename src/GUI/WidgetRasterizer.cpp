@@ -0,0 +1,118 @@
+#include "WidgetRasterizer.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace gui
+{
+
+namespace
+{
+/// Returns a pixel as stored by `sf::Image`: 4 bytes in the RGBA order, whatever the endianness.
+std::uint32_t pack(sf::Color color) noexcept
+{
+	const std::array<std::uint8_t, 4> bytes{ color.r, color.g, color.b, color.a };
+	std::uint32_t pixel{};
+	std::memcpy(&pixel, bytes.data(), sizeof(pixel));
+	return pixel;
+}
+
+sf::Color unpack(std::uint32_t pixel) noexcept
+{
+	std::array<std::uint8_t, 4> bytes{};
+	std::memcpy(bytes.data(), &pixel, sizeof(pixel));
+	return sf::Color{ bytes[0], bytes[1], bytes[2], bytes[3] };
+}
+
+/// Returns the color between two others, `coverage` being the part of the second one.
+sf::Color mix(sf::Color first, sf::Color second, float coverage) noexcept
+{
+	const auto channel{ [coverage](std::uint8_t lhs, std::uint8_t rhs) { return static_cast<std::uint8_t>(std::lround(lhs + (rhs - lhs) * coverage)); } };
+	return sf::Color{ channel(first.r, second.r), channel(first.g, second.g), channel(first.b, second.b), channel(first.a, second.a) };
+}
+}
+
+sf::Image WidgetRasterizer::rasterize(const Style& style)
+{
+	const size_t width{ style.size.x };
+	const size_t height{ style.size.y };
+	if (width == 0 || height == 0) [[unlikely]]
+		return sf::Image{};
+
+	// The outline everywhere, then the fill inside: every row of the fill is the same span, filled at once.
+	const std::uint32_t outline{ pack(style.outlineColor) };
+	const std::uint32_t fill{ pack(style.fillColor) };
+	const size_t thickness{ std::min<size_t>(style.outlineThickness, std::min(width, height) / 2) };
+	std::vector<std::uint32_t> pixels(width * height, outline);
+
+	for (size_t y{ thickness }; y + thickness < height && 2 * thickness < width; ++y)
+		std::fill_n(pixels.begin() + static_cast<std::ptrdiff_t>(y * width + thickness), width - 2 * thickness, fill);
+
+	if (style.checkMark && thickness != 0)
+	{	// The pixels such as |x - y| < thickness, or |width - x - y| < thickness: a span per diagonal and row.
+		const auto diagonal{ [&](size_t y, std::ptrdiff_t center)
+		{
+			const std::ptrdiff_t first{ std::max<std::ptrdiff_t>(center - static_cast<std::ptrdiff_t>(thickness) + 1, 0) };
+			const std::ptrdiff_t last{ std::min<std::ptrdiff_t>(center + static_cast<std::ptrdiff_t>(thickness) - 1, static_cast<std::ptrdiff_t>(width) - 1) };
+			if (first <= last)
+				std::fill_n(pixels.begin() + static_cast<std::ptrdiff_t>(y * width) + first, last - first + 1, outline);
+		} };
+
+		for (size_t y{ 0 }; y < height; ++y)
+		{
+			diagonal(y, static_cast<std::ptrdiff_t>(y));
+			diagonal(y, static_cast<std::ptrdiff_t>(width) - static_cast<std::ptrdiff_t>(y));
+		}
+	}
+
+	// The corners: only their squares are computed pixel by pixel, the same way for the four of them.
+	const size_t radius{ std::min<size_t>(style.cornerRadius, std::min(width, height) / 2) };
+	const float outerRadius{ static_cast<float>(radius) };
+	const float innerRadius{ outerRadius - static_cast<float>(thickness) };
+
+	for (size_t i{ 0 }; i < radius; ++i)
+	{
+		for (size_t j{ 0 }; j < radius; ++j)
+		{	// From the center of the pixel to the center of the corner arc, antialiased over a pixel.
+			const float distance{ std::hypot(outerRadius - (static_cast<float>(j) + 0.5f), outerRadius - (static_cast<float>(i) + 0.5f)) };
+			const float coverage{ std::clamp(outerRadius - distance + 0.5f, 0.f, 1.f) };
+			const float outlineCoverage{ (thickness == 0) ? 0.f : (innerRadius <= 0.f) ? 1.f : std::clamp(distance - innerRadius + 0.5f, 0.f, 1.f) };
+
+			for (const size_t y : { i, height - 1 - i })
+			{
+				for (const size_t x : { j, width - 1 - j })
+				{
+					sf::Color color{ mix(unpack(pixels[y * width + x]), style.outlineColor, outlineCoverage) };
+					color.a = static_cast<std::uint8_t>(std::lround(color.a * coverage));
+					pixels[y * width + x] = pack(color);
+				}
+			}
+		}
+	}
+
+	return sf::Image{ style.size, reinterpret_cast<const std::uint8_t*>(pixels.data()) };
+}
+
+std::string WidgetRasterizer::textureOf(const Style& style)
+{
+	std::ostringstream name{};
+	name << "__widget_" << style.size.x << 'x' << style.size.y << '_' << style.fillColor.toInteger() << '_' << style.outlineColor.toInteger()
+		 << '_' << style.outlineThickness << '_' << style.cornerRadius << '_' << style.checkMark;
+
+	if (SpriteWrapper::getTexture(name.str()) == nullptr)
+	{	// Uploaded once: no render pass, no download.
+		sf::Texture texture{};
+		if (!texture.loadFromImage(rasterize(style))) [[unlikely]]
+			texture = sf::Texture{};
+
+		texture.setSmooth(true);
+		SpriteWrapper::createTexture(name.str(), std::move(texture), SpriteWrapper::Reserved::No);
+	}
+
+	return name.str();
+}
+
+} // gui namespace
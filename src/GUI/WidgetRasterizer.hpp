@@ -0,0 +1,90 @@
+/*******************************************************************
+ * \file   WidgetRasterizer.hpp, WidgetRasterizer.cpp
+ * \brief  Declare a rasterizer drawing the textures of the widgets on the CPU, and caching them.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * \note These files depend on the SFML library.
+ *********************************************************************/
+
+#ifndef WIDGETRASTERIZER_HPP
+#define WIDGETRASTERIZER_HPP
+
+#include "GraphicalResources.hpp"
+#include <string>
+
+namespace gui
+{
+
+/**
+ * \brief Draws the textures of the widgets (boxes, sliders, check marks) straight into pixel buffers.
+ *
+ * Drawing a shape with SFML to get a texture needs a render texture: a render pass, and a download
+ * to edit the pixels afterwards. The widgets only need rectangles, possibly outlined, rounded and
+ * checked, so they are rasterized on the CPU, row by row, then uploaded once.
+ *
+ * The textures are cached in `SpriteWrapper`, under a name made of their style: the same style is
+ * only rasterized once, no matter how many widgets use it.
+ *
+ * \note This class is non-instantiable and only contains static methods.
+ *
+ * \see `SpriteWrapper`, `AdvancedInterface`.
+ *
+ * \code
+ * const gui::WidgetRasterizer::Style style{ .size{ 200, 60 }, .outlineThickness = 3, .cornerRadius = 12 };
+ * myInterface.addSprite(gui::WidgetRasterizer::textureOf(style), { 500, 500 });
+ * \endcode
+ */
+class WidgetRasterizer
+{
+public:
+
+	/// What a widget texture looks like.
+	struct Style
+	{
+		sf::Vector2u size;
+		sf::Color fillColor{ 20, 20, 20 };
+		sf::Color outlineColor{ 80, 80, 80 };
+		unsigned int outlineThickness{ 0 }; // Inside the size, as a negative thickness for SFML shapes.
+		unsigned int cornerRadius{ 0 }; // Of the outer edge. The corners are antialiased.
+		bool checkMark{ false }; // A cross along the diagonals, of the outline color and thickness.
+	};
+
+
+	WidgetRasterizer() noexcept = delete;
+	WidgetRasterizer(const WidgetRasterizer&) noexcept = delete;
+	WidgetRasterizer(WidgetRasterizer&&) noexcept = delete;
+	WidgetRasterizer& operator=(const WidgetRasterizer&) noexcept = delete;
+	WidgetRasterizer& operator=(WidgetRasterizer&&) noexcept = delete;
+	~WidgetRasterizer() noexcept = delete;
+
+
+	/**
+	 * \brief Rasterizes a widget.
+	 * \complexity O(W * H) where W and H are the size of the widget, filled a row at once, plus
+	 *			   O(R * R) per corner where R is the corner radius.
+	 *
+	 * \param[in] style What the widget looks like.
+	 *
+	 * \return The image, transparent outside the rounded corners.
+	 */
+	[[nodiscard]] static sf::Image rasterize(const Style& style);
+
+	/**
+	 * \brief Returns the name of the texture of a widget, rasterized and created if it is not cached yet.
+	 * \complexity O(1) if cached, otherwise the complexity of `rasterize`.
+	 *
+	 * \param[in] style What the widget looks like.
+	 *
+	 * \return The name of a shared texture of `SpriteWrapper`. It starts with an underscore, as
+	 *		   the names used internally.
+	 *
+	 * \note The texture is smooth, as those created from drawables.
+	 */
+	[[nodiscard]] static std::string textureOf(const Style& style);
+};
+
+} // gui namespace
+
+#endif //WIDGETRASTERIZER_HPP
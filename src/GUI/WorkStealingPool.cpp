@@ -0,0 +1,147 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+
+namespace gui
+{
+
+WorkStealingPool::WorkStealingPool(unsigned int threads) noexcept
+	: m_queues{}, m_job{ nullptr }, m_remaining{ 0 }, m_queued{ 0 }, m_sleepMutex{}, m_wakeUp{}, m_workers{}
+{
+	threads = (threads == 0) ? std::max(std::thread::hardware_concurrency(), 1u) : threads;
+
+	// Every queue before the first worker: the workers read the vector of queues, never modified afterwards.
+	try
+	{
+		m_queues.reserve(threads);
+		for (unsigned int i{ 0 }; i < threads; ++i)
+			m_queues.push_back(std::make_unique<Queue>());
+	}
+	catch (const std::exception&)
+	{}	// Only std::bad_alloc is expected: fewer threads are used.
+
+	try
+	{
+		m_workers.reserve(m_queues.size());
+		for (size_t i{ 1 }; i < m_queues.size(); ++i)
+			m_workers.emplace_back([this, i](std::stop_token stop) noexcept { workerLoop(stop, i); });
+	}
+	catch (const std::exception&)
+	{}	// Fewer threads are used: the queues without a worker stay empty.
+}
+
+WorkStealingPool::~WorkStealingPool() noexcept
+{
+	m_workers.clear(); // Stops and joins them, while the queues are still alive.
+}
+
+void WorkStealingPool::run(size_t count, void (*invoke)(void*, size_t) noexcept, void* function) noexcept
+{
+	const size_t threads{ getThreadCount() };
+	if (count <= 1 || threads <= 1)
+	{	// Nothing to share.
+		for (size_t i{ 0 }; i < count; ++i)
+			invoke(function, i);
+
+		return;
+	}
+
+	Job job{ invoke, function };
+	m_job.store(&job, std::memory_order_release);
+	m_remaining.store(count, std::memory_order_release);
+
+	{	// Under the lock: a worker checking whether to sleep sees the iterations coming.
+		std::lock_guard lock{ m_sleepMutex };
+		m_queued.fetch_add(count, std::memory_order_release);
+	}
+
+	// Contiguous blocks, one per thread: neighbouring iterations, e.g. the chunks of an interface,
+	// stay on the same thread unless stolen.
+	size_t queued{ 0 };
+	try
+	{
+		for (; queued < count; ++queued)
+		{
+			Queue& queue{ *m_queues[queued * threads / count] };
+			std::lock_guard lock{ queue.mutex };
+			queue.iterations.push_back(queued);
+		}
+	}
+	catch (const std::exception&)
+	{	// Only std::bad_alloc is expected: the calling thread runs the iterations not queued.
+		m_queued.fetch_sub(count - queued, std::memory_order_acq_rel);
+		for (size_t i{ queued }; i < count; ++i)
+		{
+			invoke(function, i);
+			m_remaining.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	}
+
+	m_wakeUp.notify_all();
+	work(0);
+
+	// The last iterations may still run on the workers.
+	for (size_t remaining{ m_remaining.load(std::memory_order_acquire) }; remaining != 0; remaining = m_remaining.load(std::memory_order_acquire))
+		m_remaining.wait(remaining, std::memory_order_acquire);
+
+	m_job.store(nullptr, std::memory_order_release);
+}
+
+bool WorkStealingPool::take(size_t thread, size_t& iteration) noexcept
+{
+	{	// Its own queue first, from the back: the iterations it will not be able to share.
+		Queue& queue{ *m_queues[thread] };
+		std::lock_guard lock{ queue.mutex };
+		if (!queue.iterations.empty())
+		{
+			iteration = queue.iterations.back();
+			queue.iterations.pop_back();
+			m_queued.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	// Then the others', from the front: the farthest from what their owner is working on.
+	for (size_t offset{ 1 }; offset < m_queues.size(); ++offset)
+	{
+		Queue& queue{ *m_queues[(thread + offset) % m_queues.size()] };
+		std::lock_guard lock{ queue.mutex };
+		if (!queue.iterations.empty())
+		{
+			iteration = queue.iterations.front();
+			queue.iterations.pop_front();
+			m_queued.fetch_sub(1, std::memory_order_acq_rel);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkStealingPool::work(size_t thread) noexcept
+{
+	size_t iteration{};
+	while (take(thread, iteration))
+	{
+		const Job* job{ m_job.load(std::memory_order_acquire) };
+		job->invoke(job->function, iteration);
+
+		if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			m_remaining.notify_all(); // The last one: the calling thread may be waiting.
+	}
+}
+
+void WorkStealingPool::workerLoop(std::stop_token stop, size_t thread) noexcept
+{
+	while (true)
+	{
+		{
+			std::unique_lock lock{ m_sleepMutex };
+			if (!m_wakeUp.wait(lock, stop, [this]() { return m_queued.load(std::memory_order_acquire) != 0; }))
+				return; // Stopped while sleeping.
+		}
+
+		work(thread);
+	}
+}
+
+} // gui namespace
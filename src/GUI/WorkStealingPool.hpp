@@ -0,0 +1,139 @@
+/*******************************************************************
+ * \file   WorkStealingPool.hpp, WorkStealingPool.cpp
+ * \brief  Declare a pool of threads sharing the iterations of a loop, each stealing from the others when idle.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef WORKSTEALINGPOOL_HPP
+#define WORKSTEALINGPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gui
+{
+
+/**
+ * \brief Runs the iterations of a loop on several threads, the calling one included.
+ *
+ * Each thread has its own queue of iterations: it takes them from the back of its queue, then from
+ * the front of the others' once its own is empty. An interface with many more elements than the
+ * others is not left to a single thread while the others wait.
+ *
+ * \note The threads are created once, and sleep between the loops.
+ * \note Call `parallelFor` from one thread at a time, and not from an iteration.
+ *
+ * \see `BasicInterface::prepareFrame`.
+ *
+ * \code
+ * gui::WorkStealingPool pool{ 4 }; // The calling thread and 3 workers.
+ * pool.parallelFor(chunks.size(), [&](size_t i) noexcept { process(chunks[i]); });
+ * \endcode
+ */
+class WorkStealingPool
+{
+public:
+
+	/**
+	 * \brief Creates the worker threads.
+	 * \complexity O(T) where T is the number of threads.
+	 *
+	 * \param[in] threads The threads running the iterations, the calling one included. 0 for one per
+	 *					  core. If fewer threads can be created, fewer are used.
+	 */
+	explicit WorkStealingPool(unsigned int threads = 0) noexcept;
+
+	WorkStealingPool(const WorkStealingPool&) noexcept = delete;
+	WorkStealingPool(WorkStealingPool&&) noexcept = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) noexcept = delete;
+	WorkStealingPool& operator=(WorkStealingPool&&) noexcept = delete;
+
+	/// \complexity O(T) where T is the number of threads: joins them.
+	~WorkStealingPool() noexcept;
+
+
+	/**
+	 * \brief Calls a function for each index from 0 to count, on every thread, and waits for all of them.
+	 * \complexity O(N / T) where N is the number of iterations and T the number of threads, if they
+	 *			   cost the same.
+	 *
+	 * \param[in] count The number of iterations.
+	 * \param[in] iteration The function called with each index, in any order, from any thread. It
+	 *						must not throw: nothing catches its exceptions.
+	 *
+	 * \note If there is not enough memory to queue the iterations, they all run on the calling thread.
+	 */
+	template<typename F> requires std::is_nothrow_invocable_v<F&, size_t>
+	inline void parallelFor(size_t count, F&& iteration) noexcept
+	{
+		run(count, [](void* function, size_t i) noexcept { (*static_cast<std::remove_reference_t<F>*>(function))(i); }, const_cast<void*>(static_cast<const void*>(&iteration)));
+	}
+
+	/**
+	 * \complexity O(1).
+	 *
+	 * \return The number of threads running the iterations, the calling one included.
+	 */
+	[[nodiscard]] inline unsigned int getThreadCount() const noexcept
+	{
+		return static_cast<unsigned int>(m_workers.size() + 1);
+	}
+
+private:
+
+	/// A loop: the function called for each of its iterations.
+	struct Job
+	{
+		void (*invoke)(void*, size_t) noexcept;
+		void* function;
+	};
+
+	/// The iterations queued for a thread, taken by it from the back and by the others from the front.
+	struct Queue
+	{
+		std::mutex mutex;
+		std::deque<size_t> iterations;
+	};
+
+
+	/// Queues the iterations of a loop, runs them with the workers and waits for the last one.
+	void run(size_t count, void (*invoke)(void*, size_t) noexcept, void* function) noexcept;
+
+	/// Takes an iteration from the queue of a thread, or steals one from another. False if all are empty.
+	[[nodiscard]] bool take(size_t thread, size_t& iteration) noexcept;
+
+	/// Runs iterations until none is left in any queue.
+	void work(size_t thread) noexcept;
+
+	/// What each worker runs until the pool is destroyed.
+	void workerLoop(std::stop_token stop, size_t thread) noexcept;
+
+
+	/// A queue per thread, the calling one first.
+	std::vector<std::unique_ptr<Queue>> m_queues;
+	/// The loop running, nullptr between two loops.
+	std::atomic<Job*> m_job;
+	/// The iterations of the loop not finished yet. A member: the last worker notifies it after the loop returns.
+	std::atomic<size_t> m_remaining;
+	/// The iterations queued and not taken yet, guarded by m_sleepMutex when increased.
+	std::atomic<size_t> m_queued;
+
+	std::mutex m_sleepMutex;
+	std::condition_variable_any m_wakeUp;
+
+	/// Last member: the workers are stopped and joined first, while the queues are still alive.
+	std::vector<std::jthread> m_workers;
+};
+
+} // gui namespace
+
+#endif //WORKSTEALINGPOOL_HPP
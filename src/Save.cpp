@@ -2,17 +2,28 @@
 #include <filesystem>
 #include <vector> 
 #include <string>
+#include <string_view>
 #include <optional>
 #include <memory>
 #include <sstream>
 #include <ios>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 #include "Save.hpp"
+#include "Save/BinaryUtils.hpp"
+#include "Save/Compression.hpp"
+#include "Save/FileSync.hpp"
+#include "Save/IoBackend.hpp"
+#include "Save/MappedFile.hpp"
+#include "Save/RecordStream.hpp"
+#include "Save/SaveGenerations.hpp"
 #include "Exceptions.hpp"
 
 using namespace SafeSaves;
 
-std::string const Save::savesPath{ "../saves/" };
-std::string const Save::tokensOfConfirmation{ "/%)'{]\\This file has been succesfully saved}\"#'[]?(" };
+std::string const SaveStore::tokensOfConfirmation{ "/%)'{]\\This file has been succesfully saved}\"#'[]?(" };
+StreamBackend SaveStore::defaultBackend{};
 
 
 ReadingStreamRAIIWrapper::ReadingStreamRAIIWrapper(std::string const& path, std::ios::openmode mode)
@@ -78,13 +89,26 @@ void WritingStreamRAIIWrapper::create(std::string const& path, std::ios::openmod
 }
 
 
-std::optional<std::string> Save::reading(std::string const& fileName, std::vector<std::string>& valuesToLoad, bool decrypt) noexcept
+SaveStore::SaveStore(std::string root, std::string key, IoBackend* backend)
+	: m_root{ std::move(root) }, m_validatedFiles{}, m_key{ std::move(key) }, m_backend{ (backend != nullptr) ? backend : &defaultBackend }, m_generationCapacity{ 0 }, m_generationsMutex{}
+{
+	if (m_key.empty()) [[unlikely]]
+		throw std::invalid_argument{ "The key of a save store must not be empty: " + m_root.path() };
+}
+
+SaveStore& Save::store() noexcept
+{
+	static SaveStore defaultStore{ "../saves/" };
+	return defaultStore;
+}
+
+
+std::optional<std::string> SaveStore::reading(std::string const& fileName, std::vector<std::string>& valuesToLoad, bool decrypt) noexcept
 {
-	std::string path{ savesPath + fileName };
 	std::ostringstream errorMessage{};
 
 	// Checks files, clean the folder, and open a stream.
-	ReadingStreamRAIIWrapper fileWrapped{ openReadingStream(path, errorMessage) };
+	ReadingStreamRAIIWrapper fileWrapped{ openReadingStream(fileName, errorMessage) };
 	if (!fileWrapped.stream().has_value()) [[unlikely]]
 		return std::optional<std::string>{ errorMessage.str() };
 
@@ -98,10 +122,10 @@ std::optional<std::string> Save::reading(std::string const& fileName, std::vecto
 			std::string temp{};
 			std::getline(*savingStream, temp);
 
-			toLoad = ((decrypt) ? encryptDecrypt(temp) : temp);
+			toLoad = ((decrypt) ? encryptDecrypt(temp, m_key) : temp);
 			
 			if (savingStream->fail()) [[unlikely]]
-				throw FileFailureWhileInUse{ "Error reading from the file: " + path};
+				throw FileFailureWhileInUse{ "Error reading from the file: " + m_root.pathOf(fileName) };
 		}
 	}
 	catch (FileFailureWhileInUse const& error)
@@ -113,78 +137,374 @@ std::optional<std::string> Save::reading(std::string const& fileName, std::vecto
 	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
 }
 
-std::optional<std::string> Save::writing(std::string const& fileName, std::vector<std::string> const& valuesToSave, bool encrypt) noexcept
+std::optional<std::string> SaveStore::readingMapped(std::string const& fileName, MappedRecords& records, bool decrypt) noexcept
+{
+	std::ostringstream errorMessage{};
+
+	records.m_records.clear();
+	records.m_arena.clear();
+
+	try
+	{
+		cleanUpFiles(fileName);
+		records.m_file = MappedFile{ m_root, fileName };
+
+		// cleanUpFiles ensured the tokens are at the end of the file.
+		std::string_view content{ records.m_file.view() };
+		content.remove_suffix(tokensOfConfirmation.size());
+
+		if (decrypt)
+		{	// One allocation for the whole file, then the lines are decrypted where they are.
+			records.m_arena.assign(content);
+			content = records.m_arena;
+		}
+
+		records.m_records.reserve(static_cast<size_t>(std::count(content.begin(), content.end(), '\n')));
+
+		size_t lineBegin{ 0 };
+		while (lineBegin < content.size())
+		{
+			size_t lineEnd{ content.find('\n', lineBegin) };
+			if (lineEnd == std::string_view::npos)
+				lineEnd = content.size();
+
+			if (decrypt) // Each line is encrypted on its own: the key starts over at each line.
+				cipher(records.m_arena.data() + lineBegin, lineEnd - lineBegin);
+
+			records.m_records.push_back(content.substr(lineBegin, lineEnd - lineBegin));
+			lineBegin = lineEnd + 1;
+		}
+	}
+	catch (FileFailureWhileOpening const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Fatal error: impossible to read the values" << "\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	if (!errorMessage.str().empty()) [[unlikely]]
+	{	// Do not leave views toward a partially loaded file.
+		records.m_records.clear();
+		records.m_arena.clear();
+		records.m_file = MappedFile{};
+	}
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> SaveStore::streaming(std::string const& fileName, RecordStream& records, bool decrypt) noexcept
+{
+	std::ostringstream errorMessage{};
+
+	records.close();
+	records.m_store = nullptr;
+	records.m_begin = records.m_end = records.m_offset = records.m_contentSize = records.m_recordsRead = 0;
+	records.m_started = false;
+	records.m_error.reset();
+
+	try
+	{
+		cleanUpFiles(fileName);
+		records.m_file = m_backend->open(m_root, fileName);
+
+		// cleanUpFiles ensured the tokens are at the end of the file.
+		records.m_contentSize = records.m_file->size() - tokensOfConfirmation.size();
+		records.m_buffer = std::make_unique_for_overwrite<char[]>(records.m_bufferSize); // Read into before being read.
+		records.m_store = (decrypt) ? this : nullptr;
+	}
+	catch (FileFailureWhileOpening const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Fatal error: impossible to read the values" << "\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	if (!errorMessage.str().empty()) [[unlikely]]
+		records.close();
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> SaveStore::writing(std::string const& fileName, std::vector<std::string> const& valuesToSave, bool encrypt, bool sync) noexcept
 {
-	std::string path{ savesPath + fileName };
 	std::ostringstream errorMessage{}; 
 
+	// Checks files, clean the folder, and open the tmp file.
+	std::unique_ptr<IoFile> file{ openWritingFile(fileName, errorMessage) };
+	if (file == nullptr) [[unlikely]]
+		return std::optional<std::string>{ errorMessage.str() };
+
+	try
+	{	// Through a single buffer: one write per chunk, not per line.
+		std::string buffer{};
+		buffer.reserve(writeBufferSize);
+
+		for (auto const& toSave : valuesToSave)
+		{
+			size_t const lineBegin{ buffer.size() };
+			buffer.append(toSave);
+
+			if (encrypt)
+				cipher(buffer.data() + lineBegin, toSave.size());
+
+			buffer.push_back('\n');
+
+			if (buffer.size() >= writeBufferSize)
+			{
+				writeWhole(*file, buffer, fileName);
+				buffer.clear();
+			}
+		}
+
+		// Last tokens: confirm that every lines before has been successfully saved.
+		buffer.append(tokensOfConfirmation);
+		writeWhole(*file, buffer, fileName);
+
+		if (sync)
+			file->sync(); // Before the rename: the new file must not replace the previous one while only in the cache.
+		file->close();
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the file is corrupted and further saves are lost\n\n";
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected: the tokens are not written, so the previous content is kept.
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	file.reset(); // To rename the tmp file, it must be closed.
+	finishWriting(fileName, errorMessage, sync);
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> SaveStore::readingBlob(std::string const& fileName, std::string& blobToLoad, bool decrypt, bool decompress) noexcept
+{
+	std::ostringstream errorMessage{};
+
 	// Checks files, clean the folder, and open a stream.
-	WritingStreamRAIIWrapper fileWrapped{ openWritingStream(path, errorMessage) };
+	ReadingStreamRAIIWrapper fileWrapped{ openReadingStream(fileName, errorMessage, std::ios::in | std::ios::binary) };
 	if (!fileWrapped.stream().has_value()) [[unlikely]]
 		return std::optional<std::string>{ errorMessage.str() };
 
-	std::ofstream* savingStream{ fileWrapped.stream().value() };
+	std::ifstream* savingStream{ fileWrapped.stream().value() };
 
 	try
 	{
-		for (auto const& toSave : valuesToSave)
+		savingStream->seekg(0, std::ios::end);
+		std::streamoff const blobSize{ static_cast<std::streamoff>(savingStream->tellg()) - static_cast<std::streamoff>(tokensOfConfirmation.size()) };
+		savingStream->seekg(0, std::ios::beg);
+
+		if (blobSize < 0 || savingStream->fail()) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error reading from the file: " + m_root.pathOf(fileName) };
+
+		std::string temp{};
+
+		if (decompress)
+		{	// Chunk by chunk: only one compressed chunk is held in memory at a time.
+			std::string chunk{};
+			chunk.reserve(Compression::maximumBlockSize(Compression::chunkSize));
+			std::streamoff remaining{ blobSize };
+
+			while (true)
+			{
+				char header[Compression::chunkHeaderSize]{};
+				savingStream->read(header, Compression::chunkHeaderSize);
+				remaining -= Compression::chunkHeaderSize;
+
+				size_t const rawSize{ readInteger<uint32_t>(std::string_view{ header, Compression::chunkHeaderSize }, 0) };
+				uint32_t const storedField{ readInteger<uint32_t>(std::string_view{ header, Compression::chunkHeaderSize }, 4) };
+				size_t const storedSize{ storedField & ~Compression::storedFlag };
+				bool const isStored{ (storedField & Compression::storedFlag) != 0 };
+
+				if (savingStream->fail() || remaining < 0 || rawSize > Compression::chunkSize || static_cast<std::streamoff>(storedSize) > remaining
+				||  storedSize > Compression::maximumBlockSize(rawSize) || (isStored && storedSize != rawSize)) [[unlikely]]
+					throw FileFailureWhileInUse{ "The compressed content is corrupted: " + m_root.pathOf(fileName) };
+
+				if (rawSize == 0)
+				{
+					if (remaining != 0) [[unlikely]]
+						throw FileFailureWhileInUse{ "The compressed content is corrupted: " + m_root.pathOf(fileName) };
+					break;
+				}
+
+				chunk.resize(storedSize);
+				savingStream->read(chunk.data(), static_cast<std::streamsize>(storedSize));
+				remaining -= static_cast<std::streamoff>(storedSize);
+
+				if (savingStream->fail()) [[unlikely]]
+					throw FileFailureWhileInUse{ "Error reading from the file: " + m_root.pathOf(fileName) };
+
+				if (decrypt)
+					cipher(chunk.data(), chunk.size());
+
+				size_t const outputOffset{ temp.size() };
+				temp.resize(outputOffset + rawSize);
+
+				if (isStored)
+					std::copy(chunk.begin(), chunk.end(), temp.begin() + outputOffset);
+				else if (!Compression::decompressBlock(chunk, temp.data() + outputOffset, rawSize)) [[unlikely]]
+					throw FileFailureWhileInUse{ "The compressed content is corrupted: " + m_root.pathOf(fileName) };
+			}
+		}
+		else
 		{
-			*savingStream << ((encrypt) ? encryptDecrypt(toSave) : toSave) << '\n';
+			temp.resize(static_cast<size_t>(blobSize));
+			savingStream->read(temp.data(), blobSize);
 
 			if (savingStream->fail()) [[unlikely]]
-				throw FileFailureWhileInUse{ "Error writing into the file: " + path };
+				throw FileFailureWhileInUse{ "Error reading from the file: " + m_root.pathOf(fileName) };
+
+			if (decrypt)
+				cipher(temp.data(), temp.size());
 		}
 
-		// Last tokens: confirm that every lines before has been successfully saved.
-		*savingStream << tokensOfConfirmation; 
+		blobToLoad = std::move(temp);
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the file is corrupted abd further saves are unavailable\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> SaveStore::writingBlob(std::string const& fileName, std::string_view blobToSave, bool encrypt, bool compress, bool sync) noexcept
+{
+	std::ostringstream errorMessage{};
+
+	// Checks files, clean the folder, and open the tmp file.
+	std::unique_ptr<IoFile> file{ openWritingFile(fileName, errorMessage) };
+	if (file == nullptr) [[unlikely]]
+		return std::optional<std::string>{ errorMessage.str() };
+
+	try
+	{
+		encodingBlob(blobToSave, encrypt, compress, [&file, &fileName](std::string const& chunk)
+		{
+			writeWhole(*file, chunk, fileName);
+		});
+
+		// Last tokens: confirm that the whole blob has been successfully saved.
+		writeWhole(*file, tokensOfConfirmation, fileName);
+
+		if (sync)
+			file->sync(); // Before the rename, as in writing().
+		file->close();
 	}
 	catch (FileFailureWhileInUse const& error)
 	{
 		errorMessage << error.what() << '\n';
 		errorMessage << "Critical error: the file is corrupted and further saves are lost\n\n";
 	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected: the tokens are not written, so the previous content is kept.
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
 
-	savingStream->close(); // To clean up the files, no writing stream can be openend to these same files.
-	cleanUpFiles(path); // Won't throw any execptions as it sure that the tmp file is valid.
+	file.reset(); // To rename the tmp file, it must be closed.
+	finishWriting(fileName, errorMessage, sync);
 	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
 }
 
-std::optional<std::string> SafeSaves::Save::createFile(std::string const& fileName) noexcept
+std::optional<std::string> SaveStore::createFile(std::string const& fileName) noexcept
 {
-	std::string path{ savesPath + fileName };
 	std::ostringstream errorMessage{};
 
 	try
 	{
-		WritingStreamRAIIWrapper fileWrapped{ path, std::ios::out | std::ios::trunc, true };
+		// Never truncated in place: its content may be shared with a generation.
+		m_backend->remove(m_root, fileName);
+		m_validatedFiles.forget(fileName);
 
-		// We don't need to check the validity of the pointer using has_value()
-		// The constructor would have thrown an exception if badly instantiated
-		std::ofstream* savingStream{ fileWrapped.stream().value() };
-		*savingStream << tokensOfConfirmation;
-		 
-		if (savingStream->fail()) [[unlikely]]
-			throw FileFailureWhileInUse{ "Error writing confirmation tokens into the file: " + path };
+		std::unique_ptr<IoFile> file{ m_backend->create(m_root, fileName) };
+		writeWhole(*file, tokensOfConfirmation, fileName);
+		file->close();
 	}
 	catch (FileFailure const& error)
 	{
 		errorMessage << error.what() << '\n';
 		errorMessage << "error: impossible to create file" << "\n\n";
 
-		std::filesystem::remove(path);
+		m_backend->remove(m_root, fileName);
 	}
 
 	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
 }
 
-ReadingStreamRAIIWrapper Save::openReadingStream(std::string const& path, std::ostringstream& errorMessage) noexcept
+void SaveStore::encodingBlob(std::string_view blobToSave, bool encrypt, bool compress, std::function<void(std::string const&)> const& output) const
+{
+	// Chunk by chunk, through a single buffer: the blob is never copied as a whole.
+	// Uncompressed, the key carries on from one chunk to the next since the blob is decrypted in one go.
+	// Compressed, each chunk is encrypted on its own, as it is decrypted before being decompressed.
+	std::string chunk{};
+	chunk.reserve(Compression::chunkHeaderSize + Compression::maximumBlockSize(Compression::chunkSize));
+
+	for (size_t offset{ 0 }; offset < blobToSave.size() || compress; offset += Compression::chunkSize)
+	{
+		std::string_view const raw{ blobToSave.substr(std::min(offset, blobToSave.size()), Compression::chunkSize) };
+		chunk.clear();
+
+		if (compress)
+		{
+			chunk.append(Compression::chunkHeaderSize, '\0'); // Written once the chunk is compressed.
+			if (!raw.empty())
+				Compression::compressBlock(raw, chunk);
+
+			bool const isStored{ chunk.size() - Compression::chunkHeaderSize >= raw.size() };
+			if (isStored)
+			{	// Compressing made it larger.
+				chunk.resize(Compression::chunkHeaderSize);
+				chunk.append(raw);
+			}
+
+			if (encrypt)
+				cipher(chunk.data() + Compression::chunkHeaderSize, chunk.size() - Compression::chunkHeaderSize);
+
+			std::string header{};
+			appendInteger<uint32_t>(header, static_cast<uint32_t>(raw.size()));
+			appendInteger<uint32_t>(header, static_cast<uint32_t>(chunk.size() - Compression::chunkHeaderSize) | ((isStored && !raw.empty()) ? Compression::storedFlag : 0));
+			chunk.replace(0, Compression::chunkHeaderSize, header);
+		}
+		else
+		{
+			chunk.append(raw);
+			if (encrypt)
+				cipher(chunk.data(), chunk.size(), offset);
+		}
+
+		output(chunk);
+
+		if (raw.empty())
+			break; // End of the frame.
+	}
+}
+
+ReadingStreamRAIIWrapper SaveStore::openReadingStream(std::string const& fileName, std::ostringstream& errorMessage, std::ios::openmode mode) noexcept
 {
 	ReadingStreamRAIIWrapper openStream{};
 
 	try
 	{
-		cleanUpFiles(path);
-		openStream.create(path);
+		cleanUpFiles(fileName);
+		openStream.create(m_root.pathOf(fileName), mode); // Streams only accept paths.
 	}
 	catch (FileFailureWhileOpening const& error)
 	{
@@ -200,15 +520,12 @@ ReadingStreamRAIIWrapper Save::openReadingStream(std::string const& path, std::o
 	return openStream;
 }
 
-WritingStreamRAIIWrapper Save::openWritingStream(std::string const& path, std::ostringstream& errorMessage) noexcept
+std::unique_ptr<IoFile> SaveStore::openWritingFile(std::string const& fileName, std::ostringstream& errorMessage) noexcept
 {
-	WritingStreamRAIIWrapper openStream{};
-
 	try
 	{
-		cleanUpFiles(path); 
-		std::filesystem::copy_file(path, path + ".tmp"); // We create a copy to have a valid file at any given moment.
-		openStream.create(path);
+		cleanUpFiles(fileName); // The perm file is valid, and is not modified until the tmp file is complete.
+		return m_backend->create(m_root, fileName + ".tmp"); // Replaces a tmp file left by a crash, if any.
 	}
 	catch (FileFailureWhileOpening const& error)
 	{
@@ -221,60 +538,114 @@ WritingStreamRAIIWrapper Save::openWritingStream(std::string const& path, std::o
 		errorMessage << "Error: gravity and effects unknown" << "\n\n";
 	}
 
-	return openStream;
+	return nullptr;
 }
 
-void Save::cleanUpFiles(std::string const& path)
+void SaveStore::finishWriting(std::string const& fileName, std::ostringstream& errorMessage, bool sync) noexcept
 {
-	ReadingStreamRAIIWrapper fileWrapped{};
+	std::optional<FileIdentity> const tmpIdentity{ m_validatedFiles.identify(m_root, fileName + ".tmp") };
+	if (!tmpIdentity.has_value() || !checkingContentValdity(fileName + ".tmp", tmpIdentity->size)) [[unlikely]]
+	{	// Incomplete: the perm file still holds the previous saves.
+		m_backend->remove(m_root, fileName + ".tmp");
+		m_validatedFiles.count(ValidatedFileCache::Operation::Remove);
+
+		if (errorMessage.str().empty())
+			errorMessage << "Error writing into the file: " << m_root.pathOf(fileName) << '\n' << "Critical error: the new saves are lost, the previous ones are kept\n\n";
+		return;
+	}
+
+	SaveGenerations::keep(*this, fileName); // The previous saves become the newest generation.
+	m_validatedFiles.forget(fileName);
 
 	try
-	{	// If at any point the perm file is found not valid, it falls into the catch block and the tmp is next to be loaded.
-		fileWrapped.create(path);
-		
-		if (!checkingContentValdity(fileWrapped.stream().value()))
-			throw FileFailureWhileOpening{ "Perm file is not valid" };
-
-		// No need to check for the tmp file as the perm file IS valid (would have fell otherwise).
-		std::filesystem::remove(path + ".tmp"); // Delete the tmp file in case it is still there.
-	}	
-	catch (std::exception const&)
-	{	// If the program falls in this catch, the permanent file is not valid.
-		if (!checkFileExistence(path + ".tmp") || !checkFileWritable(path + "tmp"))
-			throw FileFailureWhileOpening{ "No file avalailable to load the saves: " + path };
+	{	// Replacing the perm file in a single atomic step: there's always one file storing the information.
+		m_validatedFiles.count(ValidatedFileCache::Operation::Rename);
+		m_backend->rename(m_root, fileName + ".tmp", fileName);
+	}
+	catch (std::exception const& error)
+	{
+		m_backend->remove(m_root, fileName + ".tmp");
+		errorMessage << error.what() << '\n' << "Critical error: the new saves are lost, the previous ones are kept\n\n";
+		return;
+	}
 
-		// To remove the perm file, no stream can be openend to that same file.
-		if (fileWrapped.stream().has_value())
-			fileWrapped.stream().value()->close(); 
+	if (sync)
+	{	// The rename itself is an entry of the directory: without this, a power loss may bring the previous file back.
+		try
+		{
+			FileSync::syncDirectory(m_root.path());
+		}
+		catch (std::exception const& error)
+		{
+			errorMessage << error.what() << '\n' << "Critical error: the new saves may be lost on a power failure\n\n";
+		}
+	}
 
-		std::filesystem::remove(path); // Delete the perm file as it is not avalaible.
-		std::filesystem::copy_file(path + ".tmp", path); // Turning the tmp file into the perm file.
-		std::filesystem::remove(path + ".tmp"); // In two steps: so there's always at least one file storing the information.
-		
-		fileWrapped.create(path); // The tmp file has become the perm file.
+	m_validatedFiles.markValidated(fileName, tmpIdentity.value()); // Renaming keeps the inode, the size and the modification time.
+}
+
+void SaveStore::cleanUpFiles(std::string const& fileName)
+{
+	std::optional<FileIdentity> const identity{ m_validatedFiles.identify(m_root, fileName) };
 
-		// We don't need to check the validity of the pointer using has_value()
-		// The call to create() would have thrown an exception if badly instantiated
-		if (!checkingContentValdity(fileWrapped.stream().value())) 
-			throw FileFailureWhileOpening{ "No valid file avalailable to load the saves: " + path };
+	// Unchanged since its last validation, when the tmp file was removed.
+	if (identity.has_value() && m_validatedFiles.isValidated(fileName, identity.value()))
+		return;
+
+	if (identity.has_value() && checkingContentValdity(fileName, identity->size))
+	{	// No need to check for the tmp file as the perm file IS valid.
+		m_backend->remove(m_root, fileName + ".tmp"); // Delete the tmp file in case it is still there.
+		m_validatedFiles.count(ValidatedFileCache::Operation::Remove);
+
+		m_validatedFiles.markValidated(fileName, identity.value());
+		return;
 	}
+
+	// If the program reaches this point, the permanent file is not valid: the tmp is next to be loaded.
+	std::optional<FileIdentity> const tmpIdentity{ m_validatedFiles.identify(m_root, fileName + ".tmp") };
+	if (!tmpIdentity.has_value() || !checkingContentValdity(fileName + ".tmp", tmpIdentity->size))
+		throw FileFailureWhileOpening{ "No valid file avalailable to load the saves: " + m_root.pathOf(fileName) };
+
+	// Turning the tmp file into the perm file in a single atomic step: there's always one file storing the information.
+	m_backend->rename(m_root, fileName + ".tmp", fileName);
+	m_validatedFiles.count(ValidatedFileCache::Operation::Rename);
+
+	m_validatedFiles.markValidated(fileName, tmpIdentity.value()); // Renaming keeps the inode, the size and the modification time.
 }
 
-bool Save::checkingContentValdity(std::ifstream* reading) noexcept
+bool SaveStore::checkingContentValdity(std::string const& fileName, uint64_t size) noexcept
 {
-	// At the beginning of the tokens's string.
-	reading->seekg(-51, std::ios::end);
+	if (size < tokensOfConfirmation.size())
+		return false;
+
+	try
+	{
+		m_validatedFiles.count(ValidatedFileCache::Operation::Open);
+		std::unique_ptr<IoReadFile> const reading{ m_backend->open(m_root, fileName) };
 
-	std::string fileConfirmation{ (std::istreambuf_iterator<char>(*reading)), std::istreambuf_iterator<char>() }; 
+		// At the beginning of the tokens's string: a single positioned read.
+		m_validatedFiles.count(ValidatedFileCache::Operation::Read);
+		std::string fileConfirmation(tokensOfConfirmation.size(), '\0');
+		size_t const read{ reading->readAt(fileConfirmation.data(), fileConfirmation.size(), size - tokensOfConfirmation.size()) };
 
-	return ((reading->fail()) ? false : fileConfirmation == tokensOfConfirmation);
+		return read == fileConfirmation.size() && fileConfirmation == tokensOfConfirmation;
+	}
+	catch (std::exception const&)
+	{
+		return false;
+	}
 }
 
-std::string Save::encryptDecrypt(std::string const& data, std::string const& key) noexcept
+std::string SaveStore::encryptDecrypt(std::string const& data, std::string_view key) noexcept
 {
-	std::string output{};
-	output.reserve(data.size());
+	std::string output{ data };
+	encryptDecryptInPlace(output.data(), output.size(), key);
+
+	return output;
+}
 
+void SaveStore::encryptDecryptInPlace(char* data, size_t size, std::string_view key, size_t offset) noexcept
+{
 	auto lambdaXorCipher = [](char datum, char key) -> char { return datum ^ key; };
 	auto lambdaComplement = [](uint8_t datum, uint8_t key) -> uint8_t { return 255 - (datum + key); };
 	auto lambdaReverseBits = [](uint8_t datum) -> uint8_t
@@ -285,10 +656,10 @@ std::string Save::encryptDecrypt(std::string const& data, std::string const& key
 		return datum;
 	};
 	
-	for (int i = 0; i < data.size(); ++i)
+	for (size_t i = 0; i < size; ++i)
 	{	// Each letter of data will be encrypted with one letter of the key.
 		char letter{ data[i] };
-		uint8_t const current_key = key[i % key.size()]; // Ensure the key index is within bounds
+		uint8_t const current_key = key[(offset + i) % key.size()]; // Ensure the key index is within bounds
 
 		// Applying three different involutive algorithms in a specific order to ensure decryption works correctly.
 		// so f(h(g(h(f(x))))) == y; and f(h(g(h(f(y))))) == x.
@@ -298,10 +669,8 @@ std::string Save::encryptDecrypt(std::string const& data, std::string const& key
 		letter = lambdaComplement(letter, current_key);
 		letter = lambdaXorCipher(letter, current_key);
 
-		output.push_back(letter);
+		data[i] = letter;
 	}
-
-	return output;
 }
 
 // TODO: empecher cryptage vers \n
\ No newline at end of file
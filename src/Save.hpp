@@ -12,11 +12,17 @@
 #include <fstream>
 #include <filesystem>
 #include <vector> 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <functional>
 #include <memory>
 #include <sstream>
 #include <ios>
+#include "Save/ValidatedFileCache.hpp"
+#include "Save/IoBackend.hpp"
 
 
 /**
@@ -24,6 +30,9 @@
  */
 namespace SafeSaves
 {
+class MappedRecords;
+class RecordStream;
+
 /**
  * \brief Checks if a file exists.
  * \complexity O(1)
@@ -197,26 +206,47 @@ private:
 	std::unique_ptr<std::ofstream> m_fileStream; // File stream managed by the wrapper.
 };
 
-
 /**
- * @brief Provides static functions for saving and loading data.
+ * @brief Saves and loads data safely, within a folder of its own.
  *
- * @note Don't expect this structure to be fast: it interacts with files.
- * @note This struct is non-instantiable and only contains static methods.
+ * Each store has its own root folder, kept open (see IoDirectory), its own cache of the files
+ * already validated, its own cipher key and its own I/O backend. Several stores can then live in
+ * the same process: one per user, or a cache on a RAM disk next to the persistent saves.
+ * Every file is reached relatively to the root: no path is built nor resolved again at each call.
+ *
+ * @note Don't expect this class to be fast: it interacts with files.
  * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ * @note Two stores must not share their root folder: their caches would not see each other's saves.
+ *
+ * @see Save, IoDirectory, SafeSaves, FileFailure
  *
- * @see SafeSaves, FileFailure
+ * @code
+ * SafeSaves::SaveStore profiles{ "../saves/profiles/" + userName, "another key" };
+ * auto error{ profiles.writing("settings.txt", settings) };
+ * @endcode
  */
-struct Save
+class SaveStore
 {
 public:
 
-	Save() noexcept = delete;
-	Save(Save const&) noexcept = delete;
-	Save(Save&&) noexcept = delete;
-	Save& operator=(Save const&) noexcept = delete;
-	Save& operator=(Save&&) noexcept = delete;
-	virtual ~Save() noexcept = delete;
+	/**
+	 * @brief Opens the root folder of the store, after creating it if needed.
+	 * @complexity O(1).
+	 *
+	 * @param[in] root: The path to the folder in which the files are saved.
+	 * @param[in] key: The key used to encrypt and decrypt the files.
+	 * @param[in] backend: The backend through which every file is written, or nullptr for the
+	 *			  default one (StreamBackend). It must outlive the store.
+	 *
+	 * @throw std::invalid_argument if the key is empty.
+	 */
+	explicit SaveStore(std::string root, std::string key = std::string{ defaultKey }, IoBackend* backend = nullptr);
+
+	SaveStore(SaveStore const&) = delete;
+	SaveStore(SaveStore&&) = delete;
+	SaveStore& operator=(SaveStore const&) = delete;
+	SaveStore& operator=(SaveStore&&) = delete;
+	~SaveStore() noexcept = default;
 
 
 	/**
@@ -234,7 +264,42 @@ public:
 	 *
 	 * @see writing().
 	 */
-	[[nodiscard]] static std::optional<std::string> reading(std::string const& fileName, std::vector<std::string>& valuesToLoad, bool decrypt = true) noexcept;
+	[[nodiscard]] std::optional<std::string> reading(std::string const& fileName, std::vector<std::string>& valuesToLoad, bool decrypt = true) noexcept;
+
+	/**
+	 * @brief Reads every line of a file without copying them.
+	 * @details The file is memory-mapped. Unencrypted lines are views into the mapping; encrypted
+	 *			ones are decrypted in bulk into a single buffer owned by `records`. Unlike reading(),
+	 *			the number of lines does not need to be known in advance.
+	 * @complexity O(N) where N is the size of the file.
+	 *
+	 * @param[in] fileName: The name of the file.
+	 * @param[out] records: Where the lines are loaded. Its previous content is discarded.
+	 * @param[in] decrypt: True if the values need to be decrypted.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @see reading(), MappedRecords.
+	 */
+	[[nodiscard]] std::optional<std::string> readingMapped(std::string const& fileName, MappedRecords& records, bool decrypt = true) noexcept;
+
+	/**
+	 * @brief Opens a file to read its lines one at a time, with a constant amount of memory.
+	 * @details The file is validated, then read by chunks as the records are pulled: stopping
+	 *			early reads nothing more. Meant for files too large to be loaded at once.
+	 * @complexity O(1): the records are read by the stream.
+	 *
+	 * @param[in] fileName: The name of the file.
+	 * @param[out] records: The stream of the lines. A file it had opened is closed.
+	 * @param[in] decrypt: True if the values need to be decrypted.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @note The store must outlive the stream if the values are decrypted.
+	 *
+	 * @see reading(), readingMapped(), RecordStream.
+	 */
+	[[nodiscard]] std::optional<std::string> streaming(std::string const& fileName, RecordStream& records, bool decrypt = true) noexcept;
 
 	/**
 	 * @brief Writes data into a file
@@ -246,14 +311,54 @@ public:
 	 * @param[in] fileName: The name of the file.
 	 * @param[in] valuesToSave: The vector that contains the data to save.
 	 * @param[in] encrypt: True if the values need to be encrypted.
+	 * @param[in] sync: True to wait until the new file is on the disk before it replaces the
+	 *			  previous one, and until the rename is on the disk too, so the save survives a
+	 *			  power loss once the function returns.
 	 *
 	 * @return an optional string that contains an error message.
 	 *
 	 * @note Avoid putting the character \n in any string.
 	 *
-	 * @see writing(), createFile().
+	 * @see writing(), createFile(), IoFile::sync().
+	 */
+	[[nodiscard]] std::optional<std::string> writing(std::string const& fileName, std::vector<std::string> const& valuesToSave, bool encrypt = true, bool sync = false) noexcept;
+
+	/**
+	 * @brief Reads the whole content of a file as a single binary blob.
+	 * @complexity O(N) where N is the size of the file.
+	 *
+	 * @param[in] fileName: The name of the file.
+	 * @param[out] blobToLoad: The string in which the content will be stored in.
+	 * @param[in] decrypt: True if the content needs to be decrypted.
+	 * @param[in] decompress: True if the content has been compressed by writingBlob().
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @see writingBlob().
+	 */
+	[[nodiscard]] std::optional<std::string> readingBlob(std::string const& fileName, std::string& blobToLoad, bool decrypt = true, bool decompress = false) noexcept;
+
+	/**
+	 * @brief Writes a binary blob into a file.
+	 * @details Unlike writing(), the content is not split into lines: any byte, including \n, can
+	 *			be stored. The file is protected by the same tokens of confirmation.
+	 *			The blob goes through a buffer of fixed size, chunk by chunk: compressed first, then
+	 *			encrypted, then written. Encrypted data does not compress, hence this order.
+	 * @complexity O(N) where N is the size of the blob.
+	 *
+	 * @param[in] fileName: The name of the file.
+	 * @param[in] blobToSave: The data to save.
+	 * @param[in] encrypt: True if the content needs to be encrypted.
+	 * @param[in] compress: True if the content needs to be compressed. It must then be read with
+	 *			  `decompress` set to true.
+	 * @param[in] sync: True to wait until the new file is on the disk before it replaces the
+	 *			  previous one, as writing() does.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @see readingBlob(), createFile(), Compression.
 	 */
-	[[nodiscard]] static std::optional<std::string> writing(std::string const& fileName, std::vector<std::string> const& valuesToSave, bool encrypt = true) noexcept;
+	[[nodiscard]] std::optional<std::string> writingBlob(std::string const& fileName, std::string_view blobToSave, bool encrypt = true, bool compress = false, bool sync = false) noexcept;
 
 	/**
 	 * @brief Creates a valid file .txt to store information, or resets a file.
@@ -267,15 +372,79 @@ public:
 	 * 
 	 * @see std::filesystem for removal or getting the names of existent files.
 	 */
-	[[nodiscard]] static std::optional<std::string> createFile(std::string const& fileName) noexcept;
+	[[nodiscard]] std::optional<std::string> createFile(std::string const& fileName) noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of file operations done to validate, recover and prepare the files since
+	 *		   the last call to resetFileOperationCounters().
+	 *
+	 * @see FileOperationCounters.
+	 */
+	[[nodiscard]] inline FileOperationCounters getFileOperationCounters() const noexcept { return m_validatedFiles.counters(); }
+
+	/**
+	 * @brief Sets every file operation counter to 0.
+	 * @complexity O(1).
+	 */
+	inline void resetFileOperationCounters() noexcept { m_validatedFiles.resetCounters(); }
+
+	/**
+	 * @brief Forgets which files have been validated, so they are all checked again.
+	 * @complexity O(N) where N is the number of files validated.
+	 *
+	 * @note Only needed if a file can be modified by another program without changing its size nor
+	 *		 its modification time.
+	 */
+	inline void forgetValidatedFiles() noexcept { m_validatedFiles.clear(); }
+
+	/**
+	 * @brief Sets the backend through which every file is written, created, renamed and removed.
+	 * @complexity O(1).
+	 *
+	 * @param[in] newBackend: The backend to use, or nullptr for the default one (StreamBackend). It
+	 *			  must outlive its use.
+	 *
+	 * @note Not thread-safe: no file may be saved while the backend is replaced.
+	 *
+	 * @see IoBackend, makeIoBackend(), FaultInjectionBackend.
+	 */
+	inline void setIoBackend(IoBackend* newBackend) noexcept { m_backend = (newBackend != nullptr) ? newBackend : &defaultBackend; }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The root folder of the store.
+	 */
+	[[nodiscard]] inline IoDirectory const& root() const noexcept { return m_root; }
+
+
+	static constexpr std::string_view defaultKey{ "7gK9!wZp2FhJ8@qL" }; // The key of Save::store().
 
 private:
 
+	/**
+	 * @brief Encodes a blob as writingBlob() stores it, chunk by chunk.
+	 * @complexity O(N) where N is the size of the blob.
+	 *
+	 * @param[in] blobToSave: The data to encode.
+	 * @param[in] encrypt: True if the content needs to be encrypted.
+	 * @param[in] compress: True if the content needs to be compressed.
+	 * @param[in] output: Called with each encoded chunk, in order. The chunk is only valid during the call.
+	 *
+	 * @note The tokens of confirmation are not part of the output.
+	 *
+	 * @see writingBlob(), Compression.
+	 */
+	void encodingBlob(std::string_view blobToSave, bool encrypt, bool compress, std::function<void(std::string const&)> const& output) const;
+
 	/**
 	 * @brief Opens a safe stream to a file.
 	 * 
-	 * @param[in] path: The path to the file.
+	 * @param[in] fileName: The name of the file.
 	 * @param[out] errorMessage: The error message if a critical error occured.
+	 * @param[in] mode: File open mode.
 	 * 
 	 * @return ReadingStreamRAIIWrapper that contains the stream.
 	 *
@@ -284,51 +453,79 @@ private:
 	 * 
 	 * @see cleanUpFiles(), reading().
 	 */
-	[[nodiscard]] static ReadingStreamRAIIWrapper openReadingStream(std::string const& path, std::ostringstream& errorMessage) noexcept;
+	[[nodiscard]] ReadingStreamRAIIWrapper openReadingStream(std::string const& fileName, std::ostringstream& errorMessage, std::ios::openmode mode = std::ios::in) noexcept;
 
 	/**
-	 * @brief Opens a safe stream to a file.
+	 * @brief Opens the tmp file of a file for writing, through the backend.
+	 * @details The file itself is never modified in place: the new content is written into its tmp
+	 *			file, which replaces it once complete.
 	 *
-	 * @param[in] path: The path to the file.
+	 * @param[in] fileName: The name of the file.
 	 * @param[out] errorMessage: The error message if a critical error occured.
 	 *
-	 * @return WritingStreamRAIIWrapper that contains the stream.
-	 *
-	 * @note You need to check the value of the wrapper to see its validity.
-	 * @note If a message was added in errorMessage then the stream is not valid.
+	 * @return The tmp file opened, or nullptr if a message was added in errorMessage.
 	 * 
-	 * @see cleanUpFiles(), writing().
+	 * @see cleanUpFiles(), finishWriting(), writing(), IoBackend.
 	 */
-	[[nodiscard]] static WritingStreamRAIIWrapper openWritingStream(std::string const& path, std::ostringstream& errorMessage) noexcept;
+	[[nodiscard]] std::unique_ptr<IoFile> openWritingFile(std::string const& fileName, std::ostringstream& errorMessage) noexcept;
+
+	/**
+	 * @brief Replaces a file by its tmp file, once written and closed.
+	 * @details If the tmp file is complete (ends with the tokens of confirmation), the current file
+	 *			is kept as a generation, then the tmp file is renamed over it. Otherwise the tmp file
+	 *			is removed and the current file is kept as is.
+	 * @complexity O(1).
+	 *
+	 * @param[in] fileName: The name of the file.
+	 * @param[out] errorMessage: The error message if the new content could not replace the file.
+	 * @param[in] sync: True to flush the directory once renamed, so the new file survives a power loss.
+	 *
+	 * @see openWritingFile(), SaveGenerations.
+	 */
+	void finishWriting(std::string const& fileName, std::ostringstream& errorMessage, bool sync) noexcept;
 
 	/**
 	* @brief Cleans up files by removing temporary or corrupted files.
+	* @details A file whose tokens have been checked is not checked again until its identity (inode,
+	*		   size, modification time) changes: a single stat is then enough. If the file is not valid,
+	*		   its tmp file replaces it with a single rename.
 	* @complexity O(1).
 	* 
-	* @param[in] path: The path to the file to clean up.
+	* @param[in] fileName: The name of the file to clean up.
 	* 
 	* @pre The file must be readable and valid (or its tmp).
 	* @throw FileFailureWhileOpening if no valid (existing or non corrputed) files exist.
 	* @throw std::exceptions if an important error occured and is unknown.
 	* 		 Strong exceptions guarrantee.
 	* 
-	* @see openReadingStream(), openWritingStream(), checkingContentValdity()
+	* @see openReadingStream(), openWritingFile(), checkingContentValdity(), ValidatedFileCache.
 	*/
-	static void cleanUpFiles(std::string const& path);
+	void cleanUpFiles(std::string const& fileName);
 
 	/**
 	 * @brief Checks if a file has a valid content - isn't corrupted.
 	 * @complexity O(1).
 	 * 
-	 * @param[in] loading: the stream to the file to check.
+	 * @param[in] fileName: The name of the file to check.
+	 * @param[in] size: The size of the file, already known from its identity.
 	 * 
-	 * @note the cursor of loading will be changed
-	 * 
-	 * @return True if the file is valid.
+	 * @return True if the file ends with the tokens of confirmation.
 	 * 
 	 * @see CleanUpFiles().
 	 */
-	[[nodiscard]] static bool checkingContentValdity(std::ifstream* loading) noexcept;
+	[[nodiscard]] bool checkingContentValdity(std::string const& fileName, uint64_t size) noexcept;
+
+	/**
+	 * @brief Encrypts or decrypts data in place with the key of the store.
+	 * @complexity O(N) where N is the number of value to encrypt.
+	 *
+	 * @param[in,out] data: The data to encrypt.
+	 * @param[in] size: The number of characters to encrypt.
+	 * @param[in] offset: The position of data in the whole content that is encrypted piece by piece.
+	 *
+	 * @see encryptDecryptInPlace().
+	 */
+	inline void cipher(char* data, size_t size, size_t offset = 0) const noexcept { encryptDecryptInPlace(data, size, m_key, offset); }
 
 	/**
 	 * @brief Encrypt or decrypt the data using several involutive algorithms.
@@ -342,12 +539,109 @@ private:
 	 * 
 	 * @return the data encrypted.
 	 */
-	[[nodiscard]] static std::string encryptDecrypt(std::string const& data, std::string const& key = "7gK9!wZp2FhJ8@qL") noexcept;
+	[[nodiscard]] static std::string encryptDecrypt(std::string const& data, std::string_view key) noexcept;
+
+	/**
+	 * @brief Same as encryptDecrypt(), but overwrites the data instead of allocating a new string.
+	 * @complexity O(N) where N is the number of value to encrypt.
+	 *
+	 * @param[in,out] data: The data to encrypt.
+	 * @param[in] size: The number of characters to encrypt.
+	 * @param[in] key: The key to use.
+	 * @param[in] offset: The position of data in the whole content: the first character is encrypted
+	 *			  with the letter of the key at this position.
+	 *
+	 * @pre The key must not be empty.
+	 * @see encryptDecrypt().
+	 */
+	static void encryptDecryptInPlace(char* data, size_t size, std::string_view key, size_t offset = 0) noexcept;
+
+
+	IoDirectory m_root; // Kept open: every file is reached relatively to it.
+	ValidatedFileCache m_validatedFiles; // The files whose tokens have already been checked.
+	std::string m_key; // Encrypts and decrypts the files.
+	IoBackend* m_backend; // Never nullptr.
+	std::atomic<size_t> m_generationCapacity; // The number of generations kept per file, see SaveGenerations.
+	std::mutex m_generationsMutex; // Only one generation of the store is created, restored or removed at a time.
 
-	
-	static std::string const savesPath; // The relative path to the saves folder.
 	static std::string const tokensOfConfirmation; // The tokens that confirm that the file has been correctly saved.
+	static StreamBackend defaultBackend; // Stateless: shared by every store.
+
+	static constexpr size_t writeBufferSize{ 64 * 1024 }; // Lines are written by chunks of this size.
+
+friend class BlobStore;
+friend class IndexedSave;
+friend class JournaledSave;
+friend class RecordStream;
+friend class SaveTransaction;
+friend struct SaveGenerations;
+};
+
+/**
+ * @brief Provides static functions for saving and loading data, in the default store.
+ *
+ * The default store saves the files in `../saves/`. Each function is the same as the one of
+ * SaveStore with the same name.
+ *
+ * @note This struct is non-instantiable and only contains static methods.
+ * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ *
+ * @see SaveStore, SafeSaves, FileFailure
+ */
+struct Save
+{
+public:
+
+	Save() noexcept = delete;
+	Save(Save const&) noexcept = delete;
+	Save(Save&&) noexcept = delete;
+	Save& operator=(Save const&) noexcept = delete;
+	Save& operator=(Save&&) noexcept = delete;
+	virtual ~Save() noexcept = delete;
+
+
+	/// @see SaveStore::reading().
+	[[nodiscard]] static inline std::optional<std::string> reading(std::string const& fileName, std::vector<std::string>& valuesToLoad, bool decrypt = true) noexcept { return store().reading(fileName, valuesToLoad, decrypt); }
+
+	/// @see SaveStore::readingMapped().
+	[[nodiscard]] static inline std::optional<std::string> readingMapped(std::string const& fileName, MappedRecords& records, bool decrypt = true) noexcept { return store().readingMapped(fileName, records, decrypt); }
+
+	/// @see SaveStore::streaming().
+	[[nodiscard]] static inline std::optional<std::string> streaming(std::string const& fileName, RecordStream& records, bool decrypt = true) noexcept { return store().streaming(fileName, records, decrypt); }
+
+	/// @see SaveStore::writing().
+	[[nodiscard]] static inline std::optional<std::string> writing(std::string const& fileName, std::vector<std::string> const& valuesToSave, bool encrypt = true) noexcept { return store().writing(fileName, valuesToSave, encrypt); }
+
+	/// @see SaveStore::readingBlob().
+	[[nodiscard]] static inline std::optional<std::string> readingBlob(std::string const& fileName, std::string& blobToLoad, bool decrypt = true, bool decompress = false) noexcept { return store().readingBlob(fileName, blobToLoad, decrypt, decompress); }
+
+	/// @see SaveStore::writingBlob().
+	[[nodiscard]] static inline std::optional<std::string> writingBlob(std::string const& fileName, std::string_view blobToSave, bool encrypt = true, bool compress = false) noexcept { return store().writingBlob(fileName, blobToSave, encrypt, compress); }
+
+	/// @see SaveStore::createFile().
+	[[nodiscard]] static inline std::optional<std::string> createFile(std::string const& fileName) noexcept { return store().createFile(fileName); }
+
+	/// @see SaveStore::getFileOperationCounters().
+	[[nodiscard]] static inline FileOperationCounters getFileOperationCounters() noexcept { return store().getFileOperationCounters(); }
+
+	/// @see SaveStore::resetFileOperationCounters().
+	static inline void resetFileOperationCounters() noexcept { store().resetFileOperationCounters(); }
+
+	/// @see SaveStore::forgetValidatedFiles().
+	static inline void forgetValidatedFiles() noexcept { store().forgetValidatedFiles(); }
+
+	/// @see SaveStore::setIoBackend().
+	static inline void setIoBackend(IoBackend* newBackend) noexcept { store().setIoBackend(newBackend); }
+
+	/**
+	 * @brief Gives the store used by every function of Save.
+	 * @details Created at the first call, in `../saves/`.
+	 * @complexity O(1).
+	 *
+	 * @return The default store.
+	 */
+	[[nodiscard]] static SaveStore& store() noexcept;
 };
 } // namespace SafeSaves
 
-#endif //SAVE_HPP
\ No newline at end of file
+#endif //SAVE_HPP
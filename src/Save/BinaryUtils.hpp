@@ -0,0 +1,164 @@
+/*******************************************************************
+ * @file BinaryUtils.hpp
+ * @brief Helpers to encode integers and checksum binary save formats.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note This file does not have a .cpp file.
+ *********************************************************************/
+
+#ifndef BINARYUTILS_HPP
+#define BINARYUTILS_HPP
+
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Appends an unsigned integer in little endian, whatever the platform is.
+ * @complexity O(1).
+ *
+ * @param[out] buffer: Where the bytes are appended.
+ * @param[in] value: The value to append.
+ *
+ * @throw std::bad_alloc if the buffer has to grow and memory ran out.
+ *
+ * @see readInteger().
+ */
+template<std::unsigned_integral T>
+inline void appendInteger(std::string& buffer, T value)
+{
+	for (size_t i{ 0 }; i < sizeof(T); ++i)
+		buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * @brief Reads an unsigned integer written by appendInteger().
+ * @complexity O(1).
+ *
+ * @param[in] buffer: The bytes to read from.
+ * @param[in] offset: Where the integer begins within the buffer.
+ *
+ * @return The value read.
+ *
+ * @pre `offset + sizeof(T)` must not be greater than the buffer size.
+ *
+ * @see appendInteger().
+ */
+template<std::unsigned_integral T>
+[[nodiscard]] inline T readInteger(std::string_view buffer, size_t offset) noexcept
+{
+	T value{ 0 };
+	for (size_t i{ 0 }; i < sizeof(T); ++i)
+		value |= static_cast<T>(static_cast<uint8_t>(buffer[offset + i])) << (8 * i);
+
+	return value;
+}
+
+
+/**
+ * @brief Computes the CRC-32 (IEEE 802.3) of some data, to detect corrupted bytes.
+ * @complexity O(N) where N is the size of the data.
+ *
+ * @param[in] data: The data to check.
+ * @param[in] previous: The CRC of the data preceding this one, to compute it in several parts.
+ *
+ * @return The checksum.
+ */
+[[nodiscard]] inline uint32_t crc32(std::string_view data, uint32_t previous = 0) noexcept
+{
+	static constexpr std::array<uint32_t, 256> table{ []() constexpr
+	{
+		std::array<uint32_t, 256> result{};
+		for (uint32_t i{ 0 }; i < 256; ++i)
+		{
+			uint32_t value{ i };
+			for (int bit{ 0 }; bit < 8; ++bit)
+				value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+			result[i] = value;
+		}
+		return result;
+	}() };
+
+	uint32_t crc{ ~previous };
+	for (char const datum : data)
+		crc = table[(crc ^ static_cast<uint8_t>(datum)) & 0xFF] ^ (crc >> 8);
+
+	return ~crc;
+}
+
+/**
+ * @brief Computes the 64 bits hash of some data with XXH64, to identify a content by its bytes.
+ * @details Unlike std::hash, the result is the same on every platform and in every run: it can be
+ *			stored in files. It is not cryptographic.
+ * @complexity O(N) where N is the size of the data.
+ *
+ * @param[in] data: The data to hash.
+ * @param[in] seed: Gives another hash for the same data.
+ *
+ * @return The hash.
+ */
+[[nodiscard]] inline uint64_t hash64(std::string_view data, uint64_t seed = 0) noexcept
+{
+	constexpr uint64_t prime1{ 0x9E3779B185EBCA87ull };
+	constexpr uint64_t prime2{ 0xC2B2AE3D27D4EB4Full };
+	constexpr uint64_t prime3{ 0x165667B19E3779F9ull };
+	constexpr uint64_t prime4{ 0x85EBCA77C2B2AE63ull };
+	constexpr uint64_t prime5{ 0x27D4EB2F165667C5ull };
+
+	auto const rotate = [](uint64_t value, int bits) -> uint64_t { return (value << bits) | (value >> (64 - bits)); };
+	auto const round = [&rotate](uint64_t accumulator, uint64_t input) -> uint64_t { return rotate(accumulator + input * prime2, 31) * prime1; };
+	auto const merge = [&round](uint64_t hash, uint64_t accumulator) -> uint64_t { return (hash ^ round(0, accumulator)) * prime1 + prime4; };
+
+	size_t const size{ data.size() };
+	size_t offset{ 0 };
+	uint64_t hash{};
+
+	if (size >= 32)
+	{	// Four lanes, 32 bytes per iteration.
+		uint64_t lanes[4]{ seed + prime1 + prime2, seed + prime2, seed, seed - prime1 };
+
+		for (; offset + 32 <= size; offset += 32)
+			for (size_t lane{ 0 }; lane < 4; ++lane)
+				lanes[lane] = round(lanes[lane], readInteger<uint64_t>(data, offset + lane * 8));
+
+		hash = rotate(lanes[0], 1) + rotate(lanes[1], 7) + rotate(lanes[2], 12) + rotate(lanes[3], 18);
+		for (uint64_t const lane : lanes)
+			hash = merge(hash, lane);
+	}
+	else
+		hash = seed + prime5;
+
+	hash += size;
+
+	for (; offset + 8 <= size; offset += 8)
+		hash = rotate(hash ^ round(0, readInteger<uint64_t>(data, offset)), 27) * prime1 + prime4;
+
+	if (offset + 4 <= size)
+	{
+		hash = rotate(hash ^ (readInteger<uint32_t>(data, offset) * prime1), 23) * prime2 + prime3;
+		offset += 4;
+	}
+
+	for (; offset < size; ++offset)
+		hash = rotate(hash ^ (static_cast<uint8_t>(data[offset]) * prime5), 11) * prime1;
+
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
+} // namespace SafeSaves
+
+#endif //BINARYUTILS_HPP
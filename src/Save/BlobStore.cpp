@@ -0,0 +1,273 @@
+#include <charconv>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "BlobStore.hpp"
+#include "BinaryUtils.hpp"
+#include "IoBackend.hpp"
+#include "../Save.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+
+BlobKey BlobKey::of(std::string_view blob) noexcept
+{
+	return BlobKey{ hash64(blob), hash64(blob, checkSeed), blob.size() };
+}
+
+std::string BlobKey::toString() const
+{
+	std::string key{};
+
+	for (uint64_t const half : { hash, check })
+	{
+		char text[16]{};
+		auto const halfEnd{ std::to_chars(text, text + 16, half, 16).ptr };
+
+		key.append(16 - static_cast<size_t>(halfEnd - text), '0'); // Always 16 digits: the names are sorted by hash.
+		key.append(text, halfEnd);
+	}
+
+	key.push_back('-');
+	key.append(std::to_string(size));
+	return key;
+}
+
+std::optional<BlobKey> BlobKey::fromString(std::string_view text) noexcept
+{
+	BlobKey key{};
+
+	if (text.size() < 34 || text[32] != '-')
+		return std::nullopt;
+
+	auto const hashResult{ std::from_chars(text.data(), text.data() + 16, key.hash, 16) };
+	auto const checkResult{ std::from_chars(text.data() + 16, text.data() + 32, key.check, 16) };
+	auto const sizeResult{ std::from_chars(text.data() + 33, text.data() + text.size(), key.size) };
+
+	if (hashResult.ec != std::errc{} || hashResult.ptr != text.data() + 16 || checkResult.ec != std::errc{} || checkResult.ptr != text.data() + 32
+	||  sizeResult.ec != std::errc{} || sizeResult.ptr != text.data() + text.size())
+		return std::nullopt;
+
+	return key;
+}
+
+
+BlobStore::BlobStore(SaveStore& store, bool encrypt, bool compress) noexcept
+	: m_store{ store }, m_references{ 2.f, encrypt, store }, m_mutex{}, m_encrypt{ encrypt }, m_compress{ compress }
+{}
+
+std::optional<std::string> BlobStore::open() noexcept
+{
+	std::unique_lock lock{ m_mutex };
+
+	std::error_code alreadyThere{};
+	std::filesystem::create_directories(m_store.m_root.pathOf(folder), alreadyThere);
+
+	try
+	{
+		return m_references.open(std::string{ folder } + std::string{ referencesName });
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+}
+
+std::optional<std::string> BlobStore::put(std::string_view blob, BlobKey& key) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	std::ostringstream errorMessage{};
+
+	try
+	{
+		BlobKey const newKey{ BlobKey::of(blob) };
+		std::string const name{ newKey.toString() };
+
+		std::string count{};
+		bool const isStored{ m_references.get(name, count) };
+
+		if (!isStored)
+			writeBlob(name, blob); // Before its reference: a crash leaves an orphan, never a missing blob.
+
+		if (auto error{ m_references.put(name, std::to_string((isStored) ? std::stoull(count) + 1 : 1)) })
+			return error;
+
+		key = newKey;
+	}
+	catch (FileFailure const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the blob is not stored" << "\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> BlobStore::get(BlobKey const& key, std::string& blob) noexcept
+{
+	std::string temp{};
+
+	try
+	{
+		if (auto error{ m_store.readingBlob(std::string{ folder } + key.toString(), temp, m_encrypt, m_compress) })
+			return error;
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected, while building the name.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	if (temp.size() != key.size) [[unlikely]]
+	{
+		std::ostringstream errorMessage{};
+		errorMessage << "The blob does not match its key: " << key.toString() << '\n';
+		errorMessage << "Critical error: the blob is corrupted" << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	blob = std::move(temp);
+	return std::nullopt;
+}
+
+std::optional<std::string> BlobStore::release(BlobKey const& key) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	std::ostringstream errorMessage{};
+
+	try
+	{
+		std::string const name{ key.toString() };
+		std::string count{};
+
+		if (!m_references.get(name, count) || std::stoull(count) == 0) [[unlikely]]
+		{
+			errorMessage << "Error: the blob " << name << " has no reference to release" << "\n\n";
+			return std::make_optional<std::string>(errorMessage.str());
+		}
+
+		// Kept at 0 until collectGarbage(): put again, it is not rewritten.
+		return m_references.put(name, std::to_string(std::stoull(count) - 1));
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	return std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> BlobStore::collectGarbage(size_t& removed) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	std::ostringstream errorMessage{};
+	removed = 0;
+
+	try
+	{
+		std::vector<JournalUpdate> unreferenced{};
+		m_references.forEach([&unreferenced](std::string const& name, std::string const& count)
+		{
+			if (count == "0")
+				unreferenced.push_back(JournalUpdate{ name, std::nullopt });
+		});
+
+		// The blobs first: a crash before the counts are updated only leaves them at 0.
+		for (auto const& blob : unreferenced)
+		{
+			std::string const name{ std::string{ folder } + blob.key };
+			m_store.m_backend->remove(m_store.m_root, name);
+			m_store.m_validatedFiles.forget(name);
+			++removed;
+		}
+
+		if (auto error{ m_references.apply(unreferenced) })
+			return error;
+
+		// The blobs written without their reference, and the tmp files, left by a crash.
+		std::error_code noFolder{};
+		for (std::filesystem::directory_iterator entry{ m_store.m_root.pathOf(folder), noFolder }, end{}; !noFolder && entry != end; entry.increment(noFolder))
+		{
+			std::string const fileName{ entry->path().filename().string() };
+			std::string_view const blobName{ std::string_view{ fileName }.substr(0, fileName.find('.')) };
+			std::string count{};
+
+			if (!BlobKey::fromString(blobName).has_value() || (fileName == blobName && m_references.get(fileName, count)))
+				continue;
+
+			std::string const name{ std::string{ folder } + fileName };
+			m_store.m_backend->remove(m_store.m_root, name);
+			m_store.m_validatedFiles.forget(name);
+
+			if (fileName == blobName)
+				++removed;
+		}
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: some blobs without reference may have been kept" << "\n\n";
+	}
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+uint64_t BlobStore::references(BlobKey const& key) const noexcept
+{
+	try
+	{
+		std::string count{};
+		return (m_references.get(key.toString(), count)) ? std::stoull(count) : 0;
+	}
+	catch (std::exception const&)
+	{
+		return 0;
+	}
+}
+
+void BlobStore::writeBlob(std::string const& name, std::string_view blob)
+{
+	std::string const path{ std::string{ folder } + name };
+
+	// As SaveStore::writingBlob(), without the validation of a previous file: there is none.
+	std::unique_ptr<IoFile> file{ m_store.m_backend->create(m_store.m_root, path + ".tmp") };
+
+	try
+	{
+		m_store.encodingBlob(blob, m_encrypt, m_compress, [&file, &path](std::string const& chunk)
+		{
+			writeWhole(*file, chunk, path);
+		});
+
+		writeWhole(*file, SaveStore::tokensOfConfirmation, path);
+		file->close();
+		file.reset();
+
+		m_store.m_backend->rename(m_store.m_root, path + ".tmp", path);
+	}
+	catch (std::exception const&)
+	{
+		file.reset();
+		m_store.m_backend->remove(m_store.m_root, path + ".tmp");
+		throw;
+	}
+}
@@ -0,0 +1,203 @@
+/*******************************************************************
+ * @file BlobStore.hpp
+ * @brief Declares a store of large blobs shared between saves, kept once per content.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef BLOBSTORE_HPP
+#define BLOBSTORE_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "JournaledSave.hpp"
+#include "../Save.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Identifies a blob by its content.
+ *
+ * @see BlobStore.
+ */
+struct BlobKey
+{
+	uint64_t hash; // hash64() of the content.
+	uint64_t check; // hash64() of the content with another seed: 128 bits of hash in all.
+	uint64_t size; // Size of the content, in bytes: two contents must share it and both hashes to be mixed up.
+
+	/**
+	 * @complexity O(N) where N is the size of the content.
+	 *
+	 * @param[in] blob: The content of a blob.
+	 *
+	 * @return The key of the content.
+	 */
+	[[nodiscard]] static BlobKey of(std::string_view blob) noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The key as text, to be stored in a save file. It is also the name of the blob.
+	 */
+	[[nodiscard]] std::string toString() const;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] text: A key, as given by toString().
+	 *
+	 * @return The key, or std::nullopt if the text is not a key.
+	 */
+	[[nodiscard]] static std::optional<BlobKey> fromString(std::string_view text) noexcept;
+
+	[[nodiscard]] bool operator==(BlobKey const&) const noexcept = default;
+
+	static constexpr uint64_t checkSeed{ 0x9E3779B97F4A7C15ull }; // The seed of the second hash.
+};
+
+/**
+ * @brief Stores each blob once, however many saves reference it.
+ *
+ * The blobs are saved in the `blobs/` folder of a store, named by their key (hash and size of
+ * their content). A save file only holds the keys of its blobs, as text: putting a blob that is
+ * already stored costs a hash and a single append to the reference counts, not a copy.
+ *
+ * The reference counts are kept in a JournaledSave, `blobs/references`. A blob whose count falls
+ * to 0 stays on the disk until collectGarbage(), so it is not rewritten if it is put again soon.
+ *
+ * To never leave a save referencing a removed blob, even after a crash:
+ * - put() the blobs before writing the save that references them;
+ * - release() them after the save no longer references them.
+ * A crash in between only keeps a blob longer than needed.
+ *
+ * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ * @note Thread-safe.
+ * @note Two blobs are only mixed up if they have the same size and the same 128 bits of hash: the
+ *		 key is trusted, the stored blob is not read back when it is put again.
+ *
+ * @see BlobKey, JournaledSave, SaveStore.
+ *
+ * @code
+ * SafeSaves::BlobStore blobs{};
+ * SafeSaves::BlobKey thumbnail{};
+ *
+ * if (!blobs.open() && !blobs.put(screenshot, thumbnail))
+ *     auto error{ SafeSaves::Save::writing("slot1.txt", { playerName, thumbnail.toString() }) };
+ * @endcode
+ */
+class BlobStore
+{
+public:
+
+	/**
+	 * @brief Initializes the blob store without opening it.
+	 * @complexity O(1).
+	 *
+	 * @param[in] store: The store in which the blobs are saved. It must outlive the blob store.
+	 * @param[in] encrypt: True if the blobs need to be encrypted.
+	 * @param[in] compress: True if the blobs need to be compressed.
+	 *
+	 * @note The same flags must be given every time the blobs are opened.
+	 */
+	explicit BlobStore(SaveStore& store = Save::store(), bool encrypt = true, bool compress = false) noexcept;
+
+	BlobStore(BlobStore const&) = delete;
+	BlobStore(BlobStore&&) = delete;
+	BlobStore& operator=(BlobStore const&) = delete;
+	BlobStore& operator=(BlobStore&&) = delete;
+	~BlobStore() noexcept = default;
+
+
+	/**
+	 * @brief Loads the reference counts, creating the folder of the blobs if needed.
+	 * @complexity O(N) where N is the number of blobs.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] std::optional<std::string> open() noexcept;
+
+	/**
+	 * @brief Stores a blob if it is not stored yet, then adds a reference to it.
+	 * @complexity O(N) where N is the size of the blob: hashed, and written only if new.
+	 *
+	 * @param[in] blob: The content of the blob.
+	 * @param[out] key: The key of the blob, to store in the save that references it.
+	 *
+	 * @return an optional string that contains an error message. If so, no reference is added.
+	 */
+	[[nodiscard]] std::optional<std::string> put(std::string_view blob, BlobKey& key) noexcept;
+
+	/**
+	 * @brief Reads a blob.
+	 * @complexity O(N) where N is the size of the blob.
+	 *
+	 * @param[in] key: The key of the blob, given by put().
+	 * @param[out] blob: Where the content is loaded.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] std::optional<std::string> get(BlobKey const& key, std::string& blob) noexcept;
+
+	/**
+	 * @brief Removes a reference to a blob.
+	 * @complexity O(1).
+	 *
+	 * @param[in] key: The key of the blob, given by put().
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @note The blob is only removed by collectGarbage(), once it has no reference left.
+	 */
+	[[nodiscard]] std::optional<std::string> release(BlobKey const& key) noexcept;
+
+	/**
+	 * @brief Removes the blobs without reference, and the files left by a crash.
+	 * @complexity O(N) where N is the number of files in the folder of the blobs.
+	 *
+	 * @param[out] removed: The number of blobs removed.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] std::optional<std::string> collectGarbage(size_t& removed) noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] key: The key of a blob.
+	 *
+	 * @return The number of references to the blob, 0 if it is not stored.
+	 */
+	[[nodiscard]] uint64_t references(BlobKey const& key) const noexcept;
+
+private:
+
+	/**
+	 * @brief Writes a blob into its file, as SaveStore::writingBlob() would.
+	 * @details The lock must be held.
+	 *
+	 * @throw FileFailure if the blob cannot be written, std::bad_alloc.
+	 */
+	void writeBlob(std::string const& name, std::string_view blob);
+
+
+	SaveStore& m_store;
+	JournaledSave m_references; // From the name of each blob to its number of references.
+	mutable std::mutex m_mutex; // Only one blob is put, released or collected at a time.
+	bool const m_encrypt;
+	bool const m_compress;
+
+	static constexpr std::string_view folder{ "blobs/" }; // Within the root of the store.
+	static constexpr std::string_view referencesName{ "references" }; // Within the folder.
+};
+} // namespace SafeSaves
+
+#endif //BLOBSTORE_HPP
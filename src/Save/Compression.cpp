@@ -0,0 +1,177 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "Compression.hpp"
+
+using namespace SafeSaves;
+
+
+namespace
+{
+constexpr size_t minimumMatch{ 4 }; // Shorter matches cost more than the literals.
+constexpr size_t lastLiterals{ 5 }; // The block always ends with literals, as in LZ4.
+constexpr size_t matchSafeDistance{ 12 }; // No match starts this close to the end.
+constexpr size_t hashBits{ 13 };
+
+[[nodiscard]] inline uint32_t read32(char const* data) noexcept
+{
+	uint32_t value{};
+	std::memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+[[nodiscard]] inline uint32_t hashOf(uint32_t sequence) noexcept
+{
+	return (sequence * 2654435761u) >> (32 - hashBits);
+}
+
+/// Appends the extra bytes of a length that does not fit in its 4 bits.
+inline void appendLength(std::string& output, size_t length)
+{
+	for (; length >= 255; length -= 255)
+		output.push_back(static_cast<char>(255));
+
+	output.push_back(static_cast<char>(length));
+}
+
+/// Appends a sequence: some literals, then a match if its length is not 0.
+inline void appendSequence(std::string& output, std::string_view literals, size_t offset, size_t matchLength)
+{
+	size_t const literalLength{ literals.size() };
+	size_t const matchCode{ (matchLength == 0) ? 0 : matchLength - minimumMatch };
+
+	output.push_back(static_cast<char>(((literalLength >= 15) ? 15 : literalLength) << 4 | ((matchCode >= 15) ? 15 : matchCode)));
+	if (literalLength >= 15)
+		appendLength(output, literalLength - 15);
+
+	output.append(literals);
+
+	if (matchLength == 0)
+		return; // Last sequence.
+
+	output.push_back(static_cast<char>(offset & 0xFF));
+	output.push_back(static_cast<char>(offset >> 8));
+	if (matchCode >= 15)
+		appendLength(output, matchCode - 15);
+}
+
+/// Reads the extra bytes of a length, returns false if the block ends before.
+[[nodiscard]] inline bool readLength(std::string_view block, size_t& position, size_t& length) noexcept
+{
+	uint8_t byte{ 255 };
+	while (byte == 255)
+	{
+		if (position >= block.size()) [[unlikely]]
+			return false;
+
+		byte = static_cast<uint8_t>(block[position++]);
+		length += byte;
+	}
+
+	return true;
+}
+} // namespace
+
+
+void Compression::compressBlock(std::string_view input, std::string& output)
+{
+	size_t const size{ input.size() };
+	output.reserve(output.size() + maximumBlockSize(size));
+
+	if (size < matchSafeDistance + 1)
+	{	// Too small to hold any match.
+		appendSequence(output, input, 0, 0);
+		return;
+	}
+
+	// Last position where each 4-byte sequence was seen.
+	std::array<uint32_t, 1 << hashBits> table{};
+	char const* const data{ input.data() };
+	size_t const matchLimit{ size - matchSafeDistance };
+	size_t const extendLimit{ size - lastLiterals };
+
+	size_t anchor{ 0 }; // First literal not emitted yet.
+	size_t position{ 1 };
+	table[hashOf(read32(data))] = 0;
+
+	while (position < matchLimit)
+	{
+		uint32_t const sequence{ read32(data + position) };
+		uint32_t const hash{ hashOf(sequence) };
+		size_t const candidate{ table[hash] };
+		table[hash] = static_cast<uint32_t>(position);
+
+		if (candidate >= position || position - candidate > 0xFFFF || read32(data + candidate) != sequence)
+		{	// Skips faster through data that does not compress.
+			position += 1 + ((position - anchor) >> 6);
+			continue;
+		}
+
+		size_t length{ minimumMatch };
+		while (position + length < extendLimit && data[candidate + length] == data[position + length])
+			++length;
+
+		appendSequence(output, input.substr(anchor, position - anchor), position - candidate, length);
+		position += length;
+		anchor = position;
+
+		if (position < matchLimit)
+			table[hashOf(read32(data + position - 2))] = static_cast<uint32_t>(position - 2);
+	}
+
+	appendSequence(output, input.substr(anchor), 0, 0);
+}
+
+bool Compression::decompressBlock(std::string_view block, char* output, size_t outputSize) noexcept
+{
+	size_t in{ 0 };
+	size_t out{ 0 };
+
+	while (in < block.size())
+	{
+		uint8_t const token{ static_cast<uint8_t>(block[in++]) };
+
+		size_t literalLength{ static_cast<size_t>(token >> 4) };
+		if (literalLength == 15 && !readLength(block, in, literalLength)) [[unlikely]]
+			return false;
+
+		if (literalLength > block.size() - in || literalLength > outputSize - out) [[unlikely]]
+			return false;
+
+		std::memcpy(output + out, block.data() + in, literalLength);
+		in += literalLength;
+		out += literalLength;
+
+		if (in == block.size())
+			break; // The last sequence has no match.
+
+		if (block.size() - in < 2) [[unlikely]]
+			return false;
+
+		size_t const offset{ static_cast<size_t>(static_cast<uint8_t>(block[in])) | static_cast<size_t>(static_cast<uint8_t>(block[in + 1])) << 8 };
+		in += 2;
+
+		size_t matchLength{ static_cast<size_t>(token & 0x0F) };
+		if (matchLength == 15 && !readLength(block, in, matchLength)) [[unlikely]]
+			return false;
+		matchLength += minimumMatch;
+
+		if (offset == 0 || offset > out || matchLength > outputSize - out) [[unlikely]]
+			return false;
+
+		// The match may overlap the bytes being written: copied byte by byte in that case.
+		char* const destination{ output + out };
+		char const* const source{ destination - offset };
+		if (offset >= matchLength)
+			std::memcpy(destination, source, matchLength);
+		else
+			for (size_t i{ 0 }; i < matchLength; ++i)
+				destination[i] = source[i];
+
+		out += matchLength;
+	}
+
+	return out == outputSize;
+}
@@ -0,0 +1,91 @@
+/*******************************************************************
+ * @file Compression.hpp
+ * @brief Declares a fast LZ77 codec, in the spirit of LZ4, and the chunked framing of its output.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Compresses and decompresses save payloads, chunk by chunk.
+ *
+ * A block is a sequence of literals and back-references to the previous 64 KiB, encoded as LZ4
+ * does: a token holding both lengths, the literals, a 2-byte offset. No entropy coding is done,
+ * so decompressing is a few copies per sequence.
+ *
+ * A compressed save is a frame: a sequence of chunks of at most `chunkSize` bytes once
+ * decompressed, each compressed on its own and preceded by a header, ended by an empty chunk.
+ * A chunk that does not shrink is stored as is. Therefore, a save can be compressed or
+ * decompressed through a buffer of fixed size, whatever its size.
+ *
+ * Chunk header (little endian):
+ * - u32: size of the chunk once decompressed, 0 for the last one;
+ * - u32: size of the chunk in the file, with the highest bit set if it is stored as is.
+ *
+ * @see Save::writingBlob(), Save::readingBlob().
+ */
+struct Compression
+{
+public:
+
+	Compression() noexcept = delete;
+	Compression(Compression const&) noexcept = delete;
+	Compression(Compression&&) noexcept = delete;
+	Compression& operator=(Compression const&) noexcept = delete;
+	Compression& operator=(Compression&&) noexcept = delete;
+	~Compression() noexcept = delete;
+
+
+	/**
+	 * @brief Compresses data as a single block, appended to a buffer.
+	 * @complexity O(N) where N is the size of the data.
+	 *
+	 * @param[in] input: The data, at most 64 KiB so every offset fits in 2 bytes.
+	 * @param[out] output: Where the block is appended.
+	 *
+	 * @note The block may be larger than the data, by at most maximumBlockSize(N) - N bytes.
+	 *
+	 * @see decompressBlock().
+	 */
+	static void compressBlock(std::string_view input, std::string& output);
+
+	/**
+	 * @brief Decompresses a block written by compressBlock().
+	 * @complexity O(N) where N is the size of the decompressed data.
+	 *
+	 * @param[in] block: The compressed block.
+	 * @param[out] output: Where the data is written.
+	 * @param[in] outputSize: The exact size of the decompressed data.
+	 *
+	 * @return False if the block is corrupted: it never reads or writes out of bounds.
+	 */
+	[[nodiscard]] static bool decompressBlock(std::string_view block, char* output, size_t outputSize) noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The largest block compressBlock() can produce from `size` bytes.
+	 */
+	[[nodiscard]] static constexpr size_t maximumBlockSize(size_t size) noexcept { return size + size / 255 + 16; }
+
+
+	static constexpr size_t chunkSize{ 64 * 1024 }; // Largest chunk once decompressed, a multiple of 16.
+	static constexpr size_t chunkHeaderSize{ 8 }; // Decompressed size and stored size.
+	static constexpr uint32_t storedFlag{ 0x80000000 }; // Set in the stored size if the chunk is not compressed.
+};
+} // namespace SafeSaves
+
+#endif //COMPRESSION_HPP
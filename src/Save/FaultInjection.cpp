@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "FaultInjection.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+
+class FaultInjectionBackend::FaultyFile final : public IoFile
+{
+public:
+
+	FaultyFile(FaultInjectionBackend& backend, std::unique_ptr<IoFile> inner, std::string const& path) noexcept
+		: m_backend{ backend }, m_inner{ std::move(inner) }, m_path{ path }
+	{}
+
+	size_t write(std::string_view data) override
+	{
+		if (m_backend.m_crashed || m_inner == nullptr)
+			return data.size(); // Dead: nothing reaches the disk, but nobody is left to notice.
+
+		FaultPlan const& plan{ m_backend.m_plan };
+		uint64_t const beforeTrigger{ (plan.triggerByte > m_backend.m_bytesWritten) ? plan.triggerByte - m_backend.m_bytesWritten : 0 };
+		size_t written{ 0 };
+
+		switch (plan.fault)
+		{
+		case FileFault::ShortWrites:
+			written = m_inner->write(data.substr(0, static_cast<size_t>(std::max<uint64_t>(plan.triggerByte, 1))));
+			break;
+
+		case FileFault::NoSpace:
+			if (beforeTrigger == 0)
+				throw FileFailureWhileInUse{ "No space left on device: " + m_path };
+
+			written = m_inner->write(data.substr(0, static_cast<size_t>(std::min<uint64_t>(beforeTrigger, data.size()))));
+			break;
+
+		case FileFault::Crash:
+			if (beforeTrigger == 0)
+			{
+				m_backend.m_crashed = true;
+				return data.size();
+			}
+
+			written = m_inner->write(data.substr(0, static_cast<size_t>(std::min<uint64_t>(beforeTrigger, data.size()))));
+			break;
+
+		case FileFault::CorruptTail:
+			if (beforeTrigger < data.size())
+			{	// Written with the right size, but not with the right content.
+				std::string torn{ data };
+				std::fill(torn.begin() + static_cast<std::ptrdiff_t>(beforeTrigger), torn.end(), '\0');
+				written = m_inner->write(torn);
+			}
+			else
+				written = m_inner->write(data);
+			break;
+
+		default:
+			written = m_inner->write(data);
+			break;
+		}
+
+		m_backend.m_bytesWritten += written;
+		return written;
+	}
+
+	void flush() override
+	{
+		if (!m_backend.m_crashed && m_inner != nullptr)
+			m_inner->flush();
+	}
+
+	void sync() override
+	{
+		if (!m_backend.m_crashed && m_inner != nullptr)
+			m_inner->sync();
+	}
+
+	void close() override
+	{
+		if (!m_backend.m_crashed && m_inner != nullptr)
+			m_inner->close();
+	}
+
+private:
+
+	FaultInjectionBackend& m_backend;
+	std::unique_ptr<IoFile> m_inner; // nullptr if created after the crash.
+	std::string m_path;
+};
+
+
+FaultInjectionBackend::FaultInjectionBackend(IoBackend& inner) noexcept
+	: m_inner{ inner }, m_plan{}, m_bytesWritten{ 0 }, m_crashed{ false }
+{}
+
+void FaultInjectionBackend::arm(FaultPlan plan) noexcept
+{
+	m_plan = plan;
+	m_bytesWritten = 0;
+	m_crashed = false;
+}
+
+void FaultInjectionBackend::disarm() noexcept
+{
+	m_plan = FaultPlan{};
+	m_crashed = false;
+}
+
+std::unique_ptr<IoFile> FaultInjectionBackend::create(IoDirectory const& directory, std::string const& name)
+{
+	if (crashesBeforeOperation())
+		return std::make_unique<FaultyFile>(*this, nullptr, name);
+
+	return std::make_unique<FaultyFile>(*this, m_inner.create(directory, name), name);
+}
+
+std::unique_ptr<IoFile> FaultInjectionBackend::append(IoDirectory const& directory, std::string const& name, uint64_t size)
+{
+	if (crashesBeforeOperation())
+		return std::make_unique<FaultyFile>(*this, nullptr, name);
+
+	return std::make_unique<FaultyFile>(*this, m_inner.append(directory, name, size), name);
+}
+
+std::unique_ptr<IoReadFile> FaultInjectionBackend::open(IoDirectory const& directory, std::string const& name)
+{
+	return m_inner.open(directory, name);
+}
+
+void FaultInjectionBackend::rename(IoDirectory const& directory, std::string const& from, std::string const& to)
+{
+	if (!crashesBeforeOperation())
+		m_inner.rename(directory, from, to);
+}
+
+void FaultInjectionBackend::remove(IoDirectory const& directory, std::string const& name) noexcept
+{
+	if (!crashesBeforeOperation())
+		m_inner.remove(directory, name);
+}
+
+bool FaultInjectionBackend::crashesBeforeOperation() noexcept
+{
+	if (m_plan.fault == FileFault::Crash && m_bytesWritten >= m_plan.triggerByte)
+		m_crashed = true;
+
+	return m_crashed;
+}
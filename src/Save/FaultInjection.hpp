@@ -0,0 +1,141 @@
+/*******************************************************************
+ * @file FaultInjection.hpp
+ * @brief Declares a backend that breaks file operations on purpose, to check how Save recovers.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef FAULTINJECTION_HPP
+#define FAULTINJECTION_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include "IoBackend.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief The faults FaultInjectionBackend can simulate.
+ */
+enum class FileFault : uint8_t
+{
+	None,
+	ShortWrites, // Each write accepts at most `triggerByte` bytes (at least 1).
+	NoSpace, // Writes fail once `triggerByte` bytes have been written, as with ENOSPC.
+	Crash, // The process dies once `triggerByte` bytes have been written: nothing else reaches the disk.
+	CorruptTail // Every byte from `triggerByte` on is written as 0, as after a power loss.
+};
+
+/**
+ * @brief When and how the operations are broken.
+ */
+struct FaultPlan
+{
+	FileFault fault{ FileFault::None };
+	uint64_t triggerByte{ 0 }; // Counted over every file written since FaultInjectionBackend::arm().
+};
+
+/**
+ * @brief Decorates a backend to simulate short writes, full disks, crashes and torn writes.
+ *
+ * After a simulated crash, every operation is dropped as if the process had died: the files stay
+ * as they are on the disk. Disarming the backend is then the same as restarting the program.
+ *
+ * @note Not thread-safe: save a single file at a time while armed.
+ *
+ * @see IoBackend, Save::setIoBackend().
+ *
+ * @code
+ * SafeSaves::StreamBackend streams{};
+ * SafeSaves::FaultInjectionBackend faults{ streams };
+ * SafeSaves::Save::setIoBackend(&faults);
+ *
+ * faults.arm(SafeSaves::FaultPlan{ SafeSaves::FileFault::Crash, 100 });
+ * auto error{ SafeSaves::Save::writing("profile.txt", profile) }; // Dies after 100 bytes.
+ * faults.disarm(); // "Restarts": reading gives the previous or the new profile.
+ * @endcode
+ */
+class FaultInjectionBackend final : public IoBackend
+{
+public:
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] inner: The backend that performs the operations which are not broken.
+	 */
+	explicit FaultInjectionBackend(IoBackend& inner) noexcept;
+
+	~FaultInjectionBackend() noexcept = default;
+
+
+	/**
+	 * @brief Starts breaking the operations, and counts the bytes written from 0.
+	 * @complexity O(1).
+	 */
+	void arm(FaultPlan plan) noexcept;
+
+	/**
+	 * @brief Stops breaking the operations, as after a restart if a crash was simulated.
+	 * @complexity O(1).
+	 */
+	void disarm() noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return True if a crash has been simulated since the last call to arm().
+	 */
+	[[nodiscard]] inline bool hasCrashed() const noexcept { return m_crashed; }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of bytes written since the last call to arm(), crash excluded.
+	 */
+	[[nodiscard]] inline uint64_t bytesWritten() const noexcept { return m_bytesWritten; }
+
+
+	/// @see IoBackend::create().
+	[[nodiscard]] std::unique_ptr<IoFile> create(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::append().
+	[[nodiscard]] std::unique_ptr<IoFile> append(IoDirectory const& directory, std::string const& name, uint64_t size) override;
+
+	/// @see IoBackend::open(). Reading is never broken.
+	[[nodiscard]] std::unique_ptr<IoReadFile> open(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::rename().
+	void rename(IoDirectory const& directory, std::string const& from, std::string const& to) override;
+
+	/// @see IoBackend::remove().
+	void remove(IoDirectory const& directory, std::string const& name) noexcept override;
+
+private:
+
+	/// A file written through the fault injection.
+	class FaultyFile;
+
+	/**
+	 * @brief Simulates the crash if the operation to do is beyond the trigger.
+	 *
+	 * @return True if the process is dead: the operation must be dropped.
+	 */
+	[[nodiscard]] bool crashesBeforeOperation() noexcept;
+
+
+	IoBackend& m_inner;
+	FaultPlan m_plan;
+	uint64_t m_bytesWritten;
+	bool m_crashed;
+};
+} // namespace SafeSaves
+
+#endif //FAULTINJECTION_HPP
@@ -0,0 +1,70 @@
+#include <string>
+#include <vector>
+#include "FileSync.hpp"
+#include "../Exceptions.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace SafeSaves;
+
+
+void FileSync::barrier(std::vector<std::string> const& paths)
+{
+	if (paths.empty())
+		return;
+
+#ifdef _WIN32
+	for (auto const& path : paths)
+	{
+		HANDLE const file{ CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+		bool const flushed{ file != INVALID_HANDLE_VALUE && FlushFileBuffers(file) };
+
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+
+		if (!flushed) [[unlikely]]
+			throw FileFailureWhileInUse{ "Unable to flush the file: " + path };
+	}
+#else
+	for (auto const& path : paths)
+	{
+		int const file{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+		if (file < 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "Unable to open the file to flush it: " + path };
+
+#ifdef __APPLE__
+		int const result{ ::fcntl(file, F_FULLFSYNC) }; // fsync() does not reach the disk on macOS.
+#elif defined(__linux__)
+		int const result{ ::fdatasync(file) }; // The size is flushed too: the file can be read back whole.
+#else
+		int const result{ ::fsync(file) };
+#endif
+		::close(file);
+
+		if (result != 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "Unable to flush the file: " + path };
+	}
+#endif
+}
+
+void FileSync::syncDirectory([[maybe_unused]] std::string const& path)
+{
+#ifndef _WIN32
+	int const directory{ ::open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC) };
+	if (directory < 0) [[unlikely]]
+		throw FileFailureWhileInUse{ "Unable to open the directory to flush it: " + path };
+
+	int const result{ ::fsync(directory) };
+	::close(directory);
+
+	if (result != 0) [[unlikely]]
+		throw FileFailureWhileInUse{ "Unable to flush the directory: " + path };
+#endif
+}
@@ -0,0 +1,68 @@
+/*******************************************************************
+ * @file FileSync.hpp
+ * @brief Declares the functions making files durable: written on the disk, not only in the cache.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef FILESYNC_HPP
+#define FILESYNC_HPP
+
+#include <string>
+#include <vector>
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Waits until the disk has files, or the entries of a directory.
+ *
+ * Closing a file only hands its content to the system: a power loss can still lose it, or worse,
+ * keep a rename but not the content renamed. These functions are the barriers needed before a
+ * step that relies on the previous ones being on the disk.
+ *
+ * @note This struct is non-instantiable and only contains static methods.
+ * @note Every function throws FileFailureWhileInUse if the system reports an error.
+ *
+ * @see SaveTransaction.
+ */
+struct FileSync
+{
+public:
+
+	FileSync() noexcept = delete;
+	FileSync(FileSync const&) noexcept = delete;
+	FileSync(FileSync&&) noexcept = delete;
+	FileSync& operator=(FileSync const&) noexcept = delete;
+	FileSync& operator=(FileSync&&) noexcept = delete;
+	~FileSync() noexcept = delete;
+
+
+	/**
+	 * @brief Waits until the content of several files is on the disk.
+	 * @details Each file is flushed through its own descriptor: fdatasync() on Linux, F_FULLFSYNC
+	 *			on macOS and fsync() elsewhere. The other files of the file system, e.g. those of
+	 *			other programs, are not waited for.
+	 * @complexity O(N) where N is the number of files.
+	 *
+	 * @param[in] paths: The paths to the files.
+	 */
+	static void barrier(std::vector<std::string> const& paths);
+
+	/**
+	 * @brief Waits until the entries of a directory (created, renamed and removed files) are on the disk.
+	 * @complexity O(1).
+	 *
+	 * @param[in] path: The path to the directory.
+	 *
+	 * @note Does nothing on Windows, where the entries are flushed with the files.
+	 */
+	static void syncDirectory(std::string const& path);
+};
+} // namespace SafeSaves
+
+#endif //FILESYNC_HPP
@@ -0,0 +1,254 @@
+/*******************************************************************
+ * @file HashIndex.hpp
+ * @brief Declares an open-addressing hash table with string keys, to index saves in memory.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note This file does not have a .cpp file.
+ *********************************************************************/
+
+#ifndef HASHINDEX_HPP
+#define HASHINDEX_HPP
+
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief A hash table from strings to values, stored in a single array with linear probing.
+ *
+ * Unlike std::unordered_map, there is no allocation per element and a lookup reads consecutive
+ * slots: the hash is stored next to the key, so most mismatching keys are never compared. A key
+ * can be looked up with a std::string_view without building a std::string. Erasing shifts the
+ * following slots back instead of leaving tombstones, so lookups never slow down over time.
+ *
+ * @note References and pointers to values are invalidated by any insertion or erasure.
+ *
+ * @tparam Value The type of the values.
+ *
+ * @see JournaledSave, KeyValueStore.
+ */
+template<typename Value>
+class HashIndex
+{
+public:
+
+	HashIndex() noexcept = default;
+	HashIndex(HashIndex const&) = default;
+	HashIndex(HashIndex&&) noexcept = default;
+	HashIndex& operator=(HashIndex const&) = default;
+	HashIndex& operator=(HashIndex&&) noexcept = default;
+	~HashIndex() noexcept = default;
+
+
+	/**
+	 * @complexity O(1) on average.
+	 *
+	 * @param[in] key: The key to look for.
+	 *
+	 * @return A pointer to the value, or nullptr if the key does not exist.
+	 */
+	[[nodiscard]] Value* find(std::string_view key) noexcept
+	{
+		size_t const index{ locate(key, hashOf(key)) };
+		return (m_slots.empty() || m_slots[index].hash == 0) ? nullptr : &m_slots[index].value;
+	}
+
+	/**
+	 * @copydoc find()
+	 */
+	[[nodiscard]] Value const* find(std::string_view key) const noexcept
+	{
+		size_t const index{ locate(key, hashOf(key)) };
+		return (m_slots.empty() || m_slots[index].hash == 0) ? nullptr : &m_slots[index].value;
+	}
+
+	/**
+	 * @complexity O(1) on average.
+	 *
+	 * @return True if the key exists.
+	 */
+	[[nodiscard]] inline bool contains(std::string_view key) const noexcept { return find(key) != nullptr; }
+
+	/**
+	 * @brief Sets the value of a key, inserting it if needed.
+	 * @complexity O(1) amortized.
+	 *
+	 * @param[in] key: The key.
+	 * @param[in] value: The new value.
+	 */
+	void insertOrAssign(std::string_view key, Value value)
+	{
+		if ((m_size + 1) * 4 > m_slots.size() * 3)
+			rehash((m_slots.empty()) ? 16 : m_slots.size() * 2);
+
+		uint64_t const hash{ hashOf(key) };
+		Slot& slot{ m_slots[locate(key, hash)] };
+
+		if (slot.hash == 0)
+		{
+			slot.hash = hash;
+			slot.key = key;
+			++m_size;
+		}
+
+		slot.value = std::move(value);
+	}
+
+	/**
+	 * @brief Removes a key.
+	 * @complexity O(1) on average.
+	 *
+	 * @param[in] key: The key to remove.
+	 *
+	 * @return True if the key existed.
+	 */
+	bool erase(std::string_view key) noexcept
+	{
+		if (m_slots.empty())
+			return false;
+
+		size_t hole{ locate(key, hashOf(key)) };
+		if (m_slots[hole].hash == 0)
+			return false;
+
+		// Backward shift: moves back the following slots that are not at their ideal position.
+		size_t const mask{ m_slots.size() - 1 };
+		for (size_t next{ (hole + 1) & mask }; m_slots[next].hash != 0; next = (next + 1) & mask)
+		{
+			size_t const ideal{ static_cast<size_t>(m_slots[next].hash) & mask };
+			if (((next - ideal) & mask) >= ((next - hole) & mask))
+			{
+				m_slots[hole] = std::move(m_slots[next]);
+				hole = next;
+			}
+		}
+
+		m_slots[hole] = Slot{};
+		--m_size;
+		return true;
+	}
+
+	/**
+	 * @brief Calls a function on every key and value, in no particular order.
+	 * @complexity O(C) where C is the capacity.
+	 *
+	 * @param[in] function: Called with `std::string const&` and `Value const&`.
+	 */
+	template<typename Function>
+	void forEach(Function&& function) const
+	{
+		for (Slot const& slot : m_slots)
+			if (slot.hash != 0)
+				function(slot.key, slot.value);
+	}
+
+	/**
+	 * @brief Allocates enough slots for a number of keys, so no rehash happens until then.
+	 * @complexity O(N) where N is the number of keys.
+	 */
+	void reserve(size_t count)
+	{
+		size_t const capacity{ std::bit_ceil(count * 4 / 3 + 1) };
+		if (capacity > m_slots.size())
+			rehash(capacity);
+	}
+
+	/**
+	 * @brief Removes every key, but keeps the memory.
+	 * @complexity O(C) where C is the capacity.
+	 */
+	void clear() noexcept
+	{
+		for (Slot& slot : m_slots)
+			slot = Slot{};
+
+		m_size = 0;
+	}
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of keys.
+	 */
+	[[nodiscard]] inline size_t size() const noexcept { return m_size; }
+
+private:
+
+	/// A slot is empty if its hash is 0.
+	struct Slot
+	{
+		uint64_t hash{ 0 };
+		std::string key{};
+		Value value{};
+	};
+
+	/**
+	 * @return The hash of a key, never 0.
+	 */
+	[[nodiscard]] static inline uint64_t hashOf(std::string_view key) noexcept
+	{
+		uint64_t const hash{ std::hash<std::string_view>{}(key) };
+		return (hash == 0) ? 1 : hash;
+	}
+
+	/**
+	 * @return The index of the slot of the key, or of the empty slot where it would be inserted.
+	 *
+	 * @pre The table must not be full.
+	 */
+	[[nodiscard]] size_t locate(std::string_view key, uint64_t hash) const noexcept
+	{
+		if (m_slots.empty())
+			return 0;
+
+		size_t const mask{ m_slots.size() - 1 };
+		size_t index{ static_cast<size_t>(hash) & mask };
+
+		while (m_slots[index].hash != 0 && (m_slots[index].hash != hash || m_slots[index].key != key))
+			index = (index + 1) & mask;
+
+		return index;
+	}
+
+	/**
+	 * @brief Moves every key into a new array of slots.
+	 *
+	 * @param[in] capacity: A power of two.
+	 */
+	void rehash(size_t capacity)
+	{
+		std::vector<Slot> previous{ std::exchange(m_slots, std::vector<Slot>(capacity)) };
+		size_t const mask{ capacity - 1 };
+
+		for (Slot& slot : previous)
+		{
+			if (slot.hash == 0)
+				continue;
+
+			size_t index{ static_cast<size_t>(slot.hash) & mask };
+			while (m_slots[index].hash != 0)
+				index = (index + 1) & mask;
+
+			m_slots[index] = std::move(slot);
+		}
+	}
+
+
+	std::vector<Slot> m_slots{}; // The capacity is 0 or a power of two.
+	size_t m_size{ 0 }; // The number of keys.
+};
+} // namespace SafeSaves
+
+#endif //HASHINDEX_HPP
@@ -0,0 +1,261 @@
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "IndexedSave.hpp"
+#include "BinaryUtils.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+
+IndexedSave::IndexedSave(SaveStore& store) noexcept
+	: m_store{ &store }, m_file{}, m_path{}, m_encrypted{ false }, m_entries{}, m_keyIndex{}
+{}
+
+std::optional<std::string> IndexedSave::writing(std::string const& fileName, std::vector<IndexedRecord> const& records, bool encrypt, SaveStore& store) noexcept
+{
+	std::string blob{};
+	std::string index{};
+
+	try
+	{
+		size_t totalSize{ 0 };
+		for (auto const& record : records)
+			totalSize += record.value.size() + record.key.size() + entrySize;
+		blob.reserve(totalSize + footerSize);
+		index.reserve(records.size() * entrySize);
+
+		// The records, each encrypted on its own so any of them can be decrypted alone.
+		for (auto const& record : records)
+		{
+			appendInteger<uint64_t>(index, blob.size());
+			appendInteger<uint64_t>(index, record.value.size());
+			appendInteger<uint32_t>(index, static_cast<uint32_t>(record.key.size()));
+
+			size_t const recordOffset{ blob.size() };
+			blob.append(record.value);
+			if (encrypt)
+				store.cipher(blob.data() + recordOffset, record.value.size());
+		}
+
+		// The keys follow the entries of the offset table.
+		for (auto const& record : records)
+			index.append(record.key);
+
+		if (encrypt)
+			store.cipher(index.data(), index.size());
+
+		uint64_t const indexOffset{ blob.size() };
+		blob.append(index);
+
+		std::string footer{};
+		appendInteger<uint32_t>(footer, magicNumber);
+		appendInteger<uint16_t>(footer, formatVersion);
+		appendInteger<uint8_t>(footer, (encrypt) ? 1 : 0);
+		appendInteger<uint8_t>(footer, 0); // Reserved.
+		appendInteger<uint64_t>(footer, records.size());
+		appendInteger<uint64_t>(footer, indexOffset);
+		appendInteger<uint64_t>(footer, index.size());
+		appendInteger<uint32_t>(footer, crc32(index));
+		appendInteger<uint32_t>(footer, crc32(footer));
+		blob.append(footer);
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: impossible to build the indexed save " << fileName << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	// The durability is handled by the store: the blob is already encrypted where it needs to be.
+	return store.writingBlob(fileName, blob, false);
+}
+
+std::optional<std::string> IndexedSave::open(std::string const& fileName) noexcept
+{
+	close();
+
+	m_path = m_store->m_root.pathOf(fileName);
+	std::ostringstream errorMessage{};
+
+	try
+	{
+		m_store->cleanUpFiles(fileName);
+		m_file.create(m_path, std::ios::in | std::ios::binary);
+		std::ifstream* stream{ m_file.stream().value() };
+
+		// Footer: located right before the tokens of confirmation.
+		stream->seekg(0, std::ios::end);
+		std::streamoff const fileSize{ stream->tellg() };
+		std::streamoff const footerOffset{ fileSize - static_cast<std::streamoff>(SaveStore::tokensOfConfirmation.size() + footerSize) };
+		if (footerOffset < 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "The file is too small to be an indexed save: " + m_path };
+
+		std::string footer(footerSize, '\0');
+		stream->seekg(footerOffset);
+		stream->read(footer.data(), footerSize);
+
+		if (stream->fail()
+		||  readInteger<uint32_t>(footer, 0) != magicNumber
+		||  readInteger<uint16_t>(footer, 4) != formatVersion
+		||  readInteger<uint32_t>(footer, footerSize - 4) != crc32(std::string_view{ footer }.substr(0, footerSize - 4))) [[unlikely]]
+			throw FileFailureWhileInUse{ "The footer of the indexed save is corrupted: " + m_path };
+
+		bool const encrypted{ readInteger<uint8_t>(footer, 6) == 1 };
+		uint64_t const recordCount{ readInteger<uint64_t>(footer, 8) };
+		uint64_t const indexOffset{ readInteger<uint64_t>(footer, 16) };
+		uint64_t const indexSize{ readInteger<uint64_t>(footer, 24) };
+		uint32_t const indexChecksum{ readInteger<uint32_t>(footer, 32) };
+
+		if (indexOffset + indexSize != static_cast<uint64_t>(footerOffset) || recordCount > indexSize / entrySize) [[unlikely]]
+			throw FileFailureWhileInUse{ "The footer of the indexed save is inconsistent: " + m_path };
+
+		// Offset table: validated before being trusted.
+		std::string index(indexSize, '\0');
+		stream->seekg(static_cast<std::streamoff>(indexOffset));
+		stream->read(index.data(), static_cast<std::streamsize>(indexSize));
+
+		if (stream->fail() || crc32(index) != indexChecksum) [[unlikely]]
+			throw FileFailureWhileInUse{ "The offset table of the indexed save is corrupted: " + m_path };
+
+		if (encrypted)
+			m_store->cipher(index.data(), index.size());
+
+		m_entries.reserve(recordCount);
+		m_keyIndex.reserve(recordCount);
+		size_t keyOffset{ recordCount * entrySize };
+
+		for (size_t i{ 0 }; i < recordCount; ++i)
+		{
+			Entry const entry{ readInteger<uint64_t>(index, i * entrySize), readInteger<uint64_t>(index, i * entrySize + 8) };
+			size_t const keySize{ readInteger<uint32_t>(index, i * entrySize + 16) };
+
+			if (entry.offset + entry.size > indexOffset || keyOffset + keySize > index.size()) [[unlikely]]
+				throw FileFailureWhileInUse{ "The offset table of the indexed save is inconsistent: " + m_path };
+
+			if (keySize != 0)
+				m_keyIndex.emplace(index.substr(keyOffset, keySize), i); // Does nothing if the key is already there.
+
+			m_entries.push_back(entry);
+			keyOffset += keySize;
+		}
+
+		m_encrypted = encrypted;
+	}
+	catch (FileFailureWhileOpening const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Fatal error: impossible to read the values" << "\n\n";
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the file is corrupted abd further saves are unavailable\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	if (!errorMessage.str().empty()) [[unlikely]]
+		close();
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> IndexedSave::readRecord(size_t index, std::string& value) noexcept
+{
+	std::ostringstream errorMessage{};
+
+	if (!m_file.stream().has_value() || index >= m_entries.size()) [[unlikely]]
+	{
+		errorMessage << "Error: the record " << index << " does not exist in " << m_path << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	std::ifstream* stream{ m_file.stream().value() };
+	Entry const& entry{ m_entries[index] };
+
+	try
+	{
+		std::string temp(entry.size, '\0');
+		stream->seekg(static_cast<std::streamoff>(entry.offset));
+		stream->read(temp.data(), static_cast<std::streamsize>(entry.size));
+
+		if (stream->fail()) [[unlikely]]
+		{
+			stream->clear(); // Other records may still be readable.
+			throw FileFailureWhileInUse{ "Error reading from the file: " + m_path };
+		}
+
+		if (m_encrypted)
+			m_store->cipher(temp.data(), temp.size());
+
+		value = std::move(temp);
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the file is corrupted abd further saves are unavailable\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+std::optional<std::string> IndexedSave::readRange(size_t first, std::vector<std::string>& values) noexcept
+{
+	for (size_t i{ 0 }; i < values.size(); ++i)
+	{
+		auto error{ readRecord(first + i, values[i]) };
+		if (error.has_value()) [[unlikely]]
+			return error;
+	}
+
+	return std::nullopt;
+}
+
+std::optional<std::string> IndexedSave::readKey(std::string_view key, std::string& value) noexcept
+{
+	std::optional<size_t> const index{ findKey(key) };
+
+	if (!index.has_value()) [[unlikely]]
+	{
+		std::ostringstream errorMessage{};
+		errorMessage << "Error: the key " << key << " does not exist in " << m_path << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	return readRecord(index.value(), value);
+}
+
+std::optional<size_t> IndexedSave::findKey(std::string_view key) const noexcept
+{
+	try
+	{
+		auto const mapIterator{ m_keyIndex.find(std::string{ key }) };
+		return (mapIterator == m_keyIndex.end()) ? std::nullopt : std::make_optional(mapIterator->second);
+	}
+	catch (std::exception const&)
+	{	// Only std::bad_alloc is expected while building the key.
+		return std::nullopt;
+	}
+}
+
+void IndexedSave::close() noexcept
+{
+	m_file = ReadingStreamRAIIWrapper{};
+	m_encrypted = false;
+	m_entries.clear();
+	m_keyIndex.clear();
+}
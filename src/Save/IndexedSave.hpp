@@ -0,0 +1,194 @@
+/*******************************************************************
+ * @file IndexedSave.hpp
+ * @brief Declares a save format with an offset table, to read any record without reading the others.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef INDEXEDSAVE_HPP
+#define INDEXEDSAVE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "../Save.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief A record of an indexed save: a value, optionally reachable by a key.
+ */
+struct IndexedRecord
+{
+	std::string key; // Empty if the record can only be accessed by index.
+	std::string value; // Any bytes, including \n.
+};
+
+/**
+ * @brief Reads and writes saves with an offset table, so a single record can be loaded in O(1).
+ *
+ * The file is written in one go by writing() and contains, in order:
+ * - the records, each encrypted on its own;
+ * - the offset table (offset, size and key of each record), protected by a CRC-32;
+ * - a fixed-size footer locating the table, protected by its own CRC-32;
+ * - the tokens of confirmation, as for every file written by Save.
+ *
+ * An instance is a reader: open() loads and validates the table once, then any record or range
+ * can be read by index or by key with a single seek.
+ *
+ * @note Don't expect this class to be fast: it interacts with files. Only the records you read are
+ *		 loaded though.
+ * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ * @warning Do not write a file while an instance has it opened.
+ *
+ * @see Save, IndexedRecord.
+ *
+ * @code
+ * std::vector<SafeSaves::IndexedRecord> profiles{ { "alice", "..." }, { "bob", "..." } };
+ * auto error{ SafeSaves::IndexedSave::writing("profiles.idx", profiles) };
+ *
+ * SafeSaves::IndexedSave reader{};
+ * std::string bob{};
+ * if (!reader.open("profiles.idx") && !reader.readKey("bob", bob))
+ *     use(bob);
+ * @endcode
+ */
+class IndexedSave
+{
+public:
+
+	/**
+	 * @brief Creates a reader with no file opened.
+	 * @complexity O(1).
+	 *
+	 * @param[in] store: The store of the files to open. It must outlive the reader.
+	 */
+	explicit IndexedSave(SaveStore& store = Save::store()) noexcept;
+
+	IndexedSave(IndexedSave const&) = delete;
+	IndexedSave(IndexedSave&&) noexcept = default;
+	IndexedSave& operator=(IndexedSave const&) = delete;
+	IndexedSave& operator=(IndexedSave&&) noexcept = default;
+	~IndexedSave() noexcept = default;
+
+
+	/**
+	 * @brief Writes records and their offset table into a file.
+	 * @complexity O(N) where N is the total size of the records.
+	 *
+	 * @param[in] fileName: The name of the file, created with Save::createFile().
+	 * @param[in] records: The records to save, in order.
+	 * @param[in] encrypt: True if the records need to be encrypted.
+	 * @param[in] store: The store of the file.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @note If several records share a key, readKey() returns the first one.
+	 *
+	 * @see open(), SaveStore::writingBlob().
+	 */
+	[[nodiscard]] static std::optional<std::string> writing(std::string const& fileName, std::vector<IndexedRecord> const& records, bool encrypt = true, SaveStore& store = Save::store()) noexcept;
+
+	/**
+	 * @brief Opens a file written by writing() and loads its offset table.
+	 * @complexity O(M) where M is the size of the offset table (not of the records).
+	 *
+	 * @param[in] fileName: The name of the file.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @note A previously opened file is closed, even if the opening fails.
+	 */
+	[[nodiscard]] std::optional<std::string> open(std::string const& fileName) noexcept;
+
+	/**
+	 * @brief Reads a single record.
+	 * @complexity O(S) where S is the size of the record.
+	 *
+	 * @param[in] index: The index of the record.
+	 * @param[out] value: Where the record is loaded.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] std::optional<std::string> readRecord(size_t index, std::string& value) noexcept;
+
+	/**
+	 * @brief Reads consecutive records.
+	 * @details Reads as many records as the number of string instantiated in the vector, beginning
+	 *			with the record `first`, like Save::reading() does with lines.
+	 * @complexity O(S) where S is the total size of the records read.
+	 *
+	 * @param[in] first: The index of the first record to read.
+	 * @param[out] values: The vector in which the records will be stored in.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] std::optional<std::string> readRange(size_t first, std::vector<std::string>& values) noexcept;
+
+	/**
+	 * @brief Reads the record associated with a key.
+	 * @complexity O(S) where S is the size of the record.
+	 *
+	 * @param[in] key: The key of the record.
+	 * @param[out] value: Where the record is loaded.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] std::optional<std::string> readKey(std::string_view key, std::string& value) noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] key: The key of a record.
+	 *
+	 * @return The index of the record, or std::nullopt if no record has this key.
+	 */
+	[[nodiscard]] std::optional<size_t> findKey(std::string_view key) const noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of records in the opened file, 0 if none is opened.
+	 */
+	[[nodiscard]] inline size_t size() const noexcept { return m_entries.size(); }
+
+private:
+
+	/// Where a record is located in the file.
+	struct Entry
+	{
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	/**
+	 * @brief Resets the reader as if nothing was opened.
+	 */
+	void close() noexcept;
+
+
+	SaveStore* m_store; // Never nullptr.
+	ReadingStreamRAIIWrapper m_file; // Kept opened between reads.
+	std::string m_path; // For error messages.
+	bool m_encrypted; // True if the records are encrypted.
+
+	std::vector<Entry> m_entries; // The offset table.
+	std::unordered_map<std::string, size_t> m_keyIndex; // Key -> index of the record.
+
+
+	static constexpr uint32_t magicNumber{ 0x58495353 }; // "SSIX" in little endian.
+	static constexpr uint16_t formatVersion{ 1 };
+	static constexpr size_t footerSize{ 40 }; // Bytes between the offset table and the tokens.
+	static constexpr size_t entrySize{ 20 }; // Bytes of each entry in the offset table.
+};
+} // namespace SafeSaves
+
+#endif //INDEXEDSAVE_HPP
@@ -0,0 +1,264 @@
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include "IoBackend.hpp"
+#include "FileSync.hpp"
+#include "IoUringBackend.hpp"
+#include "PosixBackend.hpp"
+#include "../Exceptions.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace SafeSaves;
+
+
+namespace
+{
+/// A file of the StreamBackend.
+class StreamFile final : public IoFile
+{
+public:
+
+	StreamFile(std::string const& path, std::ios::openmode mode)
+		: m_path{ path }, m_stream{ path, mode }
+	{
+		if (!m_stream.is_open()) [[unlikely]]
+			throw FileFailureWhileOpening{ "Unable to open the file, unknow reasons: " + path };
+	}
+
+	~StreamFile() noexcept
+	{
+		if (m_stream.is_open())
+			m_stream.close();
+	}
+
+	size_t write(std::string_view data) override
+	{
+		m_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+		if (m_stream.fail()) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error writing into the file: " + m_path };
+
+		return data.size();
+	}
+
+	void flush() override
+	{
+		m_stream.flush();
+
+		if (m_stream.fail()) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error writing into the file: " + m_path };
+	}
+
+	void sync() override
+	{
+		flush();
+		FileSync::barrier({ m_path }); // A stream has no descriptor to flush: its path is used instead.
+	}
+
+	void close() override
+	{
+		m_stream.close();
+
+		if (m_stream.fail()) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error writing into the file: " + m_path };
+	}
+
+private:
+
+	std::string m_path;
+	std::ofstream m_stream;
+};
+
+/// A file of the StreamBackend, opened for reading.
+class StreamReadFile final : public IoReadFile
+{
+public:
+
+	explicit StreamReadFile(std::string const& path)
+		: m_path{ path }, m_stream{ path, std::ios::in | std::ios::binary | std::ios::ate }, m_size{ 0 }
+	{
+		if (!m_stream.is_open()) [[unlikely]]
+			throw FileFailureWhileOpening{ "Unable to open the file, unknow reasons: " + path };
+
+		m_size = static_cast<uint64_t>(m_stream.tellg());
+	}
+
+	uint64_t size() const noexcept override
+	{
+		return m_size;
+	}
+
+	size_t readAt(char* output, size_t count, uint64_t offset) override
+	{
+		if (offset >= m_size)
+			return 0;
+
+		m_stream.clear();
+		m_stream.seekg(static_cast<std::streamoff>(offset));
+		m_stream.read(output, static_cast<std::streamsize>(count));
+
+		if (m_stream.bad()) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error reading the file: " + m_path };
+
+		return static_cast<size_t>(m_stream.gcount());
+	}
+
+private:
+
+	std::string m_path;
+	std::ifstream m_stream;
+	uint64_t m_size;
+};
+
+/// A batch completed before being returned: only its error is left.
+class CompletedBatch final : public IoBatch
+{
+public:
+
+	explicit CompletedBatch(std::exception_ptr error) noexcept
+		: m_error{ std::move(error) }
+	{}
+
+	void wait() override
+	{
+		if (m_error != nullptr) [[unlikely]]
+			std::rethrow_exception(std::exchange(m_error, nullptr));
+	}
+
+private:
+
+	std::exception_ptr m_error; // nullptr if every write succeeded.
+};
+} // namespace
+
+
+IoDirectory::IoDirectory(std::string path)
+	: m_path{ std::move(path) }, m_descriptor{ -1 }
+{
+	if (!m_path.empty() && m_path.back() != '/' && m_path.back() != '\\')
+		m_path.push_back('/');
+
+	std::error_code alreadyThere{};
+	std::filesystem::create_directories(m_path, alreadyThere);
+
+#ifndef _WIN32
+	m_descriptor = ::open((m_path.empty()) ? "." : m_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+#endif
+}
+
+IoDirectory::~IoDirectory() noexcept
+{
+#ifndef _WIN32
+	if (m_descriptor >= 0)
+		::close(m_descriptor);
+#endif
+}
+
+
+std::unique_ptr<IoBatch> IoBackend::submit(IoDirectory const& directory, std::vector<IoWrite> const& writes)
+{
+	std::exception_ptr firstError{};
+
+	for (auto const& write : writes)
+	{
+		std::unique_ptr<IoFile> file{ create(directory, write.name) };
+
+		try
+		{
+			writeWhole(*file, write.content, write.name);
+
+			if (write.sync)
+				file->sync();
+
+			file->close();
+		}
+		catch (FileFailureWhileInUse const&)
+		{	// The other files are still written, as an asynchronous batch would.
+			if (firstError == nullptr)
+				firstError = std::current_exception();
+		}
+	}
+
+	return std::make_unique<CompletedBatch>(std::move(firstError));
+}
+
+
+std::unique_ptr<IoFile> StreamBackend::create(IoDirectory const& directory, std::string const& name)
+{
+	return std::make_unique<StreamFile>(directory.pathOf(name), std::ios::out | std::ios::trunc | std::ios::binary); // Streams only accept paths.
+}
+
+std::unique_ptr<IoFile> StreamBackend::append(IoDirectory const& directory, std::string const& name, uint64_t size)
+{
+	std::error_code error{};
+	std::filesystem::resize_file(directory.pathOf(name), size, error);
+
+	if (error) [[unlikely]]
+		throw FileFailureWhileOpening{ "Unable to open the file, unknow reasons: " + directory.pathOf(name) };
+
+	return std::make_unique<StreamFile>(directory.pathOf(name), std::ios::out | std::ios::app | std::ios::binary);
+}
+
+std::unique_ptr<IoReadFile> StreamBackend::open(IoDirectory const& directory, std::string const& name)
+{
+	return std::make_unique<StreamReadFile>(directory.pathOf(name));
+}
+
+void StreamBackend::rename(IoDirectory const& directory, std::string const& from, std::string const& to)
+{
+	std::error_code error{};
+	std::filesystem::rename(directory.pathOf(from), directory.pathOf(to), error);
+
+	if (error) [[unlikely]]
+		throw FileFailureWhileInUse{ "Unable to replace the file: " + directory.pathOf(to) };
+}
+
+void StreamBackend::remove(IoDirectory const& directory, std::string const& name) noexcept
+{
+	std::error_code noFile{};
+	std::filesystem::remove(directory.pathOf(name), noFile);
+}
+
+void SafeSaves::writeWhole(IoFile& file, std::string_view data, std::string const& name)
+{
+	while (!data.empty())
+	{
+		size_t const written{ file.write(data) };
+		if (written == 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error writing into the file: " + name };
+
+		data.remove_prefix(written);
+	}
+}
+
+std::unique_ptr<IoBackend> SafeSaves::makeIoBackend(IoBackendKind kind)
+{
+	switch (kind)
+	{
+	case IoBackendKind::Streams:
+		return std::make_unique<StreamBackend>();
+
+#ifndef _WIN32
+	case IoBackendKind::Posix:
+		return std::make_unique<PosixBackend>();
+#endif
+
+#ifdef __linux__
+	case IoBackendKind::IoUring:
+		return IoUringBackend::make();
+#endif
+
+	default:
+		return nullptr;
+	}
+}
@@ -0,0 +1,399 @@
+/*******************************************************************
+ * @file IoBackend.hpp
+ * @brief Declares the interface through which Save reaches the file system, and its default implementation.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef IOBACKEND_HPP
+#define IOBACKEND_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief A directory kept open, so its files are reached relatively to it.
+ *
+ * On POSIX systems, the directory is opened once: the backends then use openat(), renameat(),
+ * unlinkat() and fstatat() with the name of each file. The system does not resolve the whole
+ * path again at each call, and no path is built from the root and the name.
+ *
+ * @note If the directory cannot be opened (or on Windows), every file is reached through its
+ *		 full path instead: see pathOf().
+ * @note The directory must not be moved nor replaced while it is open.
+ *
+ * @see IoBackend, SaveStore.
+ */
+class IoDirectory
+{
+public:
+
+	/**
+	 * @brief Opens a directory, after creating it if needed.
+	 * @complexity O(1).
+	 *
+	 * @param[in] path: The path to the directory. A trailing '/' is added if missing.
+	 */
+	explicit IoDirectory(std::string path);
+
+	/**
+	 * @brief Closes the directory.
+	 * @complexity O(1).
+	 */
+	~IoDirectory() noexcept;
+
+	IoDirectory(IoDirectory const&) = delete;
+	IoDirectory(IoDirectory&&) = delete;
+	IoDirectory& operator=(IoDirectory const&) = delete;
+	IoDirectory& operator=(IoDirectory&&) = delete;
+
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The path to the directory, ending with '/'.
+	 */
+	[[nodiscard]] inline std::string const& path() const noexcept { return m_path; }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The descriptor of the directory, or -1 if it is not open.
+	 */
+	[[nodiscard]] inline int descriptor() const noexcept { return m_descriptor; }
+
+	/**
+	 * @complexity O(N) where N is the length of the path.
+	 *
+	 * @param[in] name: The name of a file, relative to the directory.
+	 *
+	 * @return The full path to the file, for the functions that only accept paths.
+	 */
+	[[nodiscard]] inline std::string pathOf(std::string_view name) const { return m_path + std::string{ name }; }
+
+private:
+
+	std::string m_path;
+	int m_descriptor; // -1 if the files are reached through their full path.
+};
+
+/**
+ * @brief A file opened for writing by an IoBackend.
+ *
+ * @note The file is closed by the destructor if close() has not been called, ignoring errors.
+ *
+ * @see IoBackend.
+ */
+class IoFile
+{
+public:
+
+	IoFile() noexcept = default;
+	IoFile(IoFile const&) = delete;
+	IoFile(IoFile&&) = delete;
+	IoFile& operator=(IoFile const&) = delete;
+	IoFile& operator=(IoFile&&) = delete;
+	virtual ~IoFile() noexcept = default;
+
+
+	/**
+	 * @brief Writes data at the end of the file.
+	 * @complexity O(N) where N is the size of the data.
+	 *
+	 * @param[in] data: The data to write.
+	 *
+	 * @return The number of bytes written, which may be less than the size of the data (short
+	 *		   write). 0 only if nothing could be written.
+	 *
+	 * @throw FileFailureWhileInUse if the system reports an error (e.g. no space left).
+	 */
+	[[nodiscard]] virtual size_t write(std::string_view data) = 0;
+
+	/**
+	 * @brief Hands what was written to the system, without waiting for the disk.
+	 * @complexity O(N) where N is the size of the data not yet handed to the system.
+	 *
+	 * @note The data then survives a crash of the process, but not a power loss: see sync().
+	 *
+	 * @throw FileFailureWhileInUse if the system reports an error.
+	 */
+	virtual void flush() = 0;
+
+	/**
+	 * @brief Waits until what was written is on the disk, not only in the cache of the system.
+	 * @complexity O(N) where N is the size of the data not yet on the disk.
+	 *
+	 * @throw FileFailureWhileInUse if the system reports an error.
+	 */
+	virtual void sync() = 0;
+
+	/**
+	 * @brief Closes the file, handing what was written to the system.
+	 * @complexity O(1).
+	 *
+	 * @throw FileFailureWhileInUse if the last writes failed.
+	 */
+	virtual void close() = 0;
+};
+
+/**
+ * @brief A file opened for reading by an IoBackend.
+ *
+ * @see IoBackend::open().
+ */
+class IoReadFile
+{
+public:
+
+	IoReadFile() noexcept = default;
+	IoReadFile(IoReadFile const&) = delete;
+	IoReadFile(IoReadFile&&) = delete;
+	IoReadFile& operator=(IoReadFile const&) = delete;
+	IoReadFile& operator=(IoReadFile&&) = delete;
+	virtual ~IoReadFile() noexcept = default;
+
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The size of the file when it was opened.
+	 */
+	[[nodiscard]] virtual uint64_t size() const noexcept = 0;
+
+	/**
+	 * @brief Reads from a given position, without moving any cursor (as pread).
+	 * @complexity O(N) where N is the number of bytes to read.
+	 *
+	 * @param[out] output: Where the bytes are copied.
+	 * @param[in] count: The number of bytes to read.
+	 * @param[in] offset: The position of the first byte to read.
+	 *
+	 * @return The number of bytes read, less than count only at the end of the file.
+	 *
+	 * @throw FileFailureWhileInUse if the system reports an error.
+	 */
+	[[nodiscard]] virtual size_t readAt(char* output, size_t count, uint64_t offset) = 0;
+};
+
+/**
+ * @brief A whole file to write as part of a batch.
+ *
+ * @see IoBackend::submit().
+ */
+struct IoWrite
+{
+	std::string name; // Relative to the directory of the batch. Created, or emptied if it exists.
+	std::string_view content; // Must stay valid until the batch is completed.
+	bool sync{ false }; // True to wait until the content is on the disk.
+};
+
+/**
+ * @brief Writes submitted together, which complete in the background.
+ *
+ * @note The batch must be waited for before being destroyed: the destructor waits otherwise,
+ *		 ignoring errors.
+ *
+ * @see IoBackend::submit().
+ */
+class IoBatch
+{
+public:
+
+	IoBatch() noexcept = default;
+	IoBatch(IoBatch const&) = delete;
+	IoBatch(IoBatch&&) = delete;
+	IoBatch& operator=(IoBatch const&) = delete;
+	IoBatch& operator=(IoBatch&&) = delete;
+	virtual ~IoBatch() noexcept = default;
+
+
+	/**
+	 * @brief Waits until every write of the batch is completed, and closes the files.
+	 * @complexity O(N) where N is the number of writes.
+	 *
+	 * @throw FileFailureWhileInUse with the first error met, once every write is completed.
+	 */
+	virtual void wait() = 0;
+};
+
+/**
+ * @brief The file system operations Save relies on to write a file safely.
+ *
+ * Save writes every file through the backend set with Save::setIoBackend(): replacing it allows
+ * to count, delay or break these operations, e.g. with FaultInjectionBackend, or to change how
+ * they reach the system, e.g. with IoUringBackend.
+ *
+ * @see Save::setIoBackend(), makeIoBackend(), StreamBackend, PosixBackend, IoUringBackend, FaultInjectionBackend.
+ */
+class IoBackend
+{
+public:
+
+	IoBackend() noexcept = default;
+	IoBackend(IoBackend const&) = delete;
+	IoBackend(IoBackend&&) = delete;
+	IoBackend& operator=(IoBackend const&) = delete;
+	IoBackend& operator=(IoBackend&&) = delete;
+	virtual ~IoBackend() noexcept = default;
+
+
+	/**
+	 * @brief Creates a file, or empties it if it exists, and opens it for writing.
+	 * @complexity O(1).
+	 *
+	 * @param[in] directory: The directory of the file.
+	 * @param[in] name: The name of the file, relative to the directory.
+	 *
+	 * @return The file opened, never nullptr.
+	 *
+	 * @throw FileFailureWhileOpening if the file cannot be created.
+	 */
+	[[nodiscard]] virtual std::unique_ptr<IoFile> create(IoDirectory const& directory, std::string const& name) = 0;
+
+	/**
+	 * @brief Opens an existing file for writing after its first bytes, cutting the rest.
+	 * @complexity O(1).
+	 *
+	 * @param[in] directory: The directory of the file.
+	 * @param[in] name: The name of the file, relative to the directory.
+	 * @param[in] size: The bytes kept at the beginning of the file: the writes follow them.
+	 *
+	 * @return The file opened, never nullptr.
+	 *
+	 * @throw FileFailureWhileOpening if the file does not exist or cannot be opened.
+	 */
+	[[nodiscard]] virtual std::unique_ptr<IoFile> append(IoDirectory const& directory, std::string const& name, uint64_t size) = 0;
+
+	/**
+	 * @brief Opens an existing file for reading.
+	 * @complexity O(1).
+	 *
+	 * @param[in] directory: The directory of the file.
+	 * @param[in] name: The name of the file, relative to the directory.
+	 *
+	 * @return The file opened, never nullptr.
+	 *
+	 * @throw FileFailureWhileOpening if the file cannot be opened.
+	 */
+	[[nodiscard]] virtual std::unique_ptr<IoReadFile> open(IoDirectory const& directory, std::string const& name) = 0;
+
+	/**
+	 * @brief Writes several whole files at once.
+	 * @details By default, the files are written one after the other before returning, through
+	 *			create(). A backend may submit them together and complete them in the background.
+	 * @complexity O(N) where N is the total size of the files.
+	 *
+	 * @param[in] directory: The directory of the files.
+	 * @param[in] writes: The files to write. Their content must stay valid until the batch is completed.
+	 *
+	 * @return The batch, to wait for. Never nullptr.
+	 *
+	 * @throw FileFailureWhileOpening if a file cannot be created: the writes already submitted
+	 *		  are completed before.
+	 */
+	[[nodiscard]] virtual std::unique_ptr<IoBatch> submit(IoDirectory const& directory, std::vector<IoWrite> const& writes);
+
+	/**
+	 * @brief Renames a file, replacing the destination in a single atomic step.
+	 * @complexity O(1).
+	 *
+	 * @param[in] directory: The directory of both files.
+	 * @param[in] from: The name of the file.
+	 * @param[in] to: Its new name.
+	 *
+	 * @throw FileFailureWhileInUse if the file cannot be renamed.
+	 */
+	virtual void rename(IoDirectory const& directory, std::string const& from, std::string const& to) = 0;
+
+	/**
+	 * @brief Removes a file, if it exists.
+	 * @complexity O(1).
+	 *
+	 * @param[in] directory: The directory of the file.
+	 * @param[in] name: The name of the file, relative to the directory.
+	 */
+	virtual void remove(IoDirectory const& directory, std::string const& name) noexcept = 0;
+};
+
+/**
+ * @brief The default backend: buffered std::fstream and std::filesystem.
+ */
+class StreamBackend final : public IoBackend
+{
+public:
+
+	StreamBackend() noexcept = default;
+	~StreamBackend() noexcept = default;
+
+
+	/// @see IoBackend::create().
+	[[nodiscard]] std::unique_ptr<IoFile> create(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::append().
+	[[nodiscard]] std::unique_ptr<IoFile> append(IoDirectory const& directory, std::string const& name, uint64_t size) override;
+
+	/// @see IoBackend::open().
+	[[nodiscard]] std::unique_ptr<IoReadFile> open(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::rename().
+	void rename(IoDirectory const& directory, std::string const& from, std::string const& to) override;
+
+	/// @see IoBackend::remove().
+	void remove(IoDirectory const& directory, std::string const& name) noexcept override;
+};
+
+/**
+ * @brief Writes the whole data, as many times as needed in case of short writes.
+ * @complexity O(N) where N is the size of the data.
+ *
+ * @param[out] file: The file to write into.
+ * @param[in] data: The data to write.
+ * @param[in] name: The name of the file, for the error message.
+ *
+ * @throw FileFailureWhileInUse if the file stops accepting data.
+ */
+void writeWhole(IoFile& file, std::string_view data, std::string const& name);
+
+/**
+ * @brief The backends that can be chosen at runtime.
+ *
+ * @see makeIoBackend().
+ */
+enum class IoBackendKind : uint8_t
+{
+	Streams, // StreamBackend: std::fstream, everywhere.
+	Posix, // PosixBackend: read/write with large aligned buffers, not on Windows.
+	IoUring // IoUringBackend: batches submitted with a single system call, Linux only.
+};
+
+/**
+ * @brief Creates a backend of a given kind.
+ * @complexity O(1).
+ *
+ * @param[in] kind: The kind of backend.
+ *
+ * @return The backend, or nullptr if it is not supported by this system.
+ *
+ * @code
+ * std::unique_ptr<SafeSaves::IoBackend> backend{ SafeSaves::makeIoBackend(SafeSaves::IoBackendKind::IoUring) };
+ * if (backend == nullptr)
+ *     backend = SafeSaves::makeIoBackend(SafeSaves::IoBackendKind::Posix);
+ *
+ * SafeSaves::Save::setIoBackend(backend.get()); // The backend must outlive its use.
+ * @endcode
+ */
+[[nodiscard]] std::unique_ptr<IoBackend> makeIoBackend(IoBackendKind kind);
+} // namespace SafeSaves
+
+#endif //IOBACKEND_HPP
@@ -0,0 +1,417 @@
+#ifdef __linux__
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "IoUringBackend.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+
+struct IoUringBackend::Ring
+{
+	~Ring() noexcept
+	{
+		if (sqes != MAP_FAILED)
+			::munmap(sqes, sqesSize);
+		if (cqMapping != MAP_FAILED && cqMapping != sqMapping)
+			::munmap(cqMapping, cqMappingSize);
+		if (sqMapping != MAP_FAILED)
+			::munmap(sqMapping, sqMappingSize);
+		if (descriptor >= 0)
+			::close(descriptor);
+	}
+
+	int descriptor{ -1 };
+
+	void* sqMapping{ MAP_FAILED };
+	size_t sqMappingSize{ 0 };
+	void* cqMapping{ MAP_FAILED }; // The same as sqMapping if the kernel maps both rings at once.
+	size_t cqMappingSize{ 0 };
+	io_uring_sqe* sqes{ static_cast<io_uring_sqe*>(MAP_FAILED) };
+	size_t sqesSize{ 0 };
+
+	unsigned* sqHead{ nullptr }; // Written by the kernel.
+	unsigned* sqTail{ nullptr };
+	unsigned* sqArray{ nullptr };
+	unsigned sqMask{ 0 };
+	unsigned sqEntries{ 0 };
+
+	unsigned* cqHead{ nullptr };
+	unsigned* cqTail{ nullptr }; // Written by the kernel.
+	io_uring_cqe* cqes{ nullptr };
+	unsigned cqMask{ 0 };
+	unsigned cqEntries{ 0 };
+};
+
+struct IoUringBackend::Operation
+{
+	std::string path; // The name of the file, for the error messages.
+	std::string_view content;
+	bool sync{ false };
+	int descriptor{ -1 };
+
+	uint64_t written{ 0 }; // By the kernel.
+	int writeError{ 0 }; // errno of the write, 0 if it succeeded.
+	int syncError{ 0 }; // errno of the flush, 0 if it succeeded.
+	unsigned pending{ 0 }; // Operations submitted, not completed yet.
+};
+
+
+namespace
+{
+constexpr uint64_t syncFlag{ 1 }; // The low bit of the user data: the operations are aligned.
+constexpr size_t largestWrite{ 1 << 30 }; // The length of an operation is 32 bits: the rest is written afterwards.
+
+int ioUringSetup(unsigned entries, io_uring_params* parameters) noexcept
+{
+	return static_cast<int>(::syscall(__NR_io_uring_setup, entries, parameters));
+}
+
+int ioUringEnter(int ring, unsigned toSubmit, unsigned minimumCompletions, unsigned flags) noexcept
+{
+	return static_cast<int>(::syscall(__NR_io_uring_enter, ring, toSubmit, minimumCompletions, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ring, unsigned opcode, void* argument, unsigned count) noexcept
+{
+	return static_cast<int>(::syscall(__NR_io_uring_register, ring, opcode, argument, count));
+}
+
+/// True if the kernel knows IORING_OP_WRITE and IORING_OP_FSYNC (Linux 5.6).
+bool supportsWrites(int ring) noexcept
+{
+	constexpr unsigned operationCount{ 256 };
+	std::vector<unsigned char> memory(sizeof(io_uring_probe) + operationCount * sizeof(io_uring_probe_op), 0);
+	auto* probe{ reinterpret_cast<io_uring_probe*>(memory.data()) };
+
+	if (ioUringRegister(ring, IORING_REGISTER_PROBE, probe, operationCount) < 0 || probe->last_op < IORING_OP_WRITE)
+		return false;
+
+	return (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED) && (probe->ops[IORING_OP_FSYNC].flags & IO_URING_OP_SUPPORTED);
+}
+} // namespace
+
+
+class IoUringBackend::Batch final : public IoBatch
+{
+public:
+
+	explicit Batch(IoUringBackend& backend) noexcept
+		: m_backend{ backend }, m_operations{}, m_waited{ false }
+	{}
+
+	~Batch() noexcept
+	{
+		try
+		{
+			wait();
+		}
+		catch (...)
+		{}
+
+		if (!m_waited) [[unlikely]]
+		{	// The kernel may still hold them, and write into their files: leaked rather than freed.
+			for (auto& operation : m_operations)
+				static_cast<void>(operation.release());
+		}
+	}
+
+	void wait() override
+	{
+		if (m_waited)
+			return;
+
+		auto const isPending = [](std::unique_ptr<Operation> const& operation) { return operation->pending > 0; };
+
+		{
+			std::unique_lock lock{ m_backend.m_mutex };
+
+			// Whoever collects a completion updates its operation, whatever its batch.
+			while (std::any_of(m_operations.begin(), m_operations.end(), isPending))
+				if (m_backend.reap() == 0)
+					m_backend.enter(1); // If it throws, the operations are still pending: waited for again.
+		}
+
+		// Only now: the kernel is done with every operation and its buffer.
+		m_waited = true;
+		std::exception_ptr firstError{};
+
+		for (auto& operation : m_operations)
+		{
+			try
+			{
+				finish(*operation);
+			}
+			catch (FileFailureWhileInUse const&)
+			{
+				if (firstError == nullptr)
+					firstError = std::current_exception();
+			}
+		}
+
+		if (firstError != nullptr) [[unlikely]]
+			std::rethrow_exception(firstError);
+	}
+
+	std::vector<std::unique_ptr<Operation>>& operations() noexcept
+	{
+		return m_operations;
+	}
+
+private:
+
+	/// Completes what the kernel left (short write, cancelled flush), then closes the file.
+	static void finish(Operation& operation)
+	{
+		int const descriptor{ std::exchange(operation.descriptor, -1) };
+		if (descriptor < 0)
+			return;
+
+		try
+		{
+			if (operation.writeError != 0) [[unlikely]]
+				throw FileFailureWhileInUse{ "Error writing into the file: " + operation.path };
+
+			if (operation.written < operation.content.size())
+			{	// The linked flush has been cancelled.
+				pwriteWhole(descriptor, operation.content.data() + operation.written, operation.content.size() - operation.written, operation.written, operation.path);
+
+				if (operation.sync)
+					syncDescriptor(descriptor, operation.path);
+			}
+			else if (operation.sync && operation.syncError != 0) [[unlikely]]
+				throw FileFailureWhileInUse{ "Unable to flush the file: " + operation.path };
+		}
+		catch (...)
+		{
+			::close(descriptor);
+			throw;
+		}
+
+		if (::close(descriptor) != 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error writing into the file: " + operation.path };
+	}
+
+
+	IoUringBackend& m_backend;
+	std::vector<std::unique_ptr<Operation>> m_operations; // Never moved: the kernel gives their address back.
+	bool m_waited; // True once the kernel has completed every operation.
+};
+
+
+std::unique_ptr<IoUringBackend> IoUringBackend::make()
+{
+	auto ring{ std::make_unique<Ring>() };
+
+	io_uring_params parameters{};
+	ring->descriptor = ioUringSetup(ringEntries, &parameters);
+	if (ring->descriptor < 0 || !supportsWrites(ring->descriptor))
+		return nullptr;
+
+	ring->sqMappingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned);
+	ring->cqMappingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+	bool const singleMapping{ (parameters.features & IORING_FEAT_SINGLE_MMAP) != 0 };
+
+	if (singleMapping)
+		ring->sqMappingSize = ring->cqMappingSize = std::max(ring->sqMappingSize, ring->cqMappingSize);
+
+	ring->sqMapping = ::mmap(nullptr, ring->sqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->descriptor, IORING_OFF_SQ_RING);
+	if (ring->sqMapping == MAP_FAILED)
+		return nullptr;
+
+	ring->cqMapping = (singleMapping) ? ring->sqMapping
+		: ::mmap(nullptr, ring->cqMappingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->descriptor, IORING_OFF_CQ_RING);
+	if (ring->cqMapping == MAP_FAILED)
+		return nullptr;
+
+	ring->sqesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+	ring->sqes = static_cast<io_uring_sqe*>(::mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->descriptor, IORING_OFF_SQES));
+	if (ring->sqes == MAP_FAILED)
+		return nullptr;
+
+	auto* const sq{ static_cast<char*>(ring->sqMapping) };
+	ring->sqHead = reinterpret_cast<unsigned*>(sq + parameters.sq_off.head);
+	ring->sqTail = reinterpret_cast<unsigned*>(sq + parameters.sq_off.tail);
+	ring->sqArray = reinterpret_cast<unsigned*>(sq + parameters.sq_off.array);
+	ring->sqMask = *reinterpret_cast<unsigned*>(sq + parameters.sq_off.ring_mask);
+	ring->sqEntries = parameters.sq_entries;
+
+	auto* const cq{ static_cast<char*>(ring->cqMapping) };
+	ring->cqHead = reinterpret_cast<unsigned*>(cq + parameters.cq_off.head);
+	ring->cqTail = reinterpret_cast<unsigned*>(cq + parameters.cq_off.tail);
+	ring->cqes = reinterpret_cast<io_uring_cqe*>(cq + parameters.cq_off.cqes);
+	ring->cqMask = *reinterpret_cast<unsigned*>(cq + parameters.cq_off.ring_mask);
+	ring->cqEntries = parameters.cq_entries;
+
+	return std::unique_ptr<IoUringBackend>{ new IoUringBackend{ std::move(ring) } };
+}
+
+IoUringBackend::IoUringBackend(std::unique_ptr<Ring> ring) noexcept
+	: m_posix{}, m_ring{ std::move(ring) }, m_mutex{}, m_queued{ 0 }, m_inFlight{ 0 }
+{}
+
+IoUringBackend::~IoUringBackend() noexcept = default;
+
+std::unique_ptr<IoFile> IoUringBackend::create(IoDirectory const& directory, std::string const& name)
+{
+	return m_posix.create(directory, name);
+}
+
+std::unique_ptr<IoFile> IoUringBackend::append(IoDirectory const& directory, std::string const& name, uint64_t size)
+{
+	return m_posix.append(directory, name, size);
+}
+
+std::unique_ptr<IoReadFile> IoUringBackend::open(IoDirectory const& directory, std::string const& name)
+{
+	return m_posix.open(directory, name);
+}
+
+std::unique_ptr<IoBatch> IoUringBackend::submit(IoDirectory const& directory, std::vector<IoWrite> const& writes)
+{
+	auto batch{ std::make_unique<Batch>(*this) };
+	auto& operations{ batch->operations() };
+	operations.reserve(writes.size());
+
+	// Every file is opened before anything is submitted: if one cannot be, nothing is written.
+	for (auto const& write : writes)
+	{
+		auto operation{ std::make_unique<Operation>() };
+		operation->path = write.name;
+		operation->content = write.content;
+		operation->sync = write.sync;
+		operation->descriptor = openInDirectory(directory, write.name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC);
+
+		if (operation->descriptor < 0) [[unlikely]]
+			throw FileFailureWhileOpening{ "Unable to open the file, unknow reasons: " + directory.pathOf(write.name) }; // The batch closes the others.
+
+		operations.push_back(std::move(operation));
+	}
+
+	std::unique_lock lock{ m_mutex };
+
+	for (auto& operation : operations)
+	{
+		reserve((operation->sync) ? 2 : 1); // A write and its flush are submitted together, or the link is lost.
+		queue(operation.get(), IORING_OP_WRITE, operation->sync);
+
+		if (operation->sync)
+			queue(operation.get(), IORING_OP_FSYNC, false);
+	}
+
+	enter(0); // The single system call of the batch.
+	return batch;
+}
+
+void IoUringBackend::rename(IoDirectory const& directory, std::string const& from, std::string const& to)
+{
+	m_posix.rename(directory, from, to);
+}
+
+void IoUringBackend::remove(IoDirectory const& directory, std::string const& name) noexcept
+{
+	m_posix.remove(directory, name);
+}
+
+void IoUringBackend::reserve(unsigned count)
+{
+	if (m_queued + count > m_ring->sqEntries)
+		enter(0);
+
+	// Every completion must find room in its ring.
+	while (m_queued + m_inFlight + count > m_ring->cqEntries)
+		if (reap() == 0)
+			enter(1);
+}
+
+void IoUringBackend::queue(Operation* operation, uint8_t opcode, bool linked) noexcept
+{
+	unsigned const tail{ *m_ring->sqTail }; // Only written here, under the lock.
+	unsigned const index{ tail & m_ring->sqMask };
+
+	io_uring_sqe& entry{ m_ring->sqes[index] };
+	std::memset(&entry, 0, sizeof(entry));
+	entry.opcode = opcode;
+	entry.fd = operation->descriptor;
+	entry.flags = (linked) ? IOSQE_IO_LINK : 0;
+	entry.user_data = reinterpret_cast<uintptr_t>(operation) | ((opcode == IORING_OP_FSYNC) ? syncFlag : 0);
+
+	if (opcode == IORING_OP_WRITE)
+	{
+		entry.addr = reinterpret_cast<uintptr_t>(operation->content.data());
+		entry.len = static_cast<uint32_t>(std::min(operation->content.size(), largestWrite));
+		entry.off = 0;
+	}
+
+	m_ring->sqArray[index] = index;
+	std::atomic_ref<unsigned>{ *m_ring->sqTail }.store(tail + 1, std::memory_order_release);
+
+	++m_queued;
+	++operation->pending;
+}
+
+void IoUringBackend::enter(unsigned minimumCompletions)
+{
+	while (true)
+	{
+		int const submitted{ ioUringEnter(m_ring->descriptor, m_queued, minimumCompletions, (minimumCompletions > 0) ? IORING_ENTER_GETEVENTS : 0) };
+		if (submitted < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY))
+		{
+			if (reap() > 0 && minimumCompletions > 0)
+				return;
+
+			continue;
+		}
+
+		if (submitted < 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "Unable to submit the writes to the kernel" };
+
+		m_queued -= static_cast<unsigned>(submitted);
+		m_inFlight += static_cast<unsigned>(submitted);
+		return;
+	}
+}
+
+unsigned IoUringBackend::reap() noexcept
+{
+	unsigned head{ *m_ring->cqHead }; // Only written here, under the lock.
+	unsigned const tail{ std::atomic_ref<unsigned>{ *m_ring->cqTail }.load(std::memory_order_acquire) };
+	unsigned collected{ 0 };
+
+	for (; head != tail; ++head, ++collected)
+	{
+		io_uring_cqe const& completion{ m_ring->cqes[head & m_ring->cqMask] };
+		auto* operation{ reinterpret_cast<Operation*>(static_cast<uintptr_t>(completion.user_data & ~syncFlag)) };
+
+		if (completion.user_data & syncFlag)
+			operation->syncError = (completion.res < 0) ? -completion.res : 0;
+		else if (completion.res < 0)
+			operation->writeError = -completion.res;
+		else
+			operation->written = static_cast<uint64_t>(completion.res);
+
+		--operation->pending;
+		--m_inFlight;
+	}
+
+	std::atomic_ref<unsigned>{ *m_ring->cqHead }.store(head, std::memory_order_release);
+	return collected;
+}
+
+#endif //__linux__
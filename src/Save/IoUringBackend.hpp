@@ -0,0 +1,151 @@
+/*******************************************************************
+ * @file IoUringBackend.hpp
+ * @brief Declares the backend submitting batches of writes through io_uring.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note Linux only (5.6 or later).
+ *********************************************************************/
+
+#ifndef IOURINGBACKEND_HPP
+#define IOURINGBACKEND_HPP
+
+#ifdef __linux__
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "IoBackend.hpp"
+#include "PosixBackend.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Submits a whole batch of writes with a single system call, and completes it in the background.
+ *
+ * Each file of a batch is opened, then its write and its flush (if asked) are queued in a ring
+ * shared with the kernel: one io_uring_enter() submits them all, and submit() returns while the
+ * kernel writes. IoBatch::wait() then collects the completions.
+ *
+ * The single files (create(), append(), open()) gain nothing from a ring: they go through a PosixBackend.
+ *
+ * @note Thread-safe: batches may be submitted and waited for from several threads.
+ * @note A batch of more than `ringEntries` operations needs one system call per `ringEntries` operations.
+ *
+ * @see IoBackend::submit(), makeIoBackend().
+ *
+ * @code
+ * std::unique_ptr<SafeSaves::IoBackend> ring{ SafeSaves::makeIoBackend(SafeSaves::IoBackendKind::IoUring) };
+ * auto batch{ ring->submit({ { "a.sav", a, true }, { "b.sav", b, true } }) }; // One system call.
+ * prepareTheNextFrame(); // The kernel writes meanwhile.
+ * batch->wait();
+ * @endcode
+ */
+class IoUringBackend final : public IoBackend
+{
+public:
+
+	/**
+	 * @brief Sets up a ring with the kernel.
+	 * @complexity O(1).
+	 *
+	 * @return The backend, or nullptr if the kernel does not support io_uring or forbids it (e.g.
+	 *		   in a container).
+	 */
+	[[nodiscard]] static std::unique_ptr<IoUringBackend> make();
+
+	/**
+	 * @brief Releases the ring.
+	 * @complexity O(1).
+	 *
+	 * @pre Every batch must have been waited for.
+	 */
+	~IoUringBackend() noexcept;
+
+
+	/// @see IoBackend::create().
+	[[nodiscard]] std::unique_ptr<IoFile> create(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::append().
+	[[nodiscard]] std::unique_ptr<IoFile> append(IoDirectory const& directory, std::string const& name, uint64_t size) override;
+
+	/// @see IoBackend::open().
+	[[nodiscard]] std::unique_ptr<IoReadFile> open(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::submit().
+	[[nodiscard]] std::unique_ptr<IoBatch> submit(IoDirectory const& directory, std::vector<IoWrite> const& writes) override;
+
+	/// @see IoBackend::rename().
+	void rename(IoDirectory const& directory, std::string const& from, std::string const& to) override;
+
+	/// @see IoBackend::remove().
+	void remove(IoDirectory const& directory, std::string const& name) noexcept override;
+
+
+	static constexpr unsigned ringEntries{ 256 }; // Operations queued before a system call is needed.
+
+private:
+
+	/// The memory shared with the kernel.
+	struct Ring;
+
+	/// A file of a batch: its write, and its flush.
+	struct Operation;
+
+	/// The batches returned by submit().
+	class Batch;
+
+	explicit IoUringBackend(std::unique_ptr<Ring> ring) noexcept;
+
+	/**
+	 * @brief Makes room for operations to queue, submitting the queue or collecting completions if needed.
+	 *
+	 * @pre m_mutex must be locked.
+	 */
+	void reserve(unsigned count);
+
+	/**
+	 * @brief Queues an operation, without submitting it.
+	 *
+	 * @param[in] linked: True if the next operation queued must wait for this one.
+	 *
+	 * @pre m_mutex must be locked, and reserve() called.
+	 */
+	void queue(Operation* operation, uint8_t opcode, bool linked) noexcept;
+
+	/**
+	 * @brief Submits the operations queued, and waits for some completions.
+	 *
+	 * @pre m_mutex must be locked.
+	 * @throw FileFailureWhileInUse if the kernel refuses the operations.
+	 */
+	void enter(unsigned minimumCompletions);
+
+	/**
+	 * @brief Collects the completions available, for any batch.
+	 *
+	 * @pre m_mutex must be locked.
+	 *
+	 * @return The number of completions collected.
+	 */
+	unsigned reap() noexcept;
+
+
+	PosixBackend m_posix;
+	std::unique_ptr<Ring> m_ring;
+	std::mutex m_mutex; // Protects the ring.
+	unsigned m_queued; // Operations queued but not submitted yet.
+	unsigned m_inFlight; // Operations submitted but not completed yet.
+};
+} // namespace SafeSaves
+
+#endif //__linux__
+
+#endif //IOURINGBACKEND_HPP
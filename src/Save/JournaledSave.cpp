@@ -0,0 +1,565 @@
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "JournaledSave.hpp"
+#include "BinaryUtils.hpp"
+#include "../Save.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+
+JournaledSave::JournaledSave(float compactionRatio, bool encrypt, SaveStore& store) noexcept
+	: m_mutex{}, m_compactionDone{}, m_compactor{}, m_store{ store }, m_fileName{}, m_journal{}, m_state{}, m_generation{ 0 }, m_journalSize{ 0 }, m_snapshotSize{ 0 }
+	, m_compacting{ false }, m_compactionError{}, m_compactionRatio{ std::max(compactionRatio, 0.f) }, m_encrypt{ encrypt }
+{}
+
+JournaledSave::~JournaledSave() noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	m_compactionDone.wait(lock, [this]() { return !m_compacting; });
+
+	if (m_compactor.joinable())
+		m_compactor.join();
+}
+
+std::optional<std::string> JournaledSave::open(std::string const& fileName) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	m_compactionDone.wait(lock, [this]() { return !m_compacting; });
+
+	if (m_compactor.joinable())
+		m_compactor.join();
+
+	m_journal.reset();
+	m_state.clear();
+	m_compactionError.reset();
+	m_fileName = fileName;
+
+	std::string const path{ m_store.m_root.pathOf(fileName) };
+	std::ostringstream errorMessage{};
+
+	try
+	{
+		if (!exists(fileName) && !exists(fileName + ".tmp"))
+		{
+			auto error{ m_store.createFile(fileName) };
+			if (error.has_value()) [[unlikely]]
+				throw FileFailureWhileOpening{ error.value() };
+		}
+
+		// The snapshot: empty if the file has just been created.
+		std::string snapshot{};
+		auto error{ m_store.readingBlob(fileName, snapshot, m_encrypt) };
+		if (error.has_value()) [[unlikely]]
+			throw FileFailureWhileOpening{ error.value() };
+
+		uint64_t snapshotGeneration{ 0 };
+		if (!snapshot.empty())
+		{
+			if (snapshot.size() < 24 || readInteger<uint32_t>(snapshot, 0) != snapshotMagicNumber
+			||  readInteger<uint32_t>(snapshot, snapshot.size() - 4) != crc32(std::string_view{ snapshot }.substr(0, snapshot.size() - 4))) [[unlikely]]
+				throw FileFailureWhileInUse{ "The snapshot of the journaled save is corrupted: " + path };
+
+			snapshotGeneration = readInteger<uint64_t>(snapshot, 4);
+			uint64_t const count{ readInteger<uint64_t>(snapshot, 12) };
+			size_t offset{ 20 };
+			size_t const end{ snapshot.size() - 4 };
+
+			m_state.reserve(count);
+			for (uint64_t i{ 0 }; i < count; ++i)
+			{
+				if (offset + 12 > end) [[unlikely]]
+					throw FileFailureWhileInUse{ "The snapshot of the journaled save is inconsistent: " + path };
+
+				uint64_t const keySize{ readInteger<uint32_t>(snapshot, offset) };
+				uint64_t const valueSize{ readInteger<uint64_t>(snapshot, offset + 4) };
+				offset += 12;
+
+				if (keySize + valueSize > end - offset) [[unlikely]]
+					throw FileFailureWhileInUse{ "The snapshot of the journaled save is inconsistent: " + path };
+
+				m_state.insertOrAssign(std::string_view{ snapshot }.substr(offset, keySize), snapshot.substr(offset + keySize, valueSize));
+				offset += keySize + valueSize;
+			}
+		}
+		m_snapshotSize = snapshot.size();
+
+		// The renamed journal is older than the current one: it must be replayed first.
+		uint64_t oldJournalSize{ 0 };
+		std::optional<uint64_t> const oldGeneration{ replay(fileName + ".log.old", snapshotGeneration, oldJournalSize) };
+		std::optional<uint64_t> const generation{ replay(fileName + ".log", snapshotGeneration, m_journalSize) };
+
+		if (oldGeneration.has_value())
+		{	// A compaction has been interrupted: it is finished before anything else.
+			m_generation = generation.value_or(oldGeneration.value() + 1);
+			if (generation.has_value())
+				m_journal = m_store.m_backend->append(m_store.m_root, fileName + ".log", m_journalSize);
+			else
+				startJournal(m_generation);
+
+			error = writeSnapshot(m_state, m_generation, m_snapshotSize);
+			if (error.has_value()) [[unlikely]]
+				throw FileFailureWhileInUse{ error.value() };
+		}
+		else if (generation.has_value())
+		{
+			m_generation = generation.value();
+			m_journal = m_store.m_backend->append(m_store.m_root, fileName + ".log", m_journalSize);
+		}
+		else
+		{
+			m_generation = snapshotGeneration;
+			startJournal(m_generation);
+		}
+	}
+	catch (FileFailureWhileOpening const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Fatal error: impossible to read the values" << "\n\n";
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the file is corrupted abd further saves are unavailable\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	if (!errorMessage.str().empty()) [[unlikely]]
+	{
+		m_journal.reset();
+		m_state.clear();
+		m_fileName.clear();
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	return std::nullopt;
+}
+
+std::optional<std::string> JournaledSave::put(std::string key, std::string value) noexcept
+{
+	std::vector<JournalUpdate> updates{};
+
+	try
+	{
+		updates.push_back(JournalUpdate{ std::move(key), std::move(value) });
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: impossible to update a key" << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	std::unique_lock lock{ m_mutex };
+	return applyLocked(updates);
+}
+
+std::optional<std::string> JournaledSave::erase(std::string key) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+
+	if (!m_state.contains(key))
+		return std::nullopt; // Nothing to journal.
+
+	std::vector<JournalUpdate> updates{};
+
+	try
+	{
+		updates.push_back(JournalUpdate{ std::move(key), std::nullopt });
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: impossible to erase a key of " << m_fileName << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	return applyLocked(updates);
+}
+
+std::optional<std::string> JournaledSave::apply(std::vector<JournalUpdate> const& updates) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	return applyLocked(updates);
+}
+
+bool JournaledSave::get(std::string_view key, std::string& value) const noexcept
+{
+	std::unique_lock lock{ m_mutex };
+
+	try
+	{
+		std::string const* const found{ m_state.find(key) };
+		if (found == nullptr)
+			return false;
+
+		value = *found;
+		return true;
+	}
+	catch (std::exception const&)
+	{	// Only std::bad_alloc is expected while copying.
+		return false;
+	}
+}
+
+void JournaledSave::forEach(std::function<void(std::string const&, std::string const&)> const& function) const
+{
+	std::unique_lock lock{ m_mutex };
+
+	m_state.forEach(function);
+}
+
+size_t JournaledSave::size() const noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	return m_state.size();
+}
+
+std::optional<std::string> JournaledSave::compact() noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	m_compactionDone.wait(lock, [this]() { return !m_compacting; });
+
+	if (m_fileName.empty()) [[unlikely]]
+		return std::make_optional<std::string>("Error: no journaled save is opened\n\n");
+
+	if (m_compactor.joinable())
+		m_compactor.join();
+
+	HashIndex<std::string> state{};
+	uint64_t generation{ 0 };
+
+	try
+	{
+		generation = beginCompaction(state);
+	}
+	catch (std::exception const& error)
+	{
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: impossible to compact the journal of " << m_fileName << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	// The snapshot is written without the lock: other threads can keep appending.
+	m_compacting = true;
+	lock.unlock();
+
+	uint64_t snapshotSize{ 0 };
+	auto error{ writeSnapshot(state, generation, snapshotSize) };
+
+	lock.lock();
+	m_compacting = false;
+	if (!error.has_value())
+		m_snapshotSize = snapshotSize;
+	m_compactionDone.notify_all();
+
+	return error;
+}
+
+std::optional<std::string> JournaledSave::waitForCompaction() noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	m_compactionDone.wait(lock, [this]() { return !m_compacting; });
+
+	return std::exchange(m_compactionError, std::nullopt);
+}
+
+std::optional<std::string> JournaledSave::applyLocked(std::vector<JournalUpdate> const& updates) noexcept
+{
+	std::ostringstream errorMessage{};
+
+	if (m_fileName.empty()) [[unlikely]]
+		return std::make_optional<std::string>("Error: no journaled save is opened\n\n");
+
+	if (updates.empty())
+		return std::nullopt;
+
+	std::string const name{ m_fileName + ".log" };
+
+	try
+	{
+		if (m_journal == nullptr) [[unlikely]]
+			throw FileFailureWhileInUse{ "The journal could not be opened again after an error: " + m_store.m_root.pathOf(name) };
+
+		std::string records{};
+		for (auto const& update : updates)
+			encodeRecord(records, update.key, update.value);
+
+		try
+		{	// A single write for the whole batch.
+			writeWhole(*m_journal, records, name);
+			m_journal->flush();
+		}
+		catch (FileFailureWhileInUse const&)
+		{	// A partial record would be discarded when replaying anyway, but the next ones would be too.
+			m_journal.reset();
+			m_journal = m_store.m_backend->append(m_store.m_root, name, m_journalSize);
+			throw;
+		}
+
+		m_journalSize += records.size();
+
+		for (auto const& update : updates)
+		{
+			if (update.value.has_value())
+				m_state.insertOrAssign(update.key, update.value.value());
+			else
+				m_state.erase(update.key);
+		}
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the updates are lost\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	if (!errorMessage.str().empty()) [[unlikely]]
+		return std::make_optional<std::string>(errorMessage.str());
+
+	compactIfNeeded();
+	return std::nullopt;
+}
+
+void JournaledSave::encodeRecord(std::string& buffer, std::string_view key, std::optional<std::string_view> value) const
+{
+	// Payload: operation, size of the key, key, value.
+	size_t const recordOffset{ buffer.size() };
+	buffer.append(recordHeaderSize, '\0');
+
+	size_t const payloadOffset{ buffer.size() };
+	appendInteger<uint8_t>(buffer, (value.has_value()) ? 0 : 1);
+	appendInteger<uint32_t>(buffer, static_cast<uint32_t>(key.size()));
+	buffer.append(key);
+	if (value.has_value())
+		buffer.append(value.value());
+
+	size_t const payloadSize{ buffer.size() - payloadOffset };
+	if (m_encrypt)
+		m_store.cipher(buffer.data() + payloadOffset, payloadSize);
+
+	// Header: written once the payload is known.
+	std::string header{};
+	appendInteger<uint32_t>(header, static_cast<uint32_t>(payloadSize));
+	appendInteger<uint32_t>(header, crc32(std::string_view{ buffer }.substr(payloadOffset)));
+	buffer.replace(recordOffset, recordHeaderSize, header);
+}
+
+std::optional<uint64_t> JournaledSave::replay(std::string const& name, uint64_t snapshotGeneration, uint64_t& journalSize)
+{
+	if (!exists(name))
+		return std::nullopt;
+
+	std::string journal{};
+	{
+		std::unique_ptr<IoReadFile> const file{ m_store.m_backend->open(m_store.m_root, name) };
+		journal.resize(static_cast<size_t>(file->size()));
+		journal.resize(file->readAt(journal.data(), journal.size(), 0));
+	}
+
+	// Header: magic number, generation and CRC-32 of both.
+	if (journal.size() < journalHeaderSize || readInteger<uint32_t>(journal, 0) != journalMagicNumber
+	||  readInteger<uint32_t>(journal, 12) != crc32(std::string_view{ journal }.substr(0, 12))
+	||  readInteger<uint64_t>(journal, 4) < snapshotGeneration)
+	{	// Crashed while being created, or already folded into the snapshot.
+		m_store.m_backend->remove(m_store.m_root, name);
+		return std::nullopt;
+	}
+
+	uint64_t const generation{ readInteger<uint64_t>(journal, 4) };
+	size_t offset{ journalHeaderSize };
+	std::string payload{};
+
+	while (journal.size() - offset >= recordHeaderSize)
+	{
+		size_t const payloadSize{ readInteger<uint32_t>(journal, offset) };
+		uint32_t const checksum{ readInteger<uint32_t>(journal, offset + 4) };
+
+		if (payloadSize > journal.size() - offset - recordHeaderSize || payloadSize < 5)
+			break; // Torn record.
+
+		payload.assign(journal, offset + recordHeaderSize, payloadSize);
+		if (crc32(payload) != checksum)
+			break; // Corrupted record.
+
+		if (m_encrypt)
+			m_store.cipher(payload.data(), payload.size());
+
+		uint8_t const operation{ readInteger<uint8_t>(payload, 0) };
+		size_t const keySize{ readInteger<uint32_t>(payload, 1) };
+		if (keySize > payloadSize - 5 || operation > 1)
+			break;
+
+		if (operation == 0)
+			m_state.insertOrAssign(std::string_view{ payload }.substr(5, keySize), payload.substr(5 + keySize));
+		else
+			m_state.erase(std::string_view{ payload }.substr(5, keySize));
+
+		offset += recordHeaderSize + payloadSize;
+	}
+
+	// Everything after the last valid record is lost: removed so that new records can follow.
+	if (offset != journal.size())
+		m_store.m_backend->append(m_store.m_root, name, offset)->close();
+
+	journalSize = offset;
+	return generation;
+}
+
+bool JournaledSave::exists(std::string const& name) const noexcept
+{
+	return m_store.m_validatedFiles.identify(m_store.m_root, name).has_value();
+}
+
+void JournaledSave::startJournal(uint64_t generation)
+{
+	std::string const name{ m_fileName + ".log" };
+
+	std::string header{};
+	appendInteger<uint32_t>(header, journalMagicNumber);
+	appendInteger<uint64_t>(header, generation);
+	appendInteger<uint32_t>(header, crc32(header));
+
+	m_journal.reset();
+	m_journal = m_store.m_backend->create(m_store.m_root, name);
+
+	try
+	{
+		writeWhole(*m_journal, header, name);
+		m_journal->flush();
+	}
+	catch (FileFailureWhileInUse const&)
+	{
+		m_journal.reset();
+		throw FileFailureWhileOpening{ "Unable to start the journal: " + m_store.m_root.pathOf(name) };
+	}
+
+	m_journalSize = header.size();
+}
+
+uint64_t JournaledSave::beginCompaction(HashIndex<std::string>& state)
+{
+	std::string const name{ m_fileName + ".log" };
+
+	if (!exists(name + ".old"))
+	{	// From now on, new records go to a journal applying to the snapshot being written.
+		m_journal.reset(); // Closed: every record has already been flushed.
+
+		try
+		{
+			m_store.m_backend->rename(m_store.m_root, name, name + ".old");
+		}
+		catch (std::exception const&)
+		{	// Nothing has changed: the journal is still usable.
+			m_journal = m_store.m_backend->append(m_store.m_root, name, m_journalSize);
+			throw;
+		}
+
+		startJournal(++m_generation);
+	}
+
+	state = m_state;
+	return m_generation;
+}
+
+std::optional<std::string> JournaledSave::writeSnapshot(HashIndex<std::string> const& state, uint64_t generation, uint64_t& snapshotSize) const noexcept
+{
+	std::string const path{ m_store.m_root.pathOf(m_fileName) };
+	std::string snapshot{};
+
+	try
+	{
+		size_t totalSize{ 24 };
+		state.forEach([&totalSize](std::string const& key, std::string const& value) { totalSize += 12 + key.size() + value.size(); });
+		snapshot.reserve(totalSize);
+
+		appendInteger<uint32_t>(snapshot, snapshotMagicNumber);
+		appendInteger<uint64_t>(snapshot, generation);
+		appendInteger<uint64_t>(snapshot, state.size());
+
+		state.forEach([&snapshot](std::string const& key, std::string const& value)
+		{
+			appendInteger<uint32_t>(snapshot, static_cast<uint32_t>(key.size()));
+			appendInteger<uint64_t>(snapshot, value.size());
+			snapshot.append(key);
+			snapshot.append(value);
+		});
+
+		appendInteger<uint32_t>(snapshot, crc32(snapshot));
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: impossible to build the snapshot of " << path << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	auto error{ m_store.writingBlob(m_fileName, snapshot, m_encrypt) };
+	if (error.has_value()) [[unlikely]]
+		return error;
+
+	// The renamed journal is now part of the snapshot.
+	m_store.m_backend->remove(m_store.m_root, m_fileName + ".log.old");
+
+	snapshotSize = snapshot.size();
+	return std::nullopt;
+}
+
+void JournaledSave::compactIfNeeded() noexcept
+{
+	uint64_t const threshold{ std::max(minimumCompactionSize, static_cast<uint64_t>(m_compactionRatio * static_cast<float>(m_snapshotSize))) };
+	if (m_compacting || m_journalSize <= threshold)
+		return;
+
+	// The previous compaction is over: m_compacting is false.
+	if (m_compactor.joinable())
+		m_compactor.join();
+
+	try
+	{
+		HashIndex<std::string> state{};
+		uint64_t const generation{ beginCompaction(state) };
+
+		m_compacting = true;
+		m_compactor = std::thread{ [this, state = std::move(state), generation]()
+		{
+			uint64_t snapshotSize{ 0 };
+			auto error{ writeSnapshot(state, generation, snapshotSize) };
+
+			std::unique_lock lock{ m_mutex };
+			m_compacting = false;
+			if (error.has_value())
+				m_compactionError = std::move(error);
+			else
+				m_snapshotSize = snapshotSize;
+			m_compactionDone.notify_all();
+		} };
+	}
+	catch (std::exception const& error)
+	{	// The journal keeps growing: the compaction will be tried again on the next update.
+		m_compacting = false;
+
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: impossible to compact the journal of " << m_fileName << "\n\n";
+		m_compactionError = errorMessage.str();
+	}
+}
@@ -0,0 +1,290 @@
+/*******************************************************************
+ * @file JournaledSave.hpp
+ * @brief Declares a key-value save updated by appending to a log instead of rewriting the file.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef JOURNALEDSAVE_HPP
+#define JOURNALEDSAVE_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "HashIndex.hpp"
+#include "IoBackend.hpp"
+#include "../Save.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief A change of a single key: the key is set to the value, or erased if there is no value.
+ */
+struct JournalUpdate
+{
+	std::string key;
+	std::optional<std::string> value; // std::nullopt erases the key.
+};
+
+/**
+ * @brief A key-value save where each update costs an append, not a rewrite of the whole file.
+ *
+ * The state is stored in two files within the saves folder:
+ * - `fileName`: the last snapshot, written by SaveStore::writingBlob() with its tokens of confirmation;
+ * - `fileName.log`: the journal, where each update is appended as a record checksummed by a CRC-32.
+ *
+ * Opening the save loads the snapshot and replays the journal over it. A crash can only corrupt
+ * the end of the journal: it is truncated at the last valid record, so no temporary copy of the
+ * file is ever needed to update it.
+ *
+ * When the journal becomes larger than `compactionRatio` times the snapshot, a background thread
+ * folds it into a new snapshot. The journal is first renamed `fileName.log.old` and a new one is
+ * started, so updates are never blocked by the compaction. Both journals carry the generation of
+ * the snapshot they apply to, which lets open() finish a compaction interrupted by a crash.
+ *
+ * Every file is reached through the backend of the store, as the saves of the store are.
+ *
+ * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ * @note Every function is thread-safe.
+ * @warning Appends are flushed to the system, not synchronized with the disk: a power loss can
+ *			lose the last updates, but never corrupts the save.
+ *
+ * @see Save, JournalUpdate.
+ *
+ * @code
+ * SafeSaves::JournaledSave settings{};
+ * if (auto error{ settings.open("settings.sav") })
+ *     showErrorsUsingWindow("Saves", std::ostringstream{ error.value() });
+ *
+ * settings.put("volume", "0.8"); // One small append.
+ *
+ * std::string volume{};
+ * if (settings.get("volume", volume))
+ *     apply(volume);
+ * @endcode
+ */
+class JournaledSave
+{
+public:
+
+	/**
+	 * @brief Initializes the save without opening any file.
+	 * @complexity O(1).
+	 *
+	 * @param[in] compactionRatio: The journal is compacted when it is this many times larger than
+	 *			  the snapshot (and larger than minimumCompactionSize).
+	 * @param[in] encrypt: True if the snapshot and the journal need to be encrypted.
+	 * @param[in] store: The store of the snapshot and the journal. It must outlive the save.
+	 */
+	explicit JournaledSave(float compactionRatio = 2.f, bool encrypt = true, SaveStore& store = Save::store()) noexcept;
+
+	/**
+	 * @brief Waits for the compaction in progress, if any, and closes the journal.
+	 * @complexity O(N) where N is the size of the state, if a compaction is in progress.
+	 */
+	~JournaledSave() noexcept;
+
+	JournaledSave(JournaledSave const&) = delete;
+	JournaledSave(JournaledSave&&) = delete;
+	JournaledSave& operator=(JournaledSave const&) = delete;
+	JournaledSave& operator=(JournaledSave&&) = delete;
+
+
+	/**
+	 * @brief Loads the snapshot, replays the journal and prepares it for appending.
+	 * @complexity O(N) where N is the size of the snapshot and the journal.
+	 *
+	 * @param[in] fileName: The name of the snapshot. It is created if it does not exist.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @note A previously opened save is closed first.
+	 */
+	[[nodiscard]] std::optional<std::string> open(std::string const& fileName) noexcept;
+
+	/**
+	 * @brief Sets a key to a value.
+	 * @complexity O(K + V), the size of the key and the value. Amortized O(1) for the state.
+	 *
+	 * @param[in] key: The key.
+	 * @param[in] value: The new value.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @see apply().
+	 */
+	[[nodiscard]] std::optional<std::string> put(std::string key, std::string value) noexcept;
+
+	/**
+	 * @brief Erases a key. Nothing is written if the key does not exist.
+	 * @complexity O(K), the size of the key.
+	 *
+	 * @param[in] key: The key.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @see apply().
+	 */
+	[[nodiscard]] std::optional<std::string> erase(std::string key) noexcept;
+
+	/**
+	 * @brief Applies several updates, in order, with a single append to the journal.
+	 * @complexity O(N) where N is the size of the updates.
+	 *
+	 * @param[in] updates: The updates to apply.
+	 *
+	 * @return an optional string that contains an error message. If so, none of the updates is applied
+	 *		   to the state, but some of them may be replayed when the save is opened again.
+	 */
+	[[nodiscard]] std::optional<std::string> apply(std::vector<JournalUpdate> const& updates) noexcept;
+
+	/**
+	 * @brief Copies the value of a key.
+	 * @complexity O(V), the size of the value.
+	 *
+	 * @param[in] key: The key.
+	 * @param[out] value: Where the value is copied, unchanged if the key does not exist.
+	 *
+	 * @return True if the key exists.
+	 */
+	bool get(std::string_view key, std::string& value) const noexcept;
+
+	/**
+	 * @brief Calls a function on every key-value pair, in no particular order.
+	 * @complexity O(N) where N is the number of keys.
+	 *
+	 * @param[in] function: The function to call.
+	 *
+	 * @warning The function must not call any function of this instance.
+	 */
+	void forEach(std::function<void(std::string const&, std::string const&)> const& function) const;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of keys.
+	 */
+	[[nodiscard]] size_t size() const noexcept;
+
+	/**
+	 * @brief Folds the journal into a new snapshot, now, on this thread.
+	 * @complexity O(N) where N is the size of the state.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] std::optional<std::string> compact() noexcept;
+
+	/**
+	 * @brief Blocks until the background compaction in progress, if any, is done.
+	 * @complexity O(N) where N is the size of the state, if a compaction is in progress.
+	 *
+	 * @return The error message of the last background compaction, if it failed.
+	 */
+	[[nodiscard]] std::optional<std::string> waitForCompaction() noexcept;
+
+	/// The journal is never compacted below this size, in bytes.
+	inline static uint64_t minimumCompactionSize{ 64 * 1024 };
+
+private:
+
+	/**
+	 * @brief Encodes updates, appends them to the journal and applies them to the state.
+	 * @details The lock must be held.
+	 */
+	[[nodiscard]] std::optional<std::string> applyLocked(std::vector<JournalUpdate> const& updates) noexcept;
+
+	/**
+	 * @brief Encodes an update as a journal record and appends it to a buffer.
+	 */
+	void encodeRecord(std::string& buffer, std::string_view key, std::optional<std::string_view> value) const;
+
+	/**
+	 * @brief Replays a journal file over the state, and truncates it at its last valid record.
+	 * @details The lock must be held. A journal older than the snapshot is removed instead.
+	 *
+	 * @param[in] name: The name of the journal, within the root of the store.
+	 * @param[in] snapshotGeneration: The generation of the snapshot loaded.
+	 * @param[out] journalSize: The size of the journal once truncated, if it was replayed.
+	 *
+	 * @return The generation of the journal, or std::nullopt if it was not replayed.
+	 */
+	[[nodiscard]] std::optional<uint64_t> replay(std::string const& name, uint64_t snapshotGeneration, uint64_t& journalSize);
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] name: The name of a file, within the root of the store.
+	 *
+	 * @return True if the file exists.
+	 */
+	[[nodiscard]] bool exists(std::string const& name) const noexcept;
+
+	/**
+	 * @brief Creates an empty journal with the given generation and opens it for appending.
+	 * @details The lock must be held.
+	 */
+	void startJournal(uint64_t generation);
+
+	/**
+	 * @brief Renames the journal and starts a new one, then copies the state to fold.
+	 * @details The lock must be held and no compaction can be running. The journal is not renamed
+	 *			if the one of a failed compaction is still there: it would be lost.
+	 *
+	 * @param[out] state: Where the state is copied.
+	 *
+	 * @return The generation of the snapshot to write.
+	 */
+	[[nodiscard]] uint64_t beginCompaction(HashIndex<std::string>& state);
+
+	/**
+	 * @brief Writes a snapshot of a state, and removes the renamed journal it includes.
+	 * @details Must be called without the lock.
+	 */
+	[[nodiscard]] std::optional<std::string> writeSnapshot(HashIndex<std::string> const& state, uint64_t generation, uint64_t& snapshotSize) const noexcept;
+
+	/**
+	 * @brief Starts a background compaction if the journal is large enough and none is running.
+	 * @details The lock must be held.
+	 */
+	void compactIfNeeded() noexcept;
+
+
+	mutable std::mutex m_mutex; // Protects every member below.
+	std::condition_variable m_compactionDone; // Notified when m_compacting becomes false.
+	std::thread m_compactor; // Only joined while m_compacting is false.
+
+	SaveStore& m_store;
+	std::string m_fileName; // Name of the snapshot within the root of the store, empty if not opened.
+	std::unique_ptr<IoFile> m_journal; // Opened for appending through the backend of the store, nullptr if closed.
+	HashIndex<std::string> m_state; // Snapshot + journal, loaded once by open().
+
+	uint64_t m_generation; // Generation of the current journal.
+	uint64_t m_journalSize; // In bytes, header included.
+	uint64_t m_snapshotSize; // In bytes, to decide when to compact.
+	bool m_compacting; // True while the background thread writes a snapshot.
+	std::optional<std::string> m_compactionError; // Error of the last background compaction.
+
+	float const m_compactionRatio;
+	bool const m_encrypt;
+
+
+	static constexpr uint32_t snapshotMagicNumber{ 0x50534A53 }; // "SJSP" in little endian.
+	static constexpr uint32_t journalMagicNumber{ 0x4C4A4A53 }; // "SJJL" in little endian.
+	static constexpr size_t journalHeaderSize{ 16 }; // Magic number, generation and CRC-32.
+	static constexpr size_t recordHeaderSize{ 8 }; // Size and CRC-32 of the payload.
+};
+} // namespace SafeSaves
+
+#endif //JOURNALEDSAVE_HPP
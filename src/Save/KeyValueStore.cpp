@@ -0,0 +1,179 @@
+#include <bit>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "KeyValueStore.hpp"
+#include "BinaryUtils.hpp"
+
+using namespace SafeSaves;
+
+
+KeyValueStore::KeyValueStore(bool encrypt, SaveStore& store) noexcept
+	: m_journal{ 2.f, encrypt, store }, m_staged{}
+{}
+
+std::optional<std::string> KeyValueStore::open(std::string const& fileName) noexcept
+{
+	m_staged.clear();
+	return m_journal.open(fileName);
+}
+
+std::optional<std::string> KeyValueStore::commit() noexcept
+{
+	if (m_staged.size() == 0)
+		return std::nullopt;
+
+	std::vector<JournalUpdate> updates{};
+
+	try
+	{
+		updates.reserve(m_staged.size());
+		m_staged.forEach([&updates](std::string const& key, std::optional<std::string> const& value)
+		{
+			updates.push_back(JournalUpdate{ key, value });
+		});
+	}
+	catch (std::exception const& error)
+	{	// Only std::bad_alloc is expected.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: impossible to prepare the commit" << "\n\n";
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	auto error{ m_journal.apply(updates) };
+	if (error.has_value()) [[unlikely]]
+		return error;
+
+	m_staged.clear();
+	return std::nullopt;
+}
+
+void KeyValueStore::putInt(std::string_view key, int64_t value)
+{
+	std::string payload{};
+	appendInteger<uint64_t>(payload, static_cast<uint64_t>(value));
+	stage(key, ValueType::Integer, payload);
+}
+
+void KeyValueStore::putFloat(std::string_view key, double value)
+{
+	std::string payload{};
+	appendInteger<uint64_t>(payload, std::bit_cast<uint64_t>(value));
+	stage(key, ValueType::Float, payload);
+}
+
+void KeyValueStore::putString(std::string_view key, std::string_view value)
+{
+	stage(key, ValueType::String, value);
+}
+
+void KeyValueStore::putBlob(std::string_view key, std::string_view value)
+{
+	stage(key, ValueType::Blob, value);
+}
+
+void KeyValueStore::erase(std::string_view key)
+{
+	m_staged.insertOrAssign(key, std::nullopt);
+}
+
+std::optional<int64_t> KeyValueStore::getInt(std::string_view key) const noexcept
+{
+	std::string value{};
+	if (!findValue(key, value) || value.size() != 9 || value[0] != static_cast<char>(ValueType::Integer))
+		return std::nullopt;
+
+	return static_cast<int64_t>(readInteger<uint64_t>(value, 1));
+}
+
+std::optional<double> KeyValueStore::getFloat(std::string_view key) const noexcept
+{
+	std::string value{};
+	if (!findValue(key, value) || value.size() != 9 || value[0] != static_cast<char>(ValueType::Float))
+		return std::nullopt;
+
+	return std::bit_cast<double>(readInteger<uint64_t>(value, 1));
+}
+
+std::optional<std::string> KeyValueStore::getString(std::string_view key) const noexcept
+{
+	std::string value{};
+	if (!findValue(key, value) || value.empty() || value[0] != static_cast<char>(ValueType::String))
+		return std::nullopt;
+
+	value.erase(0, 1); // The type.
+	return std::make_optional<std::string>(std::move(value));
+}
+
+std::optional<std::string> KeyValueStore::getBlob(std::string_view key) const noexcept
+{
+	std::string value{};
+	if (!findValue(key, value) || value.empty() || value[0] != static_cast<char>(ValueType::Blob))
+		return std::nullopt;
+
+	value.erase(0, 1); // The type.
+	return std::make_optional<std::string>(std::move(value));
+}
+
+std::optional<KeyValueStore::ValueType> KeyValueStore::typeOf(std::string_view key) const noexcept
+{
+	std::string value{};
+	if (!findValue(key, value) || value.empty())
+		return std::nullopt;
+
+	return static_cast<ValueType>(value[0]);
+}
+
+std::vector<std::string> KeyValueStore::keys() const
+{
+	std::vector<std::string> result{};
+	result.reserve(m_journal.size() + m_staged.size());
+
+	// Committed keys, unless a staged change replaces or erases them.
+	m_journal.forEach([this, &result](std::string const& key, std::string const&)
+	{
+		if (!m_staged.contains(key))
+			result.push_back(key);
+	});
+
+	m_staged.forEach([&result](std::string const& key, std::optional<std::string> const& value)
+	{
+		if (value.has_value())
+			result.push_back(key);
+	});
+
+	return result;
+}
+
+void KeyValueStore::stage(std::string_view key, ValueType type, std::string_view payload)
+{
+	std::string value{};
+	value.reserve(payload.size() + 1);
+	value.push_back(static_cast<char>(type));
+	value.append(payload);
+
+	m_staged.insertOrAssign(key, std::make_optional<std::string>(std::move(value)));
+}
+
+bool KeyValueStore::findValue(std::string_view key, std::string& value) const noexcept
+{
+	std::optional<std::string> const* const staged{ m_staged.find(key) };
+	if (staged == nullptr)
+		return m_journal.get(key, value);
+
+	if (!staged->has_value())
+		return false; // Erased.
+
+	try
+	{
+		value = staged->value();
+		return true;
+	}
+	catch (std::exception const&)
+	{	// Only std::bad_alloc is expected while copying.
+		return false;
+	}
+}
@@ -0,0 +1,219 @@
+/*******************************************************************
+ * @file KeyValueStore.hpp
+ * @brief Declares a typed key-value store saved in a file, with batched commits.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef KEYVALUESTORE_HPP
+#define KEYVALUESTORE_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "HashIndex.hpp"
+#include "JournaledSave.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Stores integers, floats, strings and blobs by key in a save file.
+ *
+ * Saves no longer need to agree on which line holds which value: each value has a name. The file
+ * is a JournaledSave, whose state is loaded once by open() into an open-addressing hash index, so
+ * every lookup is done in memory in O(1).
+ *
+ * Changes are staged in memory until commit(), which writes all of them with a single append to
+ * the journal whatever their number. Reads see the staged changes.
+ *
+ * Each value is stored with its type: reading it with another type fails.
+ *
+ * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ * @note Functions that stage a change may throw std::bad_alloc.
+ * @warning This class is not thread-safe, unlike JournaledSave.
+ * @warning Staged changes are lost if they are not committed before the destruction or open().
+ *
+ * @see JournaledSave, HashIndex.
+ *
+ * @code
+ * SafeSaves::KeyValueStore profile{};
+ * if (auto error{ profile.open("profile.sav") })
+ *     showErrorsUsingWindow("Saves", std::ostringstream{ error.value() });
+ *
+ * profile.putInt("level", profile.getInt("level").value_or(0) + 1);
+ * profile.putString("name", "Alice");
+ * auto error{ profile.commit() }; // A single write for both keys.
+ * @endcode
+ */
+class KeyValueStore
+{
+public:
+
+	/// The type of a value, stored as its first byte.
+	enum class ValueType : uint8_t
+	{
+		Integer = 'i',
+		Float = 'f',
+		String = 's',
+		Blob = 'b'
+	};
+
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] encrypt: True if the file needs to be encrypted.
+	 * @param[in] store: The store of the file. It must outlive the key-value store.
+	 */
+	explicit KeyValueStore(bool encrypt = true, SaveStore& store = Save::store()) noexcept;
+	KeyValueStore(KeyValueStore const&) = delete;
+	KeyValueStore(KeyValueStore&&) = delete;
+	KeyValueStore& operator=(KeyValueStore const&) = delete;
+	KeyValueStore& operator=(KeyValueStore&&) = delete;
+	~KeyValueStore() noexcept = default;
+
+
+	/**
+	 * @brief Loads every key of a file.
+	 * @complexity O(N) where N is the size of the file.
+	 *
+	 * @param[in] fileName: The name of the file, created if it does not exist.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @note The staged changes are discarded.
+	 */
+	[[nodiscard]] std::optional<std::string> open(std::string const& fileName) noexcept;
+
+	/**
+	 * @brief Writes every staged change with a single append.
+	 * @complexity O(N) where N is the size of the staged changes.
+	 *
+	 * @return an optional string that contains an error message. If so, the changes stay staged.
+	 */
+	[[nodiscard]] std::optional<std::string> commit() noexcept;
+
+	/**
+	 * @brief Forgets every staged change.
+	 * @complexity O(C) where C is the capacity of the staging index.
+	 */
+	inline void discard() noexcept { m_staged.clear(); }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return True if some changes are not committed.
+	 */
+	[[nodiscard]] inline bool hasPendingChanges() const noexcept { return m_staged.size() != 0; }
+
+
+	/**
+	 * @brief Stages a value. The previous value of the key, whatever its type, is replaced.
+	 * @complexity O(K + V), the size of the key and the value.
+	 *
+	 * @param[in] key: The key.
+	 * @param[in] value: The value.
+	 */
+	void putInt(std::string_view key, int64_t value);
+
+	/**
+	 * @copydoc putInt()
+	 */
+	void putFloat(std::string_view key, double value);
+
+	/**
+	 * @copydoc putInt()
+	 */
+	void putString(std::string_view key, std::string_view value);
+
+	/**
+	 * @copydoc putInt()
+	 */
+	void putBlob(std::string_view key, std::string_view value);
+
+	/**
+	 * @brief Stages the removal of a key.
+	 * @complexity O(K), the size of the key.
+	 *
+	 * @param[in] key: The key.
+	 */
+	void erase(std::string_view key);
+
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] key: The key.
+	 *
+	 * @return The value, or std::nullopt if the key does not exist or has another type.
+	 */
+	[[nodiscard]] std::optional<int64_t> getInt(std::string_view key) const noexcept;
+
+	/**
+	 * @copydoc getInt()
+	 */
+	[[nodiscard]] std::optional<double> getFloat(std::string_view key) const noexcept;
+
+	/**
+	 * @brief Copies a string value.
+	 * @complexity O(V), the size of the value.
+	 *
+	 * @param[in] key: The key.
+	 *
+	 * @return The value, or std::nullopt if the key does not exist or has another type.
+	 */
+	[[nodiscard]] std::optional<std::string> getString(std::string_view key) const noexcept;
+
+	/**
+	 * @copydoc getString()
+	 */
+	[[nodiscard]] std::optional<std::string> getBlob(std::string_view key) const noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] key: The key.
+	 *
+	 * @return The type of the value, or std::nullopt if the key does not exist.
+	 */
+	[[nodiscard]] std::optional<ValueType> typeOf(std::string_view key) const noexcept;
+
+	/**
+	 * @brief Lists the keys, staged changes included, in no particular order.
+	 * @complexity O(N) where N is the number of keys.
+	 *
+	 * @return The keys.
+	 */
+	[[nodiscard]] std::vector<std::string> keys() const;
+
+private:
+
+	/**
+	 * @brief Stages a value, prefixed by its type.
+	 */
+	void stage(std::string_view key, ValueType type, std::string_view payload);
+
+	/**
+	 * @brief Finds the current value of a key, looking at the staged changes first.
+	 *
+	 * @param[in] key: The key.
+	 * @param[out] value: Where the value, type included, is copied.
+	 *
+	 * @return True if the key exists.
+	 */
+	bool findValue(std::string_view key, std::string& value) const noexcept;
+
+
+	JournaledSave m_journal; // The file and the committed values.
+	HashIndex<std::optional<std::string>> m_staged; // Not committed yet: std::nullopt erases the key.
+};
+} // namespace SafeSaves
+
+#endif //KEYVALUESTORE_HPP
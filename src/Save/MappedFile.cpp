@@ -0,0 +1,181 @@
+#include <string>
+#include <string_view>
+#include <utility>
+#include "MappedFile.hpp"
+#include "IoBackend.hpp"
+#include "../Exceptions.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PosixBackend.hpp"
+#endif
+
+using namespace SafeSaves;
+
+
+MappedFile::MappedFile() noexcept
+	: m_data{ nullptr }, m_size{ 0 }
+{}
+
+MappedFile::MappedFile(std::string const& path)
+	: m_data{ nullptr }, m_size{ 0 }
+{
+#ifdef _WIN32
+	HANDLE const file{ CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+	if (file == INVALID_HANDLE_VALUE) [[unlikely]]
+		throw FileFailureWhileOpening{ "Unable to open the file for mapping: " + path };
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize)) [[unlikely]]
+	{
+		CloseHandle(file);
+		throw FileFailureWhileOpening{ "Unable to get the size of the file: " + path };
+	}
+
+	if (fileSize.QuadPart == 0)
+	{	// Mapping an empty file is an error on Windows.
+		CloseHandle(file);
+		return;
+	}
+
+	HANDLE const mapping{ CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+	CloseHandle(file); // The mapping keeps its own reference to the file.
+
+	if (mapping == nullptr) [[unlikely]]
+		throw FileFailureWhileOpening{ "Unable to map the file: " + path };
+
+	void const* const data{ MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) };
+	CloseHandle(mapping); // The view keeps its own reference to the mapping.
+
+	if (data == nullptr) [[unlikely]]
+		throw FileFailureWhileOpening{ "Unable to map the file: " + path };
+
+	m_data = static_cast<char const*>(data);
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	int const file{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+	if (file < 0) [[unlikely]]
+		throw FileFailureWhileOpening{ "Unable to open the file for mapping: " + path };
+
+	map(file, path);
+#endif
+}
+
+MappedFile::MappedFile(IoDirectory const& directory, std::string const& name)
+	: m_data{ nullptr }, m_size{ 0 }
+{
+#ifdef _WIN32
+	*this = MappedFile{ directory.pathOf(name) };
+#else
+	int const file{ openInDirectory(directory, name, O_RDONLY | O_CLOEXEC) };
+	if (file < 0) [[unlikely]]
+		throw FileFailureWhileOpening{ "Unable to open the file for mapping: " + directory.pathOf(name) };
+
+	map(file, name);
+#endif
+}
+
+MappedFile::~MappedFile() noexcept
+{
+	release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: m_data{ std::exchange(other.m_data, nullptr) }, m_size{ std::exchange(other.m_size, 0) }
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+	}
+
+	return *this;
+}
+
+MappedRecords::MappedRecords(MappedRecords&& other) noexcept
+	: m_file{ std::move(other.m_file) }, m_arena{}, m_records{ std::move(other.m_records) }
+{
+	char const* const previousArena{ other.m_arena.data() };
+	m_arena = std::move(other.m_arena);
+	rebase(previousArena);
+}
+
+MappedRecords& MappedRecords::operator=(MappedRecords&& other) noexcept
+{
+	if (this != &other)
+	{
+		char const* const previousArena{ other.m_arena.data() };
+		m_file = std::move(other.m_file);
+		m_arena = std::move(other.m_arena);
+		m_records = std::move(other.m_records);
+		rebase(previousArena);
+	}
+
+	return *this;
+}
+
+void MappedRecords::rebase(char const* previousArena) noexcept
+{
+	// Without an arena, the views point into the mapping, which does not move.
+	if (m_arena.empty() || m_arena.data() == previousArena)
+		return;
+
+	for (auto& record : m_records)
+		record = std::string_view{ m_arena.data() + (record.data() - previousArena), record.size() };
+}
+
+void MappedFile::map([[maybe_unused]] int file, [[maybe_unused]] std::string const& path)
+{
+#ifndef _WIN32
+	struct stat status{};
+	if (::fstat(file, &status) != 0) [[unlikely]]
+	{
+		::close(file);
+		throw FileFailureWhileOpening{ "Unable to get the size of the file: " + path };
+	}
+
+	if (status.st_size == 0)
+	{	// mmap refuses a length of 0.
+		::close(file);
+		return;
+	}
+
+	void* const data{ ::mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0) };
+	::close(file); // The mapping keeps its own reference to the file.
+
+	if (data == MAP_FAILED) [[unlikely]]
+		throw FileFailureWhileOpening{ "Unable to map the file: " + path };
+
+	// The whole file is about to be read from the beginning to the end.
+	::madvise(data, static_cast<size_t>(status.st_size), MADV_SEQUENTIAL);
+
+	m_data = static_cast<char const*>(data);
+	m_size = static_cast<size_t>(status.st_size);
+#endif
+}
+
+void MappedFile::release() noexcept
+{
+	if (m_data == nullptr)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(m_data);
+#else
+	::munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+}
@@ -0,0 +1,166 @@
+/*******************************************************************
+ * @file MappedFile.hpp
+ * @brief Declares a read-only memory mapping of a file and the records viewed through it.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+class IoDirectory;
+
+/**
+ * @brief Use RAII to map a whole file in memory, read-only.
+ *
+ * @note An empty file is valid: its view is empty and nothing is mapped.
+ *
+ * @see MappedRecords, SaveStore::readingMapped().
+ */
+class MappedFile
+{
+public:
+
+	/**
+	 * @brief Maps a file and throws an error if the operation fails.
+	 * @complexity O(1): pages are loaded lazily by the system.
+	 *
+	 * @param[in] path: Path to the file.
+	 *
+	 * @pre The file must exist and be readable.
+	 * @post The content of the file is accessible through view().
+	 * @throw FileFailureWhileOpening if the file cannot be mapped.
+	 *        Strong exceptions guarrantee: nothing is mapped.
+	 */
+	explicit MappedFile(std::string const& path);
+
+	/**
+	 * @brief Maps a file, opened relatively to its directory.
+	 * @complexity O(1): pages are loaded lazily by the system.
+	 *
+	 * @param[in] directory: The directory of the file.
+	 * @param[in] name: The name of the file, relative to the directory.
+	 *
+	 * @see MappedFile(std::string const&).
+	 */
+	MappedFile(IoDirectory const& directory, std::string const& name);
+
+	/**
+	 * @brief Unmaps the file.
+	 * @complexity O(1).
+	 */
+	~MappedFile() noexcept;
+
+	MappedFile() noexcept;
+	MappedFile(MappedFile const&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The content of the file. Valid as long as this instance is alive.
+	 */
+	[[nodiscard]] inline std::string_view view() const noexcept
+	{
+		return std::string_view{ m_data, m_size };
+	}
+
+private:
+
+	/**
+	 * @brief Maps an open file, then closes it.
+	 *
+	 * @param[in] file: The descriptor of the file, closed in every case.
+	 * @param[in] path: The path to the file, for the error messages.
+	 */
+	void map(int file, std::string const& path);
+
+	/**
+	 * @brief Releases the mapping, if any.
+	 */
+	void release() noexcept;
+
+
+	char const* m_data; // Address of the mapping, nullptr if nothing is mapped.
+	size_t m_size; // Size of the mapping in bytes.
+};
+
+
+/**
+ * @brief The records (lines) of a save file, loaded with SaveStore::readingMapped().
+ *
+ * Unencrypted records are views into the mapping of the file. Encrypted records are decrypted
+ * all at once into a single arena, and viewed from there. Either way, no allocation is made per
+ * record.
+ *
+ * @note The views remain valid until the instance is destroyed or reloaded.
+ *
+ * @see SaveStore::readingMapped(), MappedFile.
+ */
+class MappedRecords
+{
+public:
+
+	MappedRecords() noexcept = default;
+	MappedRecords(MappedRecords const&) = delete;
+	MappedRecords(MappedRecords&& other) noexcept;
+	MappedRecords& operator=(MappedRecords const&) = delete;
+	MappedRecords& operator=(MappedRecords&& other) noexcept;
+	~MappedRecords() noexcept = default;
+
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of records.
+	 */
+	[[nodiscard]] inline size_t size() const noexcept { return m_records.size(); }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] index: The index of the record (0 is the first line of the file).
+	 *
+	 * @return The record at that index.
+	 */
+	[[nodiscard]] inline std::string_view operator[](size_t index) const noexcept { return m_records[index]; }
+
+	[[nodiscard]] inline auto begin() const noexcept { return m_records.begin(); }
+	[[nodiscard]] inline auto end() const noexcept { return m_records.end(); }
+
+private:
+
+	/**
+	 * @brief Points the views at the arena again, after it was moved.
+	 * @details A short arena lives in the buffer of the string itself: moving the string copies
+	 *			it, and the views still point into the previous one.
+	 *
+	 * @param[in] previousArena: Where the arena was before being moved.
+	 */
+	void rebase(char const* previousArena) noexcept;
+
+
+	MappedFile m_file; // The mapping, views point into it when not decrypted.
+	std::string m_arena; // Decrypted content, views point into it when decrypted.
+	std::vector<std::string_view> m_records; // One view per line.
+
+friend class SaveStore;
+};
+} // namespace SafeSaves
+
+#endif //MAPPEDFILE_HPP
@@ -0,0 +1,253 @@
+#ifndef _WIN32
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PosixBackend.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+
+namespace
+{
+/// Frees a buffer allocated with an alignment.
+struct AlignedDelete
+{
+	void operator()(char* buffer) const noexcept
+	{
+		::operator delete(buffer, std::align_val_t{ PosixBackend::bufferAlignment });
+	}
+};
+
+/// A file of the PosixBackend.
+class PosixFile final : public IoFile
+{
+public:
+
+	/// Writes from the beginning of the file, or after its first `size` bytes if `flags` does not truncate it.
+	PosixFile(IoDirectory const& directory, std::string const& name, int flags, uint64_t size)
+		: m_path{ name }, m_descriptor{ openInDirectory(directory, name, flags) }, m_buffer{}, m_used{ 0 }, m_offset{ size }
+	{
+		if (m_descriptor < 0) [[unlikely]]
+			throw FileFailureWhileOpening{ "Unable to open the file, unknow reasons: " + directory.pathOf(name) };
+
+		if (!(flags & O_TRUNC) && ::ftruncate(m_descriptor, static_cast<off_t>(size)) != 0) [[unlikely]]
+		{
+			::close(m_descriptor);
+			throw FileFailureWhileOpening{ "Unable to cut the file: " + directory.pathOf(name) };
+		}
+
+		m_buffer.reset(static_cast<char*>(::operator new(PosixBackend::bufferSize, std::align_val_t{ PosixBackend::bufferAlignment })));
+	}
+
+	~PosixFile() noexcept
+	{
+		if (m_descriptor >= 0)
+			::close(m_descriptor);
+	}
+
+	size_t write(std::string_view data) override
+	{
+		if (m_used == 0 && data.size() >= PosixBackend::bufferSize)
+		{	// Already big enough: copying it into the buffer would only cost time.
+			pwriteWhole(m_descriptor, data.data(), data.size(), m_offset, m_path);
+			m_offset += data.size();
+			return data.size();
+		}
+
+		size_t const copied{ std::min(data.size(), PosixBackend::bufferSize - m_used) };
+		std::memcpy(m_buffer.get() + m_used, data.data(), copied);
+		m_used += copied;
+
+		if (m_used == PosixBackend::bufferSize)
+			flush();
+
+		return copied; // The rest is written by the next call, see writeWhole().
+	}
+
+	void flush() override
+	{
+		if (m_used == 0)
+			return;
+
+		pwriteWhole(m_descriptor, m_buffer.get(), m_used, m_offset, m_path);
+		m_offset += m_used;
+		m_used = 0;
+	}
+
+	void sync() override
+	{
+		flush();
+		syncDescriptor(m_descriptor, m_path);
+	}
+
+	void close() override
+	{
+		flush();
+
+		int const descriptor{ std::exchange(m_descriptor, -1) };
+		if (::close(descriptor) != 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error writing into the file: " + m_path };
+	}
+
+private:
+
+	std::string m_path; // The name of the file, for the error messages.
+	int m_descriptor; // -1 once closed.
+	std::unique_ptr<char, AlignedDelete> m_buffer;
+	size_t m_used; // Bytes of the buffer not yet written.
+	uint64_t m_offset; // Where the buffer will be written.
+};
+
+/// A file of the PosixBackend, opened for reading.
+class PosixReadFile final : public IoReadFile
+{
+public:
+
+	PosixReadFile(IoDirectory const& directory, std::string const& name)
+		: m_path{ name }, m_descriptor{ openInDirectory(directory, name, O_RDONLY | O_CLOEXEC) }, m_size{ 0 }
+	{
+		if (m_descriptor < 0) [[unlikely]]
+			throw FileFailureWhileOpening{ "Unable to open the file, unknow reasons: " + directory.pathOf(name) };
+
+		struct stat status{};
+		if (::fstat(m_descriptor, &status) != 0) [[unlikely]]
+		{
+			::close(m_descriptor);
+			throw FileFailureWhileOpening{ "Unable to get the size of the file: " + directory.pathOf(name) };
+		}
+
+		m_size = static_cast<uint64_t>(status.st_size);
+	}
+
+	~PosixReadFile() noexcept
+	{
+		::close(m_descriptor);
+	}
+
+	uint64_t size() const noexcept override
+	{
+		return m_size;
+	}
+
+	size_t readAt(char* output, size_t count, uint64_t offset) override
+	{
+		size_t read{ 0 };
+
+		while (read < count)
+		{
+			ssize_t const result{ ::pread(m_descriptor, output + read, count - read, static_cast<off_t>(offset + read)) };
+			if (result < 0 && errno == EINTR)
+				continue;
+
+			if (result < 0) [[unlikely]]
+				throw FileFailureWhileInUse{ "Error reading the file: " + m_path };
+
+			if (result == 0)
+				break; // End of the file.
+
+			read += static_cast<size_t>(result);
+		}
+
+		return read;
+	}
+
+private:
+
+	std::string m_path; // The name of the file, for the error messages.
+	int m_descriptor;
+	uint64_t m_size;
+};
+} // namespace
+
+
+std::unique_ptr<IoFile> PosixBackend::create(IoDirectory const& directory, std::string const& name)
+{
+	return std::make_unique<PosixFile>(directory, name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0);
+}
+
+std::unique_ptr<IoFile> PosixBackend::append(IoDirectory const& directory, std::string const& name, uint64_t size)
+{
+	return std::make_unique<PosixFile>(directory, name, O_WRONLY | O_CLOEXEC, size);
+}
+
+std::unique_ptr<IoReadFile> PosixBackend::open(IoDirectory const& directory, std::string const& name)
+{
+	return std::make_unique<PosixReadFile>(directory, name);
+}
+
+void PosixBackend::rename(IoDirectory const& directory, std::string const& from, std::string const& to)
+{
+	int const result{ (directory.descriptor() >= 0)
+		? ::renameat(directory.descriptor(), from.c_str(), directory.descriptor(), to.c_str())
+		: ::rename(directory.pathOf(from).c_str(), directory.pathOf(to).c_str()) };
+
+	if (result != 0) [[unlikely]]
+		throw FileFailureWhileInUse{ "Unable to replace the file: " + directory.pathOf(to) };
+}
+
+void PosixBackend::remove(IoDirectory const& directory, std::string const& name) noexcept
+{
+	if (directory.descriptor() >= 0)
+		::unlinkat(directory.descriptor(), name.c_str(), 0);
+	else
+		::unlink(directory.pathOf(name).c_str());
+}
+
+int SafeSaves::openInDirectory(IoDirectory const& directory, std::string const& name, int flags) noexcept
+{
+	if (directory.descriptor() >= 0)
+		return ::openat(directory.descriptor(), name.c_str(), flags, 0644);
+
+	try
+	{
+		return ::open(directory.pathOf(name).c_str(), flags, 0644);
+	}
+	catch (std::exception const&)
+	{	// Only std::bad_alloc is expected.
+		errno = ENOMEM;
+		return -1;
+	}
+}
+
+void SafeSaves::pwriteWhole(int descriptor, char const* data, size_t size, uint64_t offset, std::string const& path)
+{
+	while (size > 0)
+	{
+		ssize_t const written{ ::pwrite(descriptor, data, size, static_cast<off_t>(offset)) };
+		if (written < 0 && errno == EINTR)
+			continue;
+
+		if (written <= 0) [[unlikely]]
+			throw FileFailureWhileInUse{ "Error writing into the file: " + path };
+
+		data += written;
+		size -= static_cast<size_t>(written);
+		offset += static_cast<uint64_t>(written);
+	}
+}
+
+void SafeSaves::syncDescriptor(int descriptor, std::string const& path)
+{
+#ifdef __APPLE__
+	int const result{ ::fcntl(descriptor, F_FULLFSYNC) }; // fsync() does not reach the disk on macOS.
+#else
+	int const result{ ::fsync(descriptor) };
+#endif
+
+	if (result != 0) [[unlikely]]
+		throw FileFailureWhileInUse{ "Unable to flush the file: " + path };
+}
+
+#endif //_WIN32
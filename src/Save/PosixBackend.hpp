@@ -0,0 +1,107 @@
+/*******************************************************************
+ * @file PosixBackend.hpp
+ * @brief Declares the backend reaching the file system through POSIX descriptors.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *
+ * @note Not available on Windows.
+ *********************************************************************/
+
+#ifndef POSIXBACKEND_HPP
+#define POSIXBACKEND_HPP
+
+#ifndef _WIN32
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "IoBackend.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Writes with pwrite() from a large aligned buffer, reads with pread().
+ *
+ * Unlike std::ofstream, whose buffer is a few kilobytes, the data is handed to the system by
+ * chunks of `bufferSize` bytes, each one a single system call. The buffer is aligned on pages,
+ * so the system copies it without splitting it.
+ *
+ * @note Thread-safe, as long as each file is used by a single thread.
+ *
+ * @see IoBackend, makeIoBackend().
+ */
+class PosixBackend final : public IoBackend
+{
+public:
+
+	PosixBackend() noexcept = default;
+	~PosixBackend() noexcept = default;
+
+
+	/// @see IoBackend::create().
+	[[nodiscard]] std::unique_ptr<IoFile> create(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::append().
+	[[nodiscard]] std::unique_ptr<IoFile> append(IoDirectory const& directory, std::string const& name, uint64_t size) override;
+
+	/// @see IoBackend::open().
+	[[nodiscard]] std::unique_ptr<IoReadFile> open(IoDirectory const& directory, std::string const& name) override;
+
+	/// @see IoBackend::rename().
+	void rename(IoDirectory const& directory, std::string const& from, std::string const& to) override;
+
+	/// @see IoBackend::remove().
+	void remove(IoDirectory const& directory, std::string const& name) noexcept override;
+
+
+	static constexpr size_t bufferSize{ 1024 * 1024 }; // Bytes written by a single system call.
+	static constexpr size_t bufferAlignment{ 4096 }; // The size of a page.
+};
+
+/**
+ * @brief Opens a file relatively to its directory, with openat().
+ * @complexity O(1).
+ *
+ * @param[in] directory: The directory of the file.
+ * @param[in] name: The name of the file, relative to the directory.
+ * @param[in] flags: The flags of open().
+ *
+ * @return The descriptor of the file, or -1 with errno set.
+ */
+[[nodiscard]] int openInDirectory(IoDirectory const& directory, std::string const& name, int flags) noexcept;
+
+/**
+ * @brief Writes the whole data at a given position of a file, as many times as needed in case of short writes.
+ * @complexity O(N) where N is the size of the data.
+ *
+ * @param[in] descriptor: The file, opened for writing.
+ * @param[in] data: The data to write.
+ * @param[in] size: The size of the data.
+ * @param[in] offset: The position of the first byte to write.
+ * @param[in] path: The path to the file, for the error message.
+ *
+ * @throw FileFailureWhileInUse if the system reports an error.
+ */
+void pwriteWhole(int descriptor, char const* data, size_t size, uint64_t offset, std::string const& path);
+
+/**
+ * @brief Waits until the content of a file is on the disk.
+ * @complexity O(N) where N is the size of the data not yet on the disk.
+ *
+ * @param[in] descriptor: The file, opened for writing.
+ * @param[in] path: The path to the file, for the error message.
+ *
+ * @throw FileFailureWhileInUse if the system reports an error.
+ */
+void syncDescriptor(int descriptor, std::string const& path);
+} // namespace SafeSaves
+
+#endif //_WIN32
+
+#endif //POSIXBACKEND_HPP
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include "RecordStream.hpp"
+#include "../Save.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+static_assert(std::ranges::input_range<RecordStream>);
+
+
+RecordStream::RecordStream(size_t bufferSize) noexcept
+	: m_file{}, m_store{ nullptr }, m_buffer{}, m_bufferSize{ std::max<size_t>(bufferSize, 1) }, m_begin{ 0 }, m_end{ 0 }, m_offset{ 0 }
+	, m_contentSize{ 0 }, m_longRecord{}, m_current{}, m_recordsRead{ 0 }, m_started{ false }, m_error{}
+{}
+
+RecordStream::Iterator RecordStream::begin() noexcept
+{
+	if (!m_started)
+	{
+		m_started = true;
+		return (next()) ? Iterator{ this } : Iterator{};
+	}
+
+	return (m_file != nullptr) ? Iterator{ this } : Iterator{};
+}
+
+bool RecordStream::next() noexcept
+{
+	m_started = true;
+	if (m_file == nullptr)
+		return false;
+
+	try
+	{
+		m_longRecord.clear();
+
+		while (true)
+		{
+			char* const unread{ m_buffer.get() + m_begin };
+			char* const lineEnd{ static_cast<char*>(std::memchr(unread, '\n', m_end - m_begin)) };
+
+			if (lineEnd != nullptr)
+			{
+				size_t const size{ static_cast<size_t>(lineEnd - unread) };
+				m_begin += size + 1;
+
+				if (m_longRecord.empty())
+				{	// The usual case: decrypted within the buffer, no copy.
+					yield(unread, size);
+					return true;
+				}
+
+				m_longRecord.append(unread, size);
+				yield(m_longRecord.data(), m_longRecord.size());
+				return true;
+			}
+
+			if (m_begin == 0 && m_end == m_bufferSize)
+			{	// Longer than the buffer: only this record is assembled apart.
+				m_longRecord.append(m_buffer.get(), m_end);
+				m_end = 0;
+			}
+
+			if (!refill())
+				break;
+		}
+
+		if (m_begin < m_end || !m_longRecord.empty())
+		{	// The last record, not followed by \n.
+			m_longRecord.append(m_buffer.get() + m_begin, m_end - m_begin);
+			m_begin = m_end;
+			yield(m_longRecord.data(), m_longRecord.size());
+			return true;
+		}
+	}
+	catch (std::exception const& error)
+	{	// FileFailureWhileInUse, or std::bad_alloc for a record longer than the memory.
+		std::ostringstream errorMessage{};
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: the records after the " << m_recordsRead << "th could not be read" << "\n\n";
+		m_error = errorMessage.str();
+	}
+
+	close();
+	return false;
+}
+
+void RecordStream::close() noexcept
+{
+	m_file.reset();
+	m_buffer.reset();
+	m_longRecord = std::string{};
+	m_current = std::string_view{};
+	m_begin = m_end = 0;
+}
+
+bool RecordStream::refill()
+{
+	if (m_offset >= m_contentSize)
+		return false;
+
+	if (m_begin > 0)
+	{	// The beginning of a record, not followed by \n yet: moved to the front.
+		std::memmove(m_buffer.get(), m_buffer.get() + m_begin, m_end - m_begin);
+		m_end -= m_begin;
+		m_begin = 0;
+	}
+
+	size_t const toRead{ static_cast<size_t>(std::min<uint64_t>(m_bufferSize - m_end, m_contentSize - m_offset)) };
+	size_t const read{ m_file->readAt(m_buffer.get() + m_end, toRead, m_offset) };
+
+	if (read != toRead) [[unlikely]]
+		throw FileFailureWhileInUse{ "The file is shorter than when it was opened" };
+
+	m_end += read;
+	m_offset += read;
+	return true;
+}
+
+void RecordStream::yield(char* record, size_t size) noexcept
+{
+	if (m_store != nullptr) // Each line is encrypted on its own: the key starts over at each line.
+		m_store->cipher(record, size);
+
+	m_current = std::string_view{ record, size };
+	++m_recordsRead;
+}
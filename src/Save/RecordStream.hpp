@@ -0,0 +1,205 @@
+/*******************************************************************
+ * @file RecordStream.hpp
+ * @brief Declares the records (lines) of a save file, pulled one at a time through a fixed buffer.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef RECORDSTREAM_HPP
+#define RECORDSTREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include "IoBackend.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+class SaveStore;
+
+/**
+ * @brief The records (lines) of a save file, opened with SaveStore::streaming(), read one at a time.
+ *
+ * Unlike SaveStore::reading() and SaveStore::readingMapped(), the file is never loaded as a
+ * whole: it is read by chunks into a buffer of fixed size, and each record is decrypted within
+ * the buffer when it is reached. The memory used does not depend on the size of the file, only on
+ * the size of the longest record. Stopping early (break, or simply destroying the stream) reads
+ * nothing more.
+ *
+ * @note Each record is a view, valid until the next one is read.
+ * @note An error while reading ends the iteration: check error() once it is over.
+ * @note A stream is an input range: it can be iterated only once.
+ *
+ * @see SaveStore::streaming(), MappedRecords.
+ *
+ * @code
+ * SafeSaves::RecordStream replay{};
+ * if (auto error{ SafeSaves::Save::streaming("replay.sav", replay) })
+ *     return error;
+ *
+ * for (std::string_view record : replay)
+ *     if (!apply(record))
+ *         break; // Nothing more is read.
+ *
+ * return replay.error();
+ * @endcode
+ */
+class RecordStream
+{
+public:
+
+	/**
+	 * @brief Pulls the records of its stream, one at a time.
+	 *
+	 * @note Compares equal to std::default_sentinel once the stream is over.
+	 */
+	class Iterator
+	{
+	public:
+
+		using iterator_category = std::input_iterator_tag;
+		using value_type = std::string_view;
+		using difference_type = std::ptrdiff_t;
+
+
+		Iterator() noexcept = default;
+		explicit Iterator(RecordStream* stream) noexcept : m_stream{ stream } {}
+
+		[[nodiscard]] inline std::string_view operator*() const noexcept { return m_stream->current(); }
+
+		inline Iterator& operator++() noexcept
+		{
+			if (!m_stream->next())
+				m_stream = nullptr;
+
+			return *this;
+		}
+
+		inline void operator++(int) noexcept { ++*this; }
+
+		[[nodiscard]] inline bool operator==(std::default_sentinel_t) const noexcept { return m_stream == nullptr; }
+
+	private:
+
+		RecordStream* m_stream{ nullptr }; // nullptr once the stream is over.
+	};
+
+
+	/**
+	 * @brief Creates a stream with no file opened.
+	 * @complexity O(1).
+	 *
+	 * @param[in] bufferSize: The number of bytes read at once. A record longer than the buffer is
+	 *			  still read, in a separate string.
+	 */
+	explicit RecordStream(size_t bufferSize = defaultBufferSize) noexcept;
+
+	RecordStream(RecordStream const&) = delete;
+	RecordStream(RecordStream&&) noexcept = default;
+	RecordStream& operator=(RecordStream const&) = delete;
+	RecordStream& operator=(RecordStream&&) noexcept = default;
+	~RecordStream() noexcept = default;
+
+
+	/**
+	 * @brief Reads the first record, if it has not been read yet.
+	 * @complexity O(S) where S is the size of the buffer.
+	 *
+	 * @return An iterator toward the current record.
+	 */
+	[[nodiscard]] Iterator begin() noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The end of the stream.
+	 */
+	[[nodiscard]] inline std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+	/**
+	 * @brief Reads the next record.
+	 * @complexity O(R), O(S) when the buffer is refilled, where R is the size of the record and S
+	 *			   the size of the buffer.
+	 *
+	 * @return True if a record has been read, false once the stream is over or an error occured.
+	 *
+	 * @see current(), error().
+	 */
+	[[nodiscard]] bool next() noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The record read by the last call to next(), valid until the next call.
+	 */
+	[[nodiscard]] inline std::string_view current() const noexcept { return m_current; }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of records read so far.
+	 */
+	[[nodiscard]] inline uint64_t recordsRead() const noexcept { return m_recordsRead; }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The error that ended the iteration, if any.
+	 */
+	[[nodiscard]] inline std::optional<std::string> const& error() const noexcept { return m_error; }
+
+	/**
+	 * @brief Closes the file and frees the buffer. Nothing more is read.
+	 * @complexity O(1).
+	 */
+	void close() noexcept;
+
+
+	static constexpr size_t defaultBufferSize{ 64 * 1024 };
+
+private:
+
+	/**
+	 * @brief Reads the next chunk of the file at the end of the buffer, after moving the unread
+	 *		  bytes to its beginning.
+	 *
+	 * @return False if the whole content has already been read.
+	 *
+	 * @throw FileFailureWhileInUse if the system reports an error.
+	 */
+	bool refill();
+
+	/**
+	 * @brief Decrypts a record, if needed, then makes it the current one.
+	 */
+	void yield(char* record, size_t size) noexcept;
+
+
+	std::unique_ptr<IoReadFile> m_file; // nullptr if not opened or once over.
+	SaveStore const* m_store; // Decrypts the records, nullptr if they are not encrypted.
+	std::unique_ptr<char[]> m_buffer;
+	size_t m_bufferSize;
+	size_t m_begin; // First byte of the buffer not yet read.
+	size_t m_end; // End of the bytes of the buffer.
+	uint64_t m_offset; // Next byte of the file to read into the buffer.
+	uint64_t m_contentSize; // Size of the file, without the tokens of confirmation.
+	std::string m_longRecord; // A record longer than the buffer, assembled chunk by chunk.
+	std::string_view m_current;
+	uint64_t m_recordsRead;
+	bool m_started; // True once the first record has been read.
+	std::optional<std::string> m_error;
+
+friend class SaveStore;
+};
+} // namespace SafeSaves
+
+#endif //RECORDSTREAM_HPP
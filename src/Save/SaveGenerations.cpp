@@ -0,0 +1,247 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "SaveGenerations.hpp"
+#include "ValidatedFileCache.hpp"
+#include "../Save.hpp"
+#include "../Exceptions.hpp"
+
+#if defined(__APPLE__)
+#include <sys/clonefile.h>
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+using namespace SafeSaves;
+
+std::string const SaveGenerations::generationsFolder{ "generations/" };
+
+
+namespace
+{
+/// Clones a file: both share their blocks until one is modified. Returns false if unsupported.
+bool cloneFile([[maybe_unused]] std::string const& source, [[maybe_unused]] std::string const& destination) noexcept
+{
+#if defined(__APPLE__)
+	return ::clonefile(source.c_str(), destination.c_str(), 0) == 0;
+#elif defined(__linux__) && defined(FICLONE)
+	int const input{ ::open(source.c_str(), O_RDONLY | O_CLOEXEC) };
+	if (input < 0)
+		return false;
+
+	int const output{ ::open(destination.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644) };
+	if (output < 0)
+	{
+		::close(input);
+		return false;
+	}
+
+	bool const cloned{ ::ioctl(output, FICLONE, input) == 0 }; // Btrfs, XFS, bcachefs...
+	::close(input);
+	::close(output);
+
+	if (!cloned)
+		::unlink(destination.c_str());
+
+	return cloned;
+#else
+	return false; // Windows only clones blocks on ReFS, through a much heavier API.
+#endif
+}
+} // namespace
+
+
+std::vector<SaveGeneration> SaveGenerations::list(std::string const& fileName, SaveStore& store) noexcept
+{
+	std::unique_lock lock{ store.m_generationsMutex };
+
+	try
+	{
+		return listLocked(store, fileName);
+	}
+	catch (std::exception const&)
+	{	// The folder cannot be read: as if there was no generation.
+		return std::vector<SaveGeneration>{};
+	}
+}
+
+std::optional<std::string> SaveGenerations::restore(std::string const& fileName, uint64_t number, SaveStore& store) noexcept
+{
+	std::unique_lock lock{ store.m_generationsMutex };
+	std::string const path{ store.m_root.pathOf(fileName) };
+	std::string const generation{ generationName(fileName, number) };
+	std::ostringstream errorMessage{};
+	std::error_code ignored{};
+
+	try
+	{
+		std::optional<FileIdentity> const identity{ store.m_validatedFiles.identify(store.m_root, generation) };
+		if (!identity.has_value() || !store.checkingContentValdity(generation, identity->size)) [[unlikely]]
+			throw FileFailureWhileOpening{ "The generation does not exist or is corrupted: " + store.m_root.pathOf(generation) };
+
+		bool hasCurrentFile{ true };
+		try
+		{
+			store.cleanUpFiles(fileName);
+		}
+		catch (FileFailureWhileOpening const&)
+		{	// Nothing valid to keep: the generation is restored anyway.
+			hasCurrentFile = false;
+		}
+
+		// The generation is duplicated before keeping the current file, which may prune it.
+		std::filesystem::remove(path + ".tmp", ignored);
+		duplicate(store, store.m_root.pathOf(generation), path + ".tmp");
+
+		if (hasCurrentFile)
+			keepLocked(store, fileName, std::max<size_t>(getCapacity(store), 1));
+
+		store.m_validatedFiles.forget(fileName);
+		store.m_backend->rename(store.m_root, fileName + ".tmp", fileName);
+		store.m_validatedFiles.count(ValidatedFileCache::Operation::Rename);
+	}
+	catch (FileFailureWhileOpening const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Fatal error: impossible to restore the generation" << "\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	if (!errorMessage.str().empty()) [[unlikely]]
+	{
+		std::filesystem::remove(path + ".tmp", ignored);
+		return std::make_optional<std::string>(errorMessage.str());
+	}
+
+	return std::nullopt;
+}
+
+std::optional<std::string> SaveGenerations::prune(std::string const& fileName, size_t generationsToKeep, SaveStore& store) noexcept
+{
+	std::unique_lock lock{ store.m_generationsMutex };
+	std::ostringstream errorMessage{};
+
+	try
+	{
+		pruneLocked(store, fileName, generationsToKeep);
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: some generations may have been kept" << "\n\n";
+	}
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+void SaveGenerations::keep(SaveStore& store, std::string const& fileName) noexcept
+{
+	size_t const generationsToKeep{ getCapacity(store) };
+	if (generationsToKeep == 0)
+		return;
+
+	std::unique_lock lock{ store.m_generationsMutex };
+
+	try
+	{
+		keepLocked(store, fileName, generationsToKeep);
+	}
+	catch (std::exception const&)
+	{	// Only the rollback is lost, not the save.
+	}
+}
+
+void SaveGenerations::keepLocked(SaveStore& store, std::string const& fileName, size_t generationsToKeep)
+{
+	std::string const path{ store.m_root.pathOf(fileName) };
+	if (!std::filesystem::exists(path))
+		return;
+
+	std::vector<SaveGeneration> const generations{ listLocked(store, fileName) };
+	std::string const newest{ store.m_root.pathOf(generationName(fileName, (generations.empty()) ? 1 : generations.front().number + 1)) };
+
+	std::filesystem::create_directories(std::filesystem::path{ newest }.parent_path());
+	duplicate(store, path, newest);
+
+	// The new generation is not in the list: one less of the listed ones is kept.
+	std::error_code ignored{};
+	for (size_t i{ generationsToKeep - 1 }; i < generations.size(); ++i)
+	{
+		std::filesystem::remove(store.m_root.pathOf(generationName(fileName, generations[i].number)), ignored);
+		store.m_validatedFiles.count(ValidatedFileCache::Operation::Remove);
+	}
+}
+
+std::vector<SaveGeneration> SaveGenerations::listLocked(SaveStore& store, std::string const& fileName)
+{
+	std::filesystem::path const folder{ std::filesystem::path{ store.m_root.pathOf(generationName(fileName, 0)) }.parent_path() };
+	std::string const prefix{ std::filesystem::path{ fileName }.filename().string() + '.' };
+	std::vector<SaveGeneration> generations{};
+
+	std::error_code noFolder{};
+	for (std::filesystem::directory_iterator entry{ folder, noFolder }, end{}; !noFolder && entry != end; entry.increment(noFolder))
+	{
+		std::string const name{ entry->path().filename().string() };
+		if (name.size() <= prefix.size() || !name.starts_with(prefix)
+		||  !std::all_of(name.begin() + prefix.size(), name.end(), [](char c) { return c >= '0' && c <= '9'; }))
+			continue;
+
+		generations.push_back(SaveGeneration{ std::stoull(name.substr(prefix.size())), entry->file_size(), entry->last_write_time() });
+	}
+
+	std::sort(generations.begin(), generations.end(), [](SaveGeneration const& a, SaveGeneration const& b) { return a.number > b.number; });
+	return generations;
+}
+
+void SaveGenerations::pruneLocked(SaveStore& store, std::string const& fileName, size_t generationsToKeep)
+{
+	std::vector<SaveGeneration> const generations{ listLocked(store, fileName) };
+
+	for (size_t i{ generationsToKeep }; i < generations.size(); ++i)
+	{
+		std::filesystem::remove(store.m_root.pathOf(generationName(fileName, generations[i].number)));
+		store.m_validatedFiles.count(ValidatedFileCache::Operation::Remove);
+	}
+}
+
+void SaveGenerations::duplicate(SaveStore& store, std::string const& source, std::string const& destination)
+{
+	std::error_code noHardLink{};
+	std::filesystem::create_hard_link(source, destination, noHardLink);
+	if (!noHardLink)
+	{	// Save never modifies a file in place: sharing it is safe.
+		store.m_validatedFiles.count(ValidatedFileCache::Operation::Link);
+		return;
+	}
+
+	if (cloneFile(source, destination))
+		store.m_validatedFiles.count(ValidatedFileCache::Operation::Link);
+	else
+	{
+		std::filesystem::copy_file(source, destination);
+		store.m_validatedFiles.count(ValidatedFileCache::Operation::Copy);
+	}
+
+	// Listed by the time they were saved, not duplicated.
+	std::error_code ignored{};
+	std::filesystem::last_write_time(destination, std::filesystem::last_write_time(source), ignored);
+}
+
+std::string SaveGenerations::generationName(std::string const& fileName, uint64_t number)
+{
+	return generationsFolder + fileName + '.' + std::to_string(number);
+}
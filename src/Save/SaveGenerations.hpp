@@ -0,0 +1,194 @@
+/*******************************************************************
+ * @file SaveGenerations.hpp
+ * @brief Declares the previous versions kept of each save file, to roll back a bad save.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef SAVEGENERATIONS_HPP
+#define SAVEGENERATIONS_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "../Save.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief A previous version of a save file.
+ *
+ * @see SaveGenerations::list().
+ */
+struct SaveGeneration
+{
+	uint64_t number; // The higher, the newer.
+	uint64_t size; // In bytes, tokens of confirmation included.
+	std::filesystem::file_time_type time; // When this version was saved.
+};
+
+/**
+ * @brief Keeps the last versions of each save file, in a ring of a configurable size.
+ *
+ * Save never modifies a file in place: it writes the new content in a tmp file, then renames it
+ * over the previous one. Right before the rename, the previous file is kept as a generation in
+ * the `generations/` folder of its store, as `fileName.number`:
+ * - as a hard link when possible: nothing is copied, the generation is the previous file itself;
+ * - else as a copy-on-write clone (reflink) when the file system supports it;
+ * - else as a full copy.
+ * Once a file has more generations than the capacity, the oldest are removed.
+ *
+ * @note This struct is non-instantiable and only contains static methods.
+ * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ * @note Each store has its own capacity, 0 by default: no generation is kept.
+ *
+ * @see Save, SaveGeneration.
+ *
+ * @code
+ * SafeSaves::SaveGenerations::setCapacity(5); // At startup.
+ *
+ * auto generations{ SafeSaves::SaveGenerations::list("progress.sav") };
+ * if (!generations.empty()) // Rolls back the last save.
+ *     auto error{ SafeSaves::SaveGenerations::restore("progress.sav", generations.front().number) };
+ * @endcode
+ */
+struct SaveGenerations
+{
+public:
+
+	SaveGenerations() noexcept = delete;
+	SaveGenerations(SaveGenerations const&) noexcept = delete;
+	SaveGenerations(SaveGenerations&&) noexcept = delete;
+	SaveGenerations& operator=(SaveGenerations const&) noexcept = delete;
+	SaveGenerations& operator=(SaveGenerations&&) noexcept = delete;
+	~SaveGenerations() noexcept = delete;
+
+
+	/**
+	 * @brief Sets the number of generations kept per file of a store.
+	 * @complexity O(1).
+	 *
+	 * @param[in] generationCount: The number of generations, 0 to keep none.
+	 * @param[in] store: The store whose files are concerned. The other stores keep their own capacity.
+	 *
+	 * @note The files that have more generations are pruned at their next save.
+	 */
+	static inline void setCapacity(size_t generationCount, SaveStore& store = Save::store()) noexcept { store.m_generationCapacity.store(generationCount, std::memory_order_relaxed); }
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @param[in] store: The store whose files are concerned.
+	 *
+	 * @return The number of generations kept per file of the store.
+	 */
+	[[nodiscard]] static inline size_t getCapacity(SaveStore const& store = Save::store()) noexcept { return store.m_generationCapacity.load(std::memory_order_relaxed); }
+
+	/**
+	 * @complexity O(N) where N is the number of files in the generations folder.
+	 *
+	 * @param[in] fileName: The name of the save file.
+	 * @param[in] store: The store of the save file.
+	 *
+	 * @return Its generations, the newest first. Empty if it has none.
+	 */
+	[[nodiscard]] static std::vector<SaveGeneration> list(std::string const& fileName, SaveStore& store = Save::store()) noexcept;
+
+	/**
+	 * @brief Replaces a save file by one of its generations.
+	 * @details The current file is first kept as a new generation, so a restore can be undone.
+	 * @complexity O(N) where N is the number of files in the generations folder.
+	 *
+	 * @param[in] fileName: The name of the save file.
+	 * @param[in] number: The number of the generation, as given by list().
+	 * @param[in] store: The store of the save file.
+	 *
+	 * @return an optional string that contains an error message. If so, the file is unchanged.
+	 */
+	[[nodiscard]] static std::optional<std::string> restore(std::string const& fileName, uint64_t number, SaveStore& store = Save::store()) noexcept;
+
+	/**
+	 * @brief Removes the oldest generations of a save file.
+	 * @complexity O(N) where N is the number of files in the generations folder.
+	 *
+	 * @param[in] fileName: The name of the save file.
+	 * @param[in] generationsToKeep: The number of generations to keep, the newest ones.
+	 * @param[in] store: The store of the save file.
+	 *
+	 * @return an optional string that contains an error message.
+	 */
+	[[nodiscard]] static std::optional<std::string> prune(std::string const& fileName, size_t generationsToKeep, SaveStore& store = Save::store()) noexcept;
+
+private:
+
+	/**
+	 * @brief Keeps the current version of a save file as its newest generation, then prunes.
+	 * @details Called by SaveStore right before replacing the file.
+	 * @complexity O(N) where N is the number of files in the generations folder.
+	 *
+	 * @param[in] store: The store of the save file.
+	 * @param[in] fileName: The name of the save file.
+	 *
+	 * @note Does nothing if the capacity is 0 or if the file does not exist. A generation that
+	 *		 cannot be kept is skipped: a save is never refused because of it.
+	 */
+	static void keep(SaveStore& store, std::string const& fileName) noexcept;
+
+	/**
+	 * @brief Same as keep(), the mutex of the store already locked.
+	 * @throw std::filesystem::filesystem_error, std::bad_alloc.
+	 */
+	static void keepLocked(SaveStore& store, std::string const& fileName, size_t generationsToKeep);
+
+	/**
+	 * @brief Same as list(), the mutex of the store already locked.
+	 * @throw std::filesystem::filesystem_error, std::bad_alloc.
+	 */
+	[[nodiscard]] static std::vector<SaveGeneration> listLocked(SaveStore& store, std::string const& fileName);
+
+	/**
+	 * @brief Same as prune(), the mutex of the store already locked.
+	 * @throw std::filesystem::filesystem_error, std::bad_alloc.
+	 */
+	static void pruneLocked(SaveStore& store, std::string const& fileName, size_t generationsToKeep);
+
+	/**
+	 * @brief Creates a file with the same content as another, as cheaply as possible.
+	 * @details A hard link, else a copy-on-write clone, else a full copy.
+	 * @complexity O(1), O(N) for a full copy where N is the size of the file.
+	 *
+	 * @param[in] store: The store of both files, to count the operation.
+	 * @param[in] source: The path to the existing file.
+	 * @param[in] destination: The path to the new file, which must not exist.
+	 *
+	 * @throw std::filesystem::filesystem_error if even the copy fails.
+	 *
+	 * @warning The two files may share their content: none of them may be modified in place.
+	 */
+	static void duplicate(SaveStore& store, std::string const& source, std::string const& destination);
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The name of a generation of a save file, relative to the root of its store.
+	 */
+	[[nodiscard]] static std::string generationName(std::string const& fileName, uint64_t number);
+
+
+	static std::string const generationsFolder; // Within the root of each store.
+
+friend class SaveStore;
+friend class SaveTransaction;
+};
+} // namespace SafeSaves
+
+#endif //SAVEGENERATIONS_HPP
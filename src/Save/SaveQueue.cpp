@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "SaveQueue.hpp"
+#include "../Save.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+
+void SaveQueue::LatencyHistogram::record(std::chrono::microseconds latency) noexcept
+{
+	uint64_t const micro{ static_cast<uint64_t>(std::max<std::chrono::microseconds::rep>(latency.count(), 0)) };
+
+	// Index of the highest bit set: 1 -> 0, [2, 3] -> 1, [4, 7] -> 2...
+	size_t bucket{ (micro == 0) ? 0 : static_cast<size_t>(std::bit_width(micro) - 1) };
+	if (bucket >= bucketCount)
+		bucket = bucketCount - 1;
+
+	++buckets[bucket];
+	++count;
+	totalMicroseconds += micro;
+	maxMicroseconds = std::max(maxMicroseconds, micro);
+}
+
+uint64_t SaveQueue::LatencyHistogram::percentileMicroseconds(double percentile) const noexcept
+{
+	if (count == 0)
+		return 0;
+
+	uint64_t const target{ static_cast<uint64_t>(percentile * static_cast<double>(count)) };
+	uint64_t accumulated{ 0 };
+
+	for (size_t i{ 0 }; i < bucketCount; ++i)
+	{
+		accumulated += buckets[i];
+		if (accumulated > target || accumulated == count)
+			return std::min((uint64_t{ 1 } << (i + 1)) - 1, maxMicroseconds); // Upper bound of the bucket.
+	}
+
+	return maxMicroseconds;
+}
+
+
+SaveQueue::SaveQueue(SaveStore& store)
+	: m_store{ store }, m_mutex{}, m_wakeWriter{}, m_idle{}, m_pending{}, m_order{}, m_lastSequence{ 0 }, m_unwritten{}, m_stopping{ false }, m_histogram{}, m_writer{}
+{
+	m_writer = std::thread{ &SaveQueue::writerLoop, this };
+}
+
+SaveQueue::~SaveQueue() noexcept
+{
+	shutdown();
+}
+
+std::future<void> SaveQueue::enqueue(std::string fileName, std::vector<std::string> valuesToSave, bool encrypt)
+{
+	return push(std::move(fileName), Snapshot{ std::in_place_index<0>, std::move(valuesToSave) }, encrypt);
+}
+
+std::future<void> SaveQueue::enqueueBlob(std::string fileName, std::string blobToSave, bool encrypt)
+{
+	return push(std::move(fileName), Snapshot{ std::in_place_index<1>, std::move(blobToSave) }, encrypt);
+}
+
+void SaveQueue::flush() noexcept
+{
+	std::unique_lock lock{ m_mutex };
+
+	// Only up to the last save enqueued so far: the producers may keep enqueuing meanwhile.
+	uint64_t const lastSequence{ m_lastSequence };
+	m_idle.wait(lock, [this, lastSequence]() { return m_unwritten.empty() || *m_unwritten.begin() > lastSequence; });
+}
+
+void SaveQueue::shutdown() noexcept
+{
+	{
+		std::lock_guard lock{ m_mutex };
+		m_stopping = true;
+	}
+	m_wakeWriter.notify_one();
+
+	if (m_writer.joinable())
+		m_writer.join(); // The writer empties the queue before leaving its loop.
+}
+
+SaveQueue::LatencyHistogram SaveQueue::getLatencyHistogram() const noexcept
+{
+	std::lock_guard lock{ m_mutex };
+	return m_histogram;
+}
+
+size_t SaveQueue::pendingFiles() const noexcept
+{
+	std::lock_guard lock{ m_mutex };
+	return m_order.size();
+}
+
+std::future<void> SaveQueue::push(std::string fileName, Snapshot snapshot, bool encrypt)
+{
+	std::promise<void> promise{};
+	std::future<void> future{ promise.get_future() };
+
+	{
+		std::lock_guard lock{ m_mutex };
+
+		if (m_stopping) [[unlikely]]
+		{
+			promise.set_exception(std::make_exception_ptr(FileFailureWhileOpening{ "The save queue was shut down, the file was not saved: " + fileName }));
+			return future;
+		}
+
+		auto mapIterator{ m_pending.find(fileName) };
+		if (mapIterator == m_pending.end())
+		{
+			m_order.push_back(fileName);
+			mapIterator = m_pending.emplace(std::move(fileName), PendingSave{}).first;
+		}
+
+		// Coalescing: an older snapshot that was not written yet is simply replaced.
+		PendingSave& pending{ mapIterator->second };
+		pending.snapshot = std::move(snapshot);
+		pending.encrypt = encrypt;
+		pending.waiting.emplace_back(std::move(promise), Clock::now());
+
+		pending.sequences.push_back(++m_lastSequence);
+		m_unwritten.insert(m_lastSequence);
+	}
+
+	m_wakeWriter.notify_one();
+	return future;
+}
+
+void SaveQueue::writerLoop() noexcept
+{
+	std::unique_lock lock{ m_mutex };
+
+	while (true)
+	{
+		m_wakeWriter.wait(lock, [this]() { return !m_order.empty() || m_stopping; });
+
+		if (m_order.empty()) // Only possible when stopping: every pending save was written.
+			break;
+
+		std::string fileName{ std::move(m_order.front()) };
+		m_order.pop_front();
+
+		auto mapIterator{ m_pending.find(fileName) };
+		PendingSave pending{ std::move(mapIterator->second) };
+		m_pending.erase(mapIterator);
+
+		// The disk is accessed outside of the lock so producers are never blocked by it.
+		lock.unlock();
+
+		std::optional<std::string> error{};
+		if (auto* lines = std::get_if<0>(&pending.snapshot))
+			error = m_store.writing(fileName, *lines, pending.encrypt, true);
+		else
+			error = m_store.writingBlob(fileName, std::get<1>(pending.snapshot), pending.encrypt, false, true);
+
+		Clock::time_point const written{ Clock::now() };
+		for (auto& [promise, enqueued] : pending.waiting)
+		{
+			if (error.has_value()) [[unlikely]]
+				promise.set_exception(std::make_exception_ptr(FileFailureWhileInUse{ error.value() }));
+			else
+				promise.set_value();
+		}
+
+		lock.lock();
+		for (auto const& [promise, enqueued] : pending.waiting)
+			m_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(written - enqueued));
+
+		for (uint64_t const sequence : pending.sequences)
+			m_unwritten.erase(sequence);
+
+		m_idle.notify_all();
+	}
+
+	m_idle.notify_all();
+}
@@ -0,0 +1,223 @@
+/*******************************************************************
+ * @file SaveQueue.hpp
+ * @brief Declares an asynchronous service that writes saves from a background thread.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef SAVEQUEUE_HPP
+#define SAVEQUEUE_HPP
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include "../Save.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Writes saves asynchronously so the caller (e.g. the game loop) never waits for the disk.
+ *
+ * Callers enqueue a snapshot of the data and immediately get a std::future. A dedicated writer
+ * thread performs the durable write through Save (tmp file + tokens of confirmation, synchronized
+ * to the disk before it replaces the previous file). If several
+ * snapshots of the same file are enqueued before the writer reaches it, only the latest one is
+ * written and every future of that file is fulfilled by this single write.
+ *
+ * Errors are reported through the future: get() rethrows a FileFailureWhileInUse containing the
+ * message Save would have returned.
+ *
+ * @note The destructor flushes every pending save before returning.
+ * @warning Do not read or write a file with Save while it is pending in the queue.
+ *
+ * @see Save, FileFailure
+ *
+ * @code
+ * SafeSaves::SaveQueue queue{};
+ * std::future<void> done{ queue.enqueue("profile.txt", { "name", "42" }) };
+ * // ... keep rendering frames ...
+ * done.get(); // Throws FileFailureWhileInUse if the save failed.
+ * @endcode
+ */
+class SaveQueue
+{
+public:
+
+	/**
+	 * @brief Distribution of the time between an enqueue and the end of its write.
+	 * @details Bucket i counts the saves whose latency is within [2^i, 2^(i+1)) microseconds;
+	 *			the first bucket also counts latencies below one microsecond and the last one
+	 *			every latency above its lower bound.
+	 */
+	struct LatencyHistogram
+	{
+		static constexpr size_t bucketCount{ 32 };
+
+		std::array<uint64_t, bucketCount> buckets{};
+		uint64_t count{ 0 };
+		uint64_t totalMicroseconds{ 0 };
+		uint64_t maxMicroseconds{ 0 };
+
+		/**
+		 * @brief Adds a latency to the distribution.
+		 * @complexity O(1).
+		 *
+		 * @param[in] latency: The latency to add.
+		 */
+		void record(std::chrono::microseconds latency) noexcept;
+
+		/**
+		 * @brief Approximates a percentile using the upper bound of the buckets.
+		 * @complexity O(1).
+		 *
+		 * @param[in] percentile: Between 0 and 1.
+		 *
+		 * @return The latency in microseconds below which `percentile` of the saves were written.
+		 */
+		[[nodiscard]] uint64_t percentileMicroseconds(double percentile) const noexcept;
+	};
+
+
+	/**
+	 * @brief Starts the writer thread.
+	 * @complexity O(1).
+	 *
+	 * @param[in] store: The store in which the files are written. It must outlive the queue.
+	 */
+	explicit SaveQueue(SaveStore& store = Save::store());
+
+	/**
+	 * @brief Writes every pending save, then stops the writer thread.
+	 * @complexity O(N) where N is the number of pending saves.
+	 */
+	~SaveQueue() noexcept;
+
+	SaveQueue(SaveQueue const&) = delete;
+	SaveQueue(SaveQueue&&) = delete;
+	SaveQueue& operator=(SaveQueue const&) = delete;
+	SaveQueue& operator=(SaveQueue&&) = delete;
+
+
+	/**
+	 * @brief Enqueues lines to be written, as Save::writing would.
+	 * @complexity Amortized O(1): the snapshot is moved, not copied.
+	 *
+	 * @param[in] fileName: The name of the file.
+	 * @param[in] valuesToSave: The snapshot to save.
+	 * @param[in] encrypt: True if the values need to be encrypted.
+	 *
+	 * @return A future ready once the snapshot (or a later one for the same file) is written.
+	 *
+	 * @note If the queue was shut down, the future holds a FileFailureWhileOpening.
+	 *
+	 * @see Save::writing(), enqueueBlob().
+	 */
+	[[nodiscard]] std::future<void> enqueue(std::string fileName, std::vector<std::string> valuesToSave, bool encrypt = true);
+
+	/**
+	 * @brief Enqueues a binary blob to be written, as Save::writingBlob would.
+	 * @complexity Amortized O(1): the snapshot is moved, not copied.
+	 *
+	 * @param[in] fileName: The name of the file.
+	 * @param[in] blobToSave: The snapshot to save.
+	 * @param[in] encrypt: True if the blob needs to be encrypted.
+	 *
+	 * @return A future ready once the snapshot (or a later one for the same file) is written.
+	 *
+	 * @note If the queue was shut down, the future holds a FileFailureWhileOpening.
+	 *
+	 * @see Save::writingBlob(), enqueue().
+	 */
+	[[nodiscard]] std::future<void> enqueueBlob(std::string fileName, std::string blobToSave, bool encrypt = true);
+
+	/**
+	 * @brief Blocks until every save enqueued before the call is written.
+	 * @complexity O(N) where N is the number of pending saves.
+	 *
+	 * @note The saves enqueued meanwhile by other threads are not waited for.
+	 */
+	void flush() noexcept;
+
+	/**
+	 * @brief Writes every pending save then stops the writer thread. Safe to call several times.
+	 * @complexity O(N) where N is the number of pending saves.
+	 *
+	 * @note Saves enqueued afterwards fail immediately.
+	 */
+	void shutdown() noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return A copy of the latency distribution of the saves written so far.
+	 */
+	[[nodiscard]] LatencyHistogram getLatencyHistogram() const noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of files waiting to be written.
+	 */
+	[[nodiscard]] size_t pendingFiles() const noexcept;
+
+private:
+
+	using Clock = std::chrono::steady_clock;
+	using Snapshot = std::variant<std::vector<std::string>, std::string>;
+
+	/// The latest snapshot of a file, and everyone waiting for it.
+	struct PendingSave
+	{
+		Snapshot snapshot;
+		bool encrypt;
+		std::vector<std::pair<std::promise<void>, Clock::time_point>> waiting;
+		std::vector<uint64_t> sequences; // The sequence number of each enqueue, in the order of `waiting`.
+	};
+
+	/**
+	 * @brief Adds or coalesces a snapshot in the pending saves.
+	 *
+	 * @see enqueue(), enqueueBlob().
+	 */
+	[[nodiscard]] std::future<void> push(std::string fileName, Snapshot snapshot, bool encrypt);
+
+	/**
+	 * @brief Body of the writer thread: pops files in FIFO order and writes their latest snapshot.
+	 */
+	void writerLoop() noexcept;
+
+
+	SaveStore& m_store;
+	mutable std::mutex m_mutex; // Protects every member below.
+	std::condition_variable m_wakeWriter; // Notified when a file is pending or when stopping.
+	std::condition_variable m_idle; // Notified each time the writer has written a file.
+
+	std::unordered_map<std::string, PendingSave> m_pending; // Latest snapshot for each file.
+	std::deque<std::string> m_order; // Files in the order of their first enqueue.
+
+	uint64_t m_lastSequence; // The sequence number of the last enqueue.
+	std::set<uint64_t> m_unwritten; // The sequence numbers of the saves enqueued and not written yet.
+	bool m_stopping; // True once shutdown() was called.
+	LatencyHistogram m_histogram;
+
+	std::thread m_writer; // Declared last: started once every member is initialized.
+};
+} // namespace SafeSaves
+
+#endif //SAVEQUEUE_HPP
@@ -0,0 +1,227 @@
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SaveTransaction.hpp"
+#include "BinaryUtils.hpp"
+#include "FileSync.hpp"
+#include "IoBackend.hpp"
+#include "SaveGenerations.hpp"
+#include "../Save.hpp"
+#include "../Exceptions.hpp"
+
+using namespace SafeSaves;
+
+std::mutex SaveTransaction::s_commitMutex{};
+
+
+namespace
+{
+/// Reads a whole file through the backend, returns std::nullopt if it cannot be opened.
+std::optional<std::string> readWholeFile(IoBackend& backend, IoDirectory const& directory, std::string const& name)
+{
+	std::unique_ptr<IoReadFile> file{};
+	try
+	{
+		file = backend.open(directory, name);
+	}
+	catch (FileFailureWhileOpening const&)
+	{
+		return std::nullopt;
+	}
+
+	std::string content(static_cast<size_t>(file->size()), '\0');
+	content.resize(file->readAt(content.data(), content.size(), 0));
+	return content;
+}
+} // namespace
+
+
+void SaveTransaction::stage(std::string const& fileName, std::vector<std::string> const& valuesToSave, bool encrypt)
+{
+	std::string content{};
+	for (auto const& toSave : valuesToSave)
+	{
+		content.append((encrypt) ? SaveStore::encryptDecrypt(toSave, m_store->m_key) : toSave);
+		content.push_back('\n');
+	}
+
+	content.append(SaveStore::tokensOfConfirmation);
+	stageContent(fileName, std::move(content));
+}
+
+void SaveTransaction::stageBlob(std::string const& fileName, std::string_view blobToSave, bool encrypt, bool compress)
+{
+	std::string content{};
+	content.reserve(blobToSave.size() + SaveStore::tokensOfConfirmation.size());
+
+	m_store->encodingBlob(blobToSave, encrypt, compress, [&content](std::string const& chunk) { content.append(chunk); });
+
+	content.append(SaveStore::tokensOfConfirmation);
+	stageContent(fileName, std::move(content));
+}
+
+std::optional<std::string> SaveTransaction::commit() noexcept
+{
+	if (m_files.empty())
+		return std::nullopt;
+
+	std::unique_lock lock{ s_commitMutex };
+	std::ostringstream errorMessage{};
+	IoBackend& backend{ *m_store->m_backend };
+	IoDirectory const& root{ m_store->m_root };
+	std::string const manifestFile{ manifestName };
+	bool committed{ false };
+
+	try
+	{
+		std::ostringstream manifest{};
+		manifest << manifestHeader << '\n' << m_files.size() << '\n';
+
+		for (auto const& file : m_files)
+			manifest << file.fileName << '\t' << file.content.size() << '\t' << crc32(file.content) << '\n';
+
+		manifest << SaveStore::tokensOfConfirmation;
+		std::string const manifestContent{ manifest.str() };
+
+		// 1. and 2. Every file, next to its destination, and the manifest, submitted as a single batch:
+		// each write is followed by its flush, on the descriptor already open (per path with StreamBackend).
+		std::vector<IoWrite> writes{};
+		for (auto const& file : m_files)
+			writes.push_back(IoWrite{ file.fileName + ".txn", file.content, true });
+		writes.push_back(IoWrite{ manifestFile + ".tmp", manifestContent, true });
+
+		backend.submit(root, writes)->wait();
+
+		// 3. The commit point: from now on, recover() finishes the transaction.
+		backend.rename(root, manifestFile + ".tmp", manifestFile);
+		FileSync::syncDirectory(root.path());
+		committed = true;
+
+		// 4. The destinations, then the manifest once the renames are on the disk.
+		for (auto const& file : m_files)
+		{
+			SaveGenerations::keep(*m_store, file.fileName);
+			m_store->m_validatedFiles.forget(file.fileName);
+			backend.rename(root, file.fileName + ".txn", file.fileName);
+		}
+
+		FileSync::syncDirectory(root.path());
+		backend.remove(root, manifestFile);
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the transaction will be " << ((committed) ? "finished" : "discarded") << " by recover()\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: the transaction will be " << ((committed) ? "finished" : "discarded") << " by recover()\n\n";
+	}
+
+	if (!errorMessage.str().empty()) [[unlikely]]
+		return std::make_optional<std::string>(errorMessage.str());
+
+	m_files.clear();
+	return std::nullopt;
+}
+
+std::optional<std::string> SaveTransaction::recover(SaveStore& store) noexcept
+{
+	std::unique_lock lock{ s_commitMutex };
+	std::ostringstream errorMessage{};
+	IoBackend& backend{ *store.m_backend };
+	std::string const manifestFile{ manifestName };
+
+	try
+	{
+		backend.remove(store.m_root, manifestFile + ".tmp"); // Never reached its commit point.
+
+		std::optional<std::string> const manifest{ readWholeFile(backend, store.m_root, manifestFile) };
+		if (manifest.has_value() && manifest->ends_with(SaveStore::tokensOfConfirmation))
+		{	// Committed: finished.
+			if (!applyManifest(store, manifest.value())) [[unlikely]]
+				throw FileFailureWhileInUse{ "A file of the transaction is corrupted, the others have been saved" };
+
+			FileSync::syncDirectory(store.m_root.path());
+		}
+
+		backend.remove(store.m_root, manifestFile);
+
+		// Not committed: the previous files are still there, only the staged ones are discarded.
+		for (auto const& entry : std::filesystem::directory_iterator{ store.m_root.path() })
+			if (entry.path().extension() == ".txn")
+				backend.remove(store.m_root, entry.path().filename().string());
+	}
+	catch (FileFailureWhileInUse const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Critical error: the saves of the last transaction may be inconsistent\n\n";
+	}
+	catch (std::exception const& error)
+	{
+		errorMessage << error.what() << '\n';
+		errorMessage << "Error: gravity and effects unknown" << "\n\n";
+	}
+
+	return (errorMessage.str().empty()) ? std::nullopt : std::make_optional<std::string>(errorMessage.str());
+}
+
+void SaveTransaction::stageContent(std::string const& fileName, std::string&& content)
+{
+	for (auto& file : m_files)
+	{
+		if (file.fileName == fileName)
+		{
+			file.content = std::move(content);
+			return;
+		}
+	}
+
+	m_files.push_back(StagedFile{ fileName, std::move(content) });
+}
+
+bool SaveTransaction::applyManifest(SaveStore& store, std::string const& manifest)
+{
+	std::istringstream lines{ manifest.substr(0, manifest.size() - SaveStore::tokensOfConfirmation.size()) };
+	std::string line{};
+	size_t count{ 0 };
+
+	if (!std::getline(lines, line) || line != manifestHeader || !(lines >> count) || !lines.ignore()) [[unlikely]]
+		return false;
+
+	bool everyFileApplied{ true };
+
+	for (size_t i{ 0 }; i < count && std::getline(lines, line); ++i)
+	{
+		size_t const firstTab{ line.find('\t') };
+		size_t const secondTab{ line.find('\t', firstTab + 1) };
+		if (firstTab == std::string::npos || secondTab == std::string::npos) [[unlikely]]
+			return false;
+
+		std::string const fileName{ line.substr(0, firstTab) };
+		size_t const size{ std::stoull(line.substr(firstTab + 1, secondTab - firstTab - 1)) };
+		uint32_t const checksum{ static_cast<uint32_t>(std::stoul(line.substr(secondTab + 1))) };
+
+		std::optional<std::string> const content{ readWholeFile(*store.m_backend, store.m_root, fileName + ".txn") };
+		if (!content.has_value())
+			continue; // Already renamed before the crash.
+
+		if (content->size() != size || crc32(content.value()) != checksum) [[unlikely]]
+		{
+			everyFileApplied = false;
+			continue;
+		}
+
+		SaveGenerations::keep(store, fileName);
+		store.m_validatedFiles.forget(fileName);
+		store.m_backend->rename(store.m_root, fileName + ".txn", fileName);
+	}
+
+	return everyFileApplied;
+}
@@ -0,0 +1,168 @@
+/*******************************************************************
+ * @file SaveTransaction.hpp
+ * @brief Declares transactions to save several files at once: all of them or none of them.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef SAVETRANSACTION_HPP
+#define SAVETRANSACTION_HPP
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../Save.hpp"
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+/**
+ * @brief Saves several files so that a crash leaves either all the old ones or all the new ones.
+ *
+ * Writes are staged in memory, then commit():
+ * 1. writes each file next to its destination, as `fileName.txn`, and a manifest listing them;
+ * 2. waits for the disk to have all of them: they are submitted as a single batch, each write
+ *    followed by its flush (IoBackend::submit());
+ * 3. renames the manifest to `transaction.manifest`: this is the commit point;
+ * 4. renames each `.txn` file over its destination, then removes the manifest.
+ *
+ * On startup, recover() finishes a transaction whose manifest exists, and discards the `.txn`
+ * files of one that did not reach its commit point.
+ *
+ * The files are written in the same formats as Save::writing() and Save::writingBlob(), so they
+ * are read back with Save::reading() and Save::readingBlob().
+ *
+ * @note If any optional string is instantiated, the function called didn't satisfy its postconditions.
+ * @note Functions that stage a write may throw std::bad_alloc.
+ * @note Only one transaction is committed at a time.
+ *
+ * @note A transaction writes in a single store: the one given to its constructor.
+ *
+ * @see Save, SaveStore, FileSync.
+ *
+ * @code
+ * // At startup, before reading any save.
+ * if (auto error{ SafeSaves::SaveTransaction::recover() })
+ *     showErrorsUsingWindow("Saves", std::ostringstream{ error.value() });
+ *
+ * SafeSaves::SaveTransaction transaction{};
+ * transaction.stage("profile.txt", profile);
+ * transaction.stage("settings.txt", settings);
+ * transaction.stageBlob("progress.sav", progress);
+ * auto error{ transaction.commit() };
+ * @endcode
+ */
+class SaveTransaction
+{
+public:
+
+	/**
+	 * @brief Starts an empty transaction.
+	 * @complexity O(1).
+	 *
+	 * @param[in] store: The store in which the files are written. It must outlive the transaction.
+	 */
+	explicit SaveTransaction(SaveStore& store = Save::store()) noexcept : m_store{ &store }, m_files{} {}
+
+	SaveTransaction(SaveTransaction const&) = delete;
+	SaveTransaction(SaveTransaction&&) noexcept = default;
+	SaveTransaction& operator=(SaveTransaction const&) = delete;
+	SaveTransaction& operator=(SaveTransaction&&) noexcept = default;
+	~SaveTransaction() noexcept = default;
+
+
+	/**
+	 * @brief Stages lines to write into a file, as Save::writing() would.
+	 * @complexity O(N) where N is the size of the values.
+	 *
+	 * @param[in] fileName: The name of the file, created if it does not exist.
+	 * @param[in] valuesToSave: The lines to save.
+	 * @param[in] encrypt: True if the values need to be encrypted.
+	 *
+	 * @note A file staged twice is written once, with the last content.
+	 */
+	void stage(std::string const& fileName, std::vector<std::string> const& valuesToSave, bool encrypt = true);
+
+	/**
+	 * @brief Stages a blob to write into a file, as Save::writingBlob() would.
+	 * @complexity O(N) where N is the size of the blob.
+	 *
+	 * @param[in] fileName: The name of the file, created if it does not exist.
+	 * @param[in] blobToSave: The data to save.
+	 * @param[in] encrypt: True if the content needs to be encrypted.
+	 * @param[in] compress: True if the content needs to be compressed.
+	 *
+	 * @note A file staged twice is written once, with the last content.
+	 */
+	void stageBlob(std::string const& fileName, std::string_view blobToSave, bool encrypt = true, bool compress = false);
+
+	/**
+	 * @brief Writes every staged file, all or nothing.
+	 * @complexity O(N) where N is the total size of the files.
+	 *
+	 * @return an optional string that contains an error message. If so, the files staged stay
+	 *		   staged; the transaction may still be finished by recover() if it failed after its
+	 *		   commit point.
+	 */
+	[[nodiscard]] std::optional<std::string> commit() noexcept;
+
+	/**
+	 * @brief Finishes or discards a transaction interrupted by a crash.
+	 * @complexity O(N) where N is the total size of the files of the transaction.
+	 *
+	 * @param[in] store: The store in which the transaction was committed.
+	 *
+	 * @return an optional string that contains an error message.
+	 *
+	 * @note To call at startup, before reading any file.
+	 */
+	[[nodiscard]] static std::optional<std::string> recover(SaveStore& store = Save::store()) noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of files staged.
+	 */
+	[[nodiscard]] inline size_t size() const noexcept { return m_files.size(); }
+
+private:
+
+	/// A file, as it will be written.
+	struct StagedFile
+	{
+		std::string fileName;
+		std::string content; // Tokens of confirmation included.
+	};
+
+	/**
+	 * @brief Stages a content, replacing the previous one of the same file.
+	 */
+	void stageContent(std::string const& fileName, std::string&& content);
+
+	/**
+	 * @brief Renames the `.txn` files listed in a valid manifest over their destinations.
+	 * @details The lock must be held.
+	 *
+	 * @return False if a `.txn` file does not match the manifest.
+	 */
+	[[nodiscard]] static bool applyManifest(SaveStore& store, std::string const& manifest);
+
+
+	SaveStore* m_store; // Never nullptr.
+	std::vector<StagedFile> m_files;
+
+
+	static std::mutex s_commitMutex; // Only one transaction is committed or recovered at a time.
+
+	static constexpr std::string_view manifestName{ "transaction.manifest" };
+	static constexpr std::string_view manifestHeader{ "SafeSaves transaction 1" };
+};
+} // namespace SafeSaves
+
+#endif //SAVETRANSACTION_HPP
@@ -0,0 +1,107 @@
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "ValidatedFileCache.hpp"
+#include "IoBackend.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+using namespace SafeSaves;
+
+
+std::optional<FileIdentity> ValidatedFileCache::identify(IoDirectory const& directory, std::string const& name) noexcept
+{
+	count(Operation::Stat);
+
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes{};
+	if (!GetFileAttributesExA(directory.pathOf(name).c_str(), GetFileExInfoStandard, &attributes))
+		return std::nullopt;
+
+	uint64_t const size{ static_cast<uint64_t>(attributes.nFileSizeHigh) << 32 | attributes.nFileSizeLow };
+	uint64_t const time{ static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32 | attributes.ftLastWriteTime.dwLowDateTime };
+
+	return FileIdentity{ 0, 0, size, static_cast<int64_t>(time) * 100 };
+#else
+	struct stat status{};
+	int const result{ (directory.descriptor() >= 0)
+		? ::fstatat(directory.descriptor(), name.c_str(), &status, 0)
+		: ::stat(directory.pathOf(name).c_str(), &status) };
+
+	if (result != 0)
+		return std::nullopt;
+
+#ifdef __APPLE__
+	int64_t const time{ static_cast<int64_t>(status.st_mtimespec.tv_sec) * 1'000'000'000 + status.st_mtimespec.tv_nsec };
+#else
+	int64_t const time{ static_cast<int64_t>(status.st_mtim.tv_sec) * 1'000'000'000 + status.st_mtim.tv_nsec };
+#endif
+
+	return FileIdentity{ static_cast<uint64_t>(status.st_dev), static_cast<uint64_t>(status.st_ino), static_cast<uint64_t>(status.st_size), time };
+#endif
+}
+
+bool ValidatedFileCache::isValidated(std::string const& path, FileIdentity const& identity) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+
+	auto const mapIterator{ m_files.find(path) };
+	if (mapIterator == m_files.end() || mapIterator->second != identity)
+		return false;
+
+	count(Operation::Hit);
+	return true;
+}
+
+void ValidatedFileCache::markValidated(std::string const& path, FileIdentity const& identity) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+
+	try
+	{
+		m_files.insert_or_assign(path, identity);
+	}
+	catch (std::exception const&)
+	{	// Only std::bad_alloc is expected: the file will be validated again, nothing more.
+	}
+}
+
+void ValidatedFileCache::forget(std::string const& path) noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	m_files.erase(path);
+}
+
+void ValidatedFileCache::clear() noexcept
+{
+	std::unique_lock lock{ m_mutex };
+	m_files.clear();
+}
+
+void ValidatedFileCache::count(Operation operation) noexcept
+{
+	m_counters[static_cast<size_t>(operation)].fetch_add(1, std::memory_order_relaxed);
+}
+
+FileOperationCounters ValidatedFileCache::counters() const noexcept
+{
+	auto const load = [this](Operation operation) { return m_counters[static_cast<size_t>(operation)].load(std::memory_order_relaxed); };
+
+	return FileOperationCounters{ load(Operation::Stat), load(Operation::Open), load(Operation::Read), load(Operation::Copy),
+								  load(Operation::Rename), load(Operation::Remove), load(Operation::Hit), load(Operation::Link) };
+}
+
+void ValidatedFileCache::resetCounters() noexcept
+{
+	for (auto& counter : m_counters)
+		counter.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,170 @@
+/*******************************************************************
+ * @file ValidatedFileCache.hpp
+ * @brief Declares a cache of the files whose tokens of confirmation have already been checked.
+ *
+ * \author OmegaDIL.
+ * \date   October 2026.
+ *********************************************************************/
+
+#ifndef VALIDATEDFILECACHE_HPP
+#define VALIDATEDFILECACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+
+/**
+ * \brief Classes, functions and exceptions to safely handle files.
+ */
+namespace SafeSaves
+{
+class IoDirectory;
+
+/**
+ * @brief What identifies the content of a file without reading it: if any of these changes, the
+ *		  file may have changed.
+ */
+struct FileIdentity
+{
+	uint64_t device;
+	uint64_t inode; // 0 on Windows: the size and the time are enough to detect a rewrite.
+	uint64_t size;
+	int64_t modificationTime; // In nanoseconds.
+
+	bool operator==(FileIdentity const&) const noexcept = default;
+};
+
+/**
+ * @brief The number of file operations done to validate, recover and prepare the files.
+ *
+ * @see ValidatedFileCache::counters().
+ */
+struct FileOperationCounters
+{
+	uint64_t stats; // Metadata queries.
+	uint64_t opens; // Files opened to check their tokens.
+	uint64_t reads; // Tokens read.
+	uint64_t copies; // Full copies of a file, to keep a generation.
+	uint64_t renames; // Tmp files renamed over their file, once written or to recover it.
+	uint64_t removes; // Removals of a tmp file or of a generation.
+	uint64_t hits; // Validations skipped thanks to the cache.
+	uint64_t links; // Generations kept without copying the content: hard links and clones.
+};
+
+/**
+ * @brief Remembers which files have valid tokens of confirmation, as long as they do not change.
+ *
+ * Checking the tokens costs opening the file, seeking and reading. A file that has been checked
+ * is stored with its identity (device, inode, size and modification time, given by a single
+ * stat): while its identity stays the same, the check is skipped.
+ *
+ * The files written by Save are forgotten before being written, so the cache never relies on the
+ * precision of the modification time for them.
+ *
+ * @note Every function is thread-safe.
+ *
+ * @see SaveStore::cleanUpFiles(), FileIdentity.
+ */
+class ValidatedFileCache
+{
+public:
+
+	/// The operations counted.
+	enum class Operation
+	{
+		Stat,
+		Open,
+		Read,
+		Copy,
+		Rename,
+		Remove,
+		Hit,
+		Link
+	};
+
+
+	ValidatedFileCache() noexcept = default;
+	ValidatedFileCache(ValidatedFileCache const&) = delete;
+	ValidatedFileCache(ValidatedFileCache&&) = delete;
+	ValidatedFileCache& operator=(ValidatedFileCache const&) = delete;
+	ValidatedFileCache& operator=(ValidatedFileCache&&) = delete;
+	~ValidatedFileCache() noexcept = default;
+
+
+	/**
+	 * @brief Gets the identity of a file with a single system call (fstatat, relatively to its directory).
+	 * @complexity O(1).
+	 *
+	 * @param[in] directory: The directory of the file.
+	 * @param[in] name: The name of the file, relative to the directory.
+	 *
+	 * @return The identity, or std::nullopt if the file does not exist.
+	 */
+	[[nodiscard]] std::optional<FileIdentity> identify(IoDirectory const& directory, std::string const& name) noexcept;
+
+	/**
+	 * @complexity O(1) on average.
+	 *
+	 * @param[in] path: The name of the file.
+	 * @param[in] identity: Its current identity.
+	 *
+	 * @return True if the file has been validated and has not changed since.
+	 */
+	[[nodiscard]] bool isValidated(std::string const& path, FileIdentity const& identity) noexcept;
+
+	/**
+	 * @brief Remembers that a file is valid.
+	 * @complexity O(1) on average.
+	 *
+	 * @param[in] path: The name of the file.
+	 * @param[in] identity: Its identity when it was validated.
+	 */
+	void markValidated(std::string const& path, FileIdentity const& identity) noexcept;
+
+	/**
+	 * @brief Forgets a file, so it is validated again next time.
+	 * @complexity O(1) on average.
+	 *
+	 * @param[in] path: The name of the file.
+	 */
+	void forget(std::string const& path) noexcept;
+
+	/**
+	 * @brief Forgets every file.
+	 * @complexity O(N) where N is the number of files.
+	 */
+	void clear() noexcept;
+
+	/**
+	 * @brief Counts an operation.
+	 * @complexity O(1).
+	 */
+	void count(Operation operation) noexcept;
+
+	/**
+	 * @complexity O(1).
+	 *
+	 * @return The number of operations done since the last call to resetCounters().
+	 */
+	[[nodiscard]] FileOperationCounters counters() const noexcept;
+
+	/**
+	 * @brief Sets every counter to 0.
+	 * @complexity O(1).
+	 */
+	void resetCounters() noexcept;
+
+private:
+
+	std::mutex m_mutex; // Protects m_files.
+	std::unordered_map<std::string, FileIdentity> m_files; // Name -> identity when validated.
+
+	std::atomic<uint64_t> m_counters[8]{}; // Indexed by Operation.
+};
+} // namespace SafeSaves
+
+#endif //VALIDATEDFILECACHE_HPP
@@ -11,6 +11,22 @@ int main()
 {
 	sf::Vector2u windowSize{ 1000, 1000 };
 	sf::RenderWindow window{ sf::VideoMode{ windowSize }, "Template sfml 3" };
+
+	// Every asset is loaded now, decoded in parallel, rather than one by one when first used.
+	// The folders of the resolution tiers are skipped: declare them with SpriteWrapper::setResolutionTiers before.
+	gui::AssetManifest manifest{ gui::AssetManifest::scan() };
+	manifest.fonts.push_back({ "__default", "defaultFont.ttf" }); // Along with the fonts scanned.
+	std::ostringstream errorMessage{};
+	const auto report{ gui::AssetPreloader::preload(errorMessage, manifest) };
+	if (report.failed != 0)
+		showErrorsUsingWindow("Assets", errorMessage);
+
+	// The glyphs shown by the last runs are rasterized now, rather than when each screen first shows.
+	const bool glyphsCached{ gui::GlyphCache::load() };
+	if (!glyphsCached)
+		gui::GlyphCache::startRecording();
+	gui::GlyphCache::prewarm();
+
 	AGUI mainInterface{ &window, 1080 };
 	AGUI otherInterface{ &window, 1080 };
 	BGUI* curInterface{ &mainInterface };
@@ -44,6 +60,8 @@ int main()
 	IGUI::Item curItem{};
 	while (window.isOpen())
 	{
+		GUI_PROFILE_FRAME();
+
 		while (const std::optional event = window.pollEvent())
 		{ 
 			if (event->is<sf::Event::MouseMoved>() && !sf::Mouse::isButtonPressed(sf::Mouse::Button::Left))
@@ -82,9 +100,22 @@ int main()
 
 		window.clear();
 		curInterface->draw();
+#ifdef GUI_PROFILING
+		gui::Profiler::drawOverlay(window);
+#endif
 		window.display();
 	}
 
+#ifdef GUI_PROFILING
+	gui::Profiler::exportChromeTrace("frames.json"); // Open it in chrome://tracing or Perfetto.
+#endif
+
+	if (!glyphsCached)
+	{
+		gui::GlyphCache::stopRecording();
+		static_cast<void>(gui::GlyphCache::save());
+	}
+
 	return 0;
 }
 